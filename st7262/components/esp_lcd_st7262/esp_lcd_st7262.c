@@ -1,14 +1,170 @@
 #include <stdio.h>
+#include <string.h>
 #include <esp_log.h>
 #include <driver/gpio.h>
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_dev.h>
+#include <freertos/task.h>
+#include <esp_cache.h>
+#include <esp_heap_caps.h>
 #include "esp_lcd_st7262.h"
+#include "esp_lcd_st7262_pixel.h"
 
 #define TAG "ESP_LCD_ST7262"
 
 const esp_lcd_panel_st7262_conf_t *_panel = NULL;
 
+static void esp_lcd_panel_st7262_bandwidth_params(const esp_lcd_panel_st7262_conf_t *conf, esp_lcd_panel_st7262_bandwidth_params_t *params)
+{
+    *params = (esp_lcd_panel_st7262_bandwidth_params_t){
+        .h_res = conf->width,
+        .v_res = conf->height,
+        .h_blank = conf->timing.hsync.pulse_width + conf->timing.hsync.back_porch + conf->timing.hsync.front_porch,
+        .v_blank = conf->timing.vsync.pulse_width + conf->timing.vsync.back_porch + conf->timing.vsync.front_porch,
+        .pclk_hz = conf->timing.pclk_hz,
+        .bytes_per_px = sizeof(uint16_t),
+        .bounce_buffer_lines = conf->scanout.bounce_buffer_lines,
+        .dma_burst_size = conf->scanout.dma_burst_size,
+    };
+}
+
+static void esp_lcd_panel_st7262_timing_profile(const esp_lcd_panel_st7262_conf_t *conf, esp_lcd_panel_st7262_timing_profile_t *profile)
+{
+    *profile = (esp_lcd_panel_st7262_timing_profile_t){
+        .name = NULL,
+        .pclk_hz = conf->timing.pclk_hz,
+        .hsync_pulse_width = conf->timing.hsync.pulse_width,
+        .hsync_back_porch = conf->timing.hsync.back_porch,
+        .hsync_front_porch = conf->timing.hsync.front_porch,
+        .vsync_pulse_width = conf->timing.vsync.pulse_width,
+        .vsync_back_porch = conf->timing.vsync.back_porch,
+        .vsync_front_porch = conf->timing.vsync.front_porch,
+    };
+}
+
+static bool esp_lcd_panel_st7262_on_vsync(esp_lcd_panel_handle_t handle, const esp_lcd_rgb_panel_event_data_t *edata, void *user_ctx)
+{
+    esp_lcd_panel_st7262_panel_handle_t panel = (esp_lcd_panel_st7262_panel_handle_t)user_ctx;
+    BaseType_t task_woken = pdFALSE;
+    int64_t now = esp_timer_get_time();
+
+#if ESP_LCD_PANEL_ST7262_STATS
+    if (panel->last_vsync_us != 0)
+    {
+        uint32_t interval = (uint32_t)(now - panel->last_vsync_us);
+        ESP_LCD_PANEL_ST7262_STATS_RECORD(&panel->stats.vsync_interval_us, interval);
+
+        // On-demand panels are idle between frames on purpose
+        if (panel->refresh_timer == NULL && panel->frame_period_us > 0 && interval * 2 > panel->frame_period_us * 3)
+        {
+            ESP_LCD_PANEL_ST7262_STATS_ADD(&panel->stats.missed_vsyncs, (interval + panel->frame_period_us / 2) / panel->frame_period_us - 1);
+        }
+    }
+    panel->last_vsync_us = now;
+#endif
+
+    portENTER_CRITICAL_ISR(&panel->lock);
+    // An on-demand panel only shows a queued buffer once the refresh timer started a frame with it
+    bool flipped = false;
+    if (panel->refresh_timer == NULL || panel->flip_started)
+    {
+        flipped = esp_lcd_panel_st7262_flip_state_vsync(&panel->flip);
+        panel->flip_started = false;
+    }
+    esp_lcd_panel_st7262_refresh_done(&panel->refresh);
+    esp_lcd_panel_st7262_vsync_cb_t cb = panel->vsync_cb;
+    void *cb_ctx = panel->vsync_cb_ctx;
+    portEXIT_CRITICAL_ISR(&panel->lock);
+
+    if (flipped)
+    {
+        xSemaphoreGiveFromISR(panel->flip_done, &task_woken);
+    }
+
+    bool cb_woken = false;
+    if (cb != NULL)
+    {
+        cb_woken = cb(now, cb_ctx);
+    }
+
+    return task_woken == pdTRUE || cb_woken;
+}
+
+static void esp_lcd_panel_st7262_refresh_timer(void *arg)
+{
+    esp_lcd_panel_st7262_panel_handle_t panel = (esp_lcd_panel_st7262_panel_handle_t)arg;
+
+    portENTER_CRITICAL(&panel->lock);
+    bool refresh = esp_lcd_panel_st7262_refresh_tick(&panel->refresh);
+    int flip_to = refresh && panel->flip.pending ? panel->flip.queued : -1;
+    panel->flip_started = flip_to >= 0;
+    portEXIT_CRITICAL(&panel->lock);
+
+    if (!refresh)
+    {
+        return;
+    }
+
+    if (flip_to >= 0)
+    {
+        // The RGB driver only switches buffers in draw_bitmap, which also starts the frame.
+        // The buffer was written back when it was presented, one pixel is enough here.
+        esp_lcd_panel_draw_bitmap(panel->handle, 0, 0, 1, 1, panel->fbs[flip_to]);
+    }
+    else
+    {
+        esp_lcd_rgb_panel_refresh(panel->handle);
+    }
+}
+
+static void esp_lcd_panel_st7262_mark_dirty(const esp_lcd_panel_st7262_panel_handle_t panel)
+{
+    if (panel->refresh_timer != NULL)
+    {
+        portENTER_CRITICAL(&panel->lock);
+        esp_lcd_panel_st7262_refresh_mark_dirty(&panel->refresh);
+        portEXIT_CRITICAL(&panel->lock);
+    }
+}
+
+esp_err_t esp_lcd_panel_st7262_bandwidth(const esp_lcd_panel_st7262_config_handle_t conf, esp_lcd_panel_st7262_bandwidth_t *out)
+{
+    if (conf == NULL || out == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments for ST7262 bandwidth estimate. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_panel_st7262_bandwidth_params_t params;
+    esp_lcd_panel_st7262_bandwidth_params(conf, &params);
+    if (!esp_lcd_panel_st7262_bandwidth_estimate(&params, out))
+    {
+        ESP_LOGE(TAG, "Invalid ST7262 configuration for bandwidth estimate.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_set_timing_profile(const esp_lcd_panel_st7262_config_handle_t conf, const esp_lcd_panel_st7262_timing_profile_t *profile)
+{
+    if (conf == NULL || profile == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments for ST7262 timing profile. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    conf->timing.pclk_hz = profile->pclk_hz;
+    conf->timing.hsync.pulse_width = profile->hsync_pulse_width;
+    conf->timing.hsync.back_porch = profile->hsync_back_porch;
+    conf->timing.hsync.front_porch = profile->hsync_front_porch;
+    conf->timing.vsync.pulse_width = profile->vsync_pulse_width;
+    conf->timing.vsync.back_porch = profile->vsync_back_porch;
+    conf->timing.vsync.front_porch = profile->vsync_front_porch;
+
+    return ESP_OK;
+}
+
 esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t conf, esp_lcd_panel_st7262_panel_handle_t out_handle)
 {
     ESP_LOGI(TAG, "Initializing ST7262 LCD panel...");
@@ -23,6 +179,57 @@ esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t co
         return ESP_ERR_INVALID_ARG;
     }
 
+    uint32_t bounce_lines = conf->scanout.bounce_buffer_lines;
+    if (bounce_lines > 0 && conf->height % (2 * bounce_lines) != 0)
+    {
+        ESP_LOGE(TAG, "Invalid bounce buffer size for ST7262 LCD panel. Height %lu must be an even multiple of %lu lines.",
+                 conf->height, bounce_lines);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (conf->scanout.refresh_on_demand && bounce_lines > 0)
+    {
+        ESP_LOGE(TAG, "Invalid scanout for ST7262 LCD panel. On-demand refresh cannot be used with bounce buffers.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // The RGB driver switches to a frame buffer at the next frame and holds one switch at a
+    // time, a third buffer could be rendered but not queued while a swap is pending
+    if (conf->scanout.num_fbs > 2)
+    {
+        ESP_LOGE(TAG, "Invalid number of frame buffers for ST7262 LCD panel: %lu, at most 2 are supported.", conf->scanout.num_fbs);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Reject timings the scanout mode cannot stream from PSRAM before allocating anything
+    const esp_lcd_panel_st7262_timing_mode_t mode = {
+        .h_res = conf->width,
+        .v_res = conf->height,
+        .bytes_per_px = sizeof(uint16_t),
+        .bounce_buffer_lines = bounce_lines,
+        .dma_burst_size = conf->scanout.dma_burst_size,
+    };
+    esp_lcd_panel_st7262_timing_profile_t profile;
+    esp_lcd_panel_st7262_timing_profile(conf, &profile);
+
+    esp_lcd_panel_st7262_timing_result_t timing = {0};
+    esp_lcd_panel_st7262_timing_status_t status = esp_lcd_panel_st7262_timing_validate(&mode, &profile, &timing);
+    if (status == ESP_LCD_PANEL_ST7262_TIMING_INVALID)
+    {
+        ESP_LOGE(TAG, "Invalid timing for ST7262 LCD panel.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ESP_LOGI(TAG, "Scanout: %lu bounce lines, PCLK %lu Hz (max %lu Hz, %lu%% headroom), %lu.%02lu fps, line %lu ns, PSRAM %lu/%lu B/s",
+             bounce_lines, profile.pclk_hz, timing.bandwidth.max_pclk_hz, timing.headroom_pct,
+             timing.fps_x100 / 100, timing.fps_x100 % 100, timing.line_time_ns,
+             timing.bandwidth.required_bytes_per_s, timing.bandwidth.available_bytes_per_s);
+    if (status == ESP_LCD_PANEL_ST7262_TIMING_UNSUSTAINABLE)
+    {
+        ESP_LOGE(TAG, "PCLK %lu Hz exceeds the estimated PSRAM bandwidth of %lu Hz for this scanout mode.", profile.pclk_hz, timing.bandwidth.max_pclk_hz);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
     _panel = conf;
 
     esp_lcd_panel_handle_t display_handle = NULL;
@@ -31,12 +238,12 @@ esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t co
             .data_width = 16,
             .bits_per_pixel = 16,
             .clk_src = LCD_CLK_SRC_DEFAULT,
-            //.bounce_buffer_size_px = 0, //conf->height,
-            //.sram_trans_align = 8,
-            //.psram_trans_align = 64,
-            //.dma_burst_size = 64,
+            .bounce_buffer_size_px = bounce_lines * conf->width,
+            .sram_trans_align = conf->scanout.sram_trans_align,
+            .psram_trans_align = conf->scanout.psram_trans_align,
+            .dma_burst_size = conf->scanout.dma_burst_size,
             .disp_gpio_num = GPIO_NUM_NC,
-            .num_fbs = 0,
+            .num_fbs = conf->scanout.num_fbs,
             .pclk_gpio_num = conf->gpio.pclk,
             .de_gpio_num = conf->gpio.de,
             .hsync_gpio_num = conf->gpio.hsync,
@@ -79,7 +286,7 @@ esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t co
             .flags = {
                 .disp_active_low = true,
                 .fb_in_psram = true,
-                .refresh_on_demand = false,
+                .refresh_on_demand = conf->scanout.refresh_on_demand,
                 .no_fb = false,
                 .double_fb = false,
             },
@@ -113,6 +320,80 @@ esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t co
     }
 
     out_handle->handle = display_handle; // return handle
+    out_handle->conf = conf;
+    out_handle->rotation = ESP_LCD_PANEL_ST7262_ROTATION_0;
+    out_handle->rotate_buf = NULL;
+    out_handle->rotate_buf_px = 0;
+    out_handle->async = NULL;
+    out_handle->async_task = NULL;
+    out_handle->refresh_timer = NULL;
+    out_handle->frame_period_us = timing.frame_time_us;
+    out_handle->flip_started = false;
+    out_handle->vsync_cb = NULL;
+    out_handle->vsync_cb_ctx = NULL;
+    esp_lcd_panel_st7262_stats_take(&out_handle->stats, NULL);
+    out_handle->last_vsync_us = 0;
+    portMUX_INITIALIZE(&out_handle->lock);
+
+    uint8_t num_fbs = conf->scanout.num_fbs == 0 ? 1 : conf->scanout.num_fbs;
+    if (!esp_lcd_panel_st7262_flip_state_init(&out_handle->flip, num_fbs))
+    {
+        ESP_LOGE(TAG, "Invalid number of frame buffers for ST7262 LCD panel: %lu", conf->scanout.num_fbs);
+        esp_lcd_panel_del(display_handle);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    out_handle->fbs[0] = out_handle->fbs[1] = out_handle->fbs[2] = NULL;
+    error = esp_lcd_rgb_panel_get_frame_buffer(display_handle, num_fbs, &out_handle->fbs[0], &out_handle->fbs[1], &out_handle->fbs[2]);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to get ST7262 LCD panel frame buffers: %s", esp_err_to_name(error));
+        esp_lcd_panel_del(display_handle);
+        return error;
+    }
+
+    out_handle->flip_done = xSemaphoreCreateBinary();
+    if (out_handle->flip_done == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create ST7262 LCD panel flip semaphore.");
+        esp_lcd_panel_del(display_handle);
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_lcd_rgb_panel_event_callbacks_t callbacks = {
+        .on_vsync = esp_lcd_panel_st7262_on_vsync,
+    };
+    error = esp_lcd_rgb_panel_register_event_callbacks(display_handle, &callbacks, out_handle);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to register ST7262 LCD panel callbacks: %s", esp_err_to_name(error));
+        vSemaphoreDelete(out_handle->flip_done);
+        esp_lcd_panel_del(display_handle);
+        return error;
+    }
+
+    if (conf->scanout.refresh_on_demand)
+    {
+        uint32_t frame_bytes = conf->width * conf->height * sizeof(uint16_t);
+        uint32_t tick_us = esp_lcd_panel_st7262_refresh_period_us(out_handle->frame_period_us);
+        uint32_t keepalive_frames = tick_us > 0 ? conf->scanout.keepalive_ms * 1000 / tick_us : 0;
+        esp_lcd_panel_st7262_refresh_init(&out_handle->refresh, frame_bytes, conf->scanout.idle_frames, keepalive_frames);
+
+        const esp_timer_create_args_t timer_args = {
+            .callback = esp_lcd_panel_st7262_refresh_timer,
+            .arg = out_handle,
+            .name = "st7262_refresh",
+        };
+        error = out_handle->frame_period_us > 0 ? esp_timer_create(&timer_args, &out_handle->refresh_timer) : ESP_ERR_INVALID_ARG;
+        if (error != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to create ST7262 LCD panel refresh timer: %s", esp_err_to_name(error));
+            out_handle->refresh_timer = NULL;
+            vSemaphoreDelete(out_handle->flip_done);
+            esp_lcd_panel_del(display_handle);
+            return error;
+        }
+    }
 
     ESP_LOGI(TAG, "ST7262 LCD panel initialized successfully.");
     return ESP_OK;
@@ -126,6 +407,18 @@ esp_err_t esp_lcd_panel_st7262_del(esp_lcd_panel_st7262_panel_handle_t handle)
         return ESP_ERR_INVALID_ARG;
     }
 
+    if (handle->async_task != NULL)
+    {
+        esp_lcd_panel_st7262_async_stop(handle);
+    }
+
+    if (handle->refresh_timer != NULL)
+    {
+        esp_timer_stop(handle->refresh_timer);
+        esp_timer_delete(handle->refresh_timer);
+        handle->refresh_timer = NULL;
+    }
+
     esp_err_t error = esp_lcd_panel_del(handle->handle);
     if (error != ESP_OK)
     {
@@ -133,6 +426,15 @@ esp_err_t esp_lcd_panel_st7262_del(esp_lcd_panel_st7262_panel_handle_t handle)
         return error;
     }
 
+    if (handle->flip_done != NULL)
+    {
+        vSemaphoreDelete(handle->flip_done);
+        handle->flip_done = NULL;
+    }
+
+    heap_caps_free(handle->rotate_buf);
+    handle->rotate_buf = NULL;
+
     return ESP_OK;
 }
 
@@ -151,6 +453,18 @@ esp_err_t esp_lcd_panel_st7262_init(const esp_lcd_panel_st7262_panel_handle_t pa
         return error;
     }
 
+    // Frames are only sent on demand, the timer paces them a little slower than the frame
+    // rate so every tick comes after the vsync of the frame it started before
+    if (panel->refresh_timer != NULL)
+    {
+        error = esp_timer_start_periodic(panel->refresh_timer, esp_lcd_panel_st7262_refresh_period_us(panel->frame_period_us));
+        if (error != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to start ST7262 LCD panel refresh timer: %s", esp_err_to_name(error));
+            return error;
+        }
+    }
+
     return ESP_OK;
 }
 
@@ -226,6 +540,37 @@ esp_err_t esp_lcd_panel_st7262_mirror(esp_lcd_panel_st7262_panel_handle_t handle
     return ESP_OK;
 }
 
+esp_err_t esp_lcd_panel_st7262_set_rotation(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_rotation_t rotation)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (rotation > ESP_LCD_PANEL_ST7262_ROTATION_270)
+    {
+        ESP_LOGE(TAG, "Invalid rotation for ST7262 LCD panel: %d", rotation);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (rotation != ESP_LCD_PANEL_ST7262_ROTATION_0 && panel->rotate_buf == NULL)
+    {
+        uint32_t edge = panel->conf->width > panel->conf->height ? panel->conf->width : panel->conf->height;
+        size_t px = edge * ESP_LCD_PANEL_ST7262_ROTATE_BUF_LINES;
+        panel->rotate_buf = heap_caps_malloc(px * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (panel->rotate_buf == NULL)
+        {
+            ESP_LOGE(TAG, "Failed to allocate ST7262 LCD panel rotation buffer.");
+            return ESP_ERR_NO_MEM;
+        }
+        panel->rotate_buf_px = px;
+    }
+
+    panel->rotation = rotation;
+    return ESP_OK;
+}
+
 esp_err_t esp_lcd_panel_st7262_swap_xy(esp_lcd_panel_st7262_panel_handle_t handle, bool swap_axes)
 {
     if (handle == NULL)
@@ -284,6 +629,163 @@ esp_err_t esp_lcd_panel_st7262_backlight_on_ff(const esp_lcd_panel_st7262_config
     return ESP_OK;
 }
 
+static int esp_lcd_panel_st7262_fb_index(const esp_lcd_panel_st7262_panel_handle_t panel, const void *buf)
+{
+    for (int i = 0; i < panel->flip.num_fbs; i++)
+    {
+        if (panel->fbs[i] == buf)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static esp_err_t esp_lcd_panel_st7262_present(const esp_lcd_panel_st7262_panel_handle_t panel, int index, int x_start, int y_start, int x_end, int y_end)
+{
+    portENTER_CRITICAL(&panel->lock);
+    bool pending = panel->flip.pending;
+    bool is_front = panel->flip.front == index;
+    portEXIT_CRITICAL(&panel->lock);
+
+    if (pending)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel swap is already pending.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // A stale completion from an earlier swap must not satisfy a later wait
+    xSemaphoreTake(panel->flip_done, 0);
+
+    esp_err_t error;
+    if (panel->refresh_timer != NULL)
+    {
+        // On demand, draw_bitmap would start a frame right away, only write the area back
+        // and leave the frame and the switch to the refresh timer
+        error = esp_lcd_panel_st7262_writeback(panel, panel->fbs[index], x_start, y_start, x_end, y_end);
+    }
+    else
+    {
+        // Drawing one of the panel's own frame buffers only writes the area back from the
+        // cache, and makes the RGB driver switch to that buffer at the next frame
+        error = esp_lcd_panel_draw_bitmap(panel->handle, x_start, y_start, x_end, y_end, panel->fbs[index]);
+        esp_lcd_panel_st7262_mark_dirty(panel);
+    }
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to present ST7262 LCD panel frame buffer: %s", esp_err_to_name(error));
+        return error;
+    }
+
+    if (!is_front)
+    {
+        portENTER_CRITICAL(&panel->lock);
+        bool queued = esp_lcd_panel_st7262_flip_state_queue(&panel->flip, (uint8_t)index);
+        portEXIT_CRITICAL(&panel->lock);
+
+        // Another task queued a swap since the check above
+        if (!queued)
+        {
+            ESP_LOGE(TAG, "ST7262 LCD panel swap is already pending.");
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+
+    return ESP_OK;
+}
+
+// On-demand panels must not start a frame per area, which esp_lcd_panel_draw_bitmap() does,
+// so the area is copied into the newest frame buffer and written back here instead
+static esp_err_t esp_lcd_panel_st7262_copy_to_fb(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const uint16_t *color_data)
+{
+    if (x_start < 0 || y_start < 0 || x_start >= x_end || y_start >= y_end || x_end > (int)panel->conf->width || y_end > (int)panel->conf->height)
+    {
+        ESP_LOGE(TAG, "Invalid area for ST7262 LCD panel draw.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&panel->lock);
+    uint16_t *fb = (uint16_t *)panel->fbs[panel->flip.pending ? panel->flip.queued : panel->flip.front];
+    portEXIT_CRITICAL(&panel->lock);
+
+    uint32_t stride = panel->conf->width * sizeof(uint16_t);
+    uint32_t w = x_end - x_start;
+    esp_lcd_panel_st7262_pixel_copy(fb + y_start * panel->conf->width + x_start, stride, color_data, w * sizeof(uint16_t), w, y_end - y_start);
+
+    return esp_lcd_panel_st7262_writeback(panel, fb, x_start, y_start, x_end, y_end);
+}
+
+static esp_err_t esp_lcd_panel_st7262_draw_rotated(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const uint16_t *color_data)
+{
+    uint32_t w = x_end - x_start;
+    uint32_t h = y_end - y_start;
+    if (w == 0 || h == 0 || w > panel->rotate_buf_px)
+    {
+        ESP_LOGE(TAG, "Invalid area for rotated ST7262 LCD panel draw.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Rotate in bands of source rows that fit the scratch buffer
+    uint32_t band = panel->rotate_buf_px / w;
+    for (uint32_t y = 0; y < h; y += band)
+    {
+        uint32_t rows = h - y < band ? h - y : band;
+        bool swapped = panel->rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || panel->rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+        uint32_t dst_w = swapped ? rows : w;
+
+        esp_lcd_panel_st7262_rotate_rgb565(color_data + y * w, w * sizeof(uint16_t), w, rows,
+                                           panel->rotate_buf, dst_w * sizeof(uint16_t), panel->rotation);
+
+        int x1 = x_start;
+        int y1 = y_start + y;
+        int x2 = x_end;
+        int y2 = y_start + y + rows;
+        esp_lcd_panel_st7262_rotate_area(panel->conf->width, panel->conf->height, panel->rotation, &x1, &y1, &x2, &y2);
+
+        esp_err_t error = panel->refresh_timer != NULL ? esp_lcd_panel_st7262_copy_to_fb(panel, x1, y1, x2, y2, panel->rotate_buf)
+                                                       : esp_lcd_panel_draw_bitmap(panel->handle, x1, y1, x2, y2, panel->rotate_buf);
+        if (error != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to draw rotated bitmap on ST7262 LCD panel: %s", esp_err_to_name(error));
+            return error;
+        }
+    }
+
+    return ESP_OK;
+}
+
+static esp_err_t esp_lcd_panel_st7262_draw(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    int fb_index = esp_lcd_panel_st7262_fb_index(panel, color_data);
+    if (fb_index >= 0 && panel->flip.num_fbs > 1)
+    {
+        return esp_lcd_panel_st7262_present(panel, fb_index, x_start, y_start, x_end, y_end);
+    }
+
+    if (fb_index < 0 && panel->rotation != ESP_LCD_PANEL_ST7262_ROTATION_0)
+    {
+        esp_lcd_panel_st7262_mark_dirty(panel);
+        return esp_lcd_panel_st7262_draw_rotated(panel, x_start, y_start, x_end, y_end, color_data);
+    }
+
+    if (panel->refresh_timer != NULL)
+    {
+        return fb_index >= 0 ? esp_lcd_panel_st7262_writeback(panel, color_data, x_start, y_start, x_end, y_end)
+                             : esp_lcd_panel_st7262_copy_to_fb(panel, x_start, y_start, x_end, y_end, color_data);
+    }
+
+    esp_lcd_panel_st7262_mark_dirty(panel);
+    esp_err_t error = esp_lcd_panel_draw_bitmap(panel->handle, x_start, y_start, x_end, y_end, color_data);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to draw bitmap on ST7262 LCD panel: %s", esp_err_to_name(error));
+        return error;
+    }
+
+    return ESP_OK;
+}
+
 esp_err_t esp_lcd_panel_st7262_draw_bitmap(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
 {
     if (panel == NULL || panel->handle == NULL)
@@ -292,12 +794,323 @@ esp_err_t esp_lcd_panel_st7262_draw_bitmap(const esp_lcd_panel_st7262_panel_hand
         return ESP_ERR_INVALID_ARG;
     }
 
-    esp_err_t error = esp_lcd_panel_draw_bitmap(panel->handle, x_start, y_start, x_end, y_end, color_data);
+#if ESP_LCD_PANEL_ST7262_STATS
+    int64_t start = esp_timer_get_time();
+    esp_err_t error = esp_lcd_panel_st7262_draw(panel, x_start, y_start, x_end, y_end, color_data);
+    ESP_LCD_PANEL_ST7262_STATS_RECORD(&panel->stats.draw_us, (uint32_t)(esp_timer_get_time() - start));
+    if (x_end > x_start && y_end > y_start)
+    {
+        ESP_LCD_PANEL_ST7262_STATS_RECORD(&panel->stats.draw_bytes, (uint32_t)((x_end - x_start) * (y_end - y_start) * sizeof(uint16_t)));
+    }
+    return error;
+#else
+    return esp_lcd_panel_st7262_draw(panel, x_start, y_start, x_end, y_end, color_data);
+#endif
+}
+
+esp_err_t esp_lcd_panel_st7262_get_frame_buffers(const esp_lcd_panel_st7262_panel_handle_t panel, void **fbs, uint32_t *num_fbs)
+{
+    if (panel == NULL || panel->handle == NULL || fbs == NULL || num_fbs == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < ESP_LCD_PANEL_ST7262_MAX_FBS; i++)
+    {
+        fbs[i] = i < panel->flip.num_fbs ? panel->fbs[i] : NULL;
+    }
+    *num_fbs = panel->flip.num_fbs;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_writeback(const esp_lcd_panel_st7262_panel_handle_t panel, const void *fb, int x_start, int y_start, int x_end, int y_end)
+{
+    if (panel == NULL || panel->handle == NULL || fb == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (esp_lcd_panel_st7262_fb_index(panel, fb) < 0 || x_start < 0 || y_start < 0 || x_start >= x_end || y_start >= y_end ||
+        x_end > (int)panel->conf->width || y_end > (int)panel->conf->height)
+    {
+        ESP_LOGE(TAG, "Invalid write back area for ST7262 LCD panel.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_lcd_panel_st7262_mark_dirty(panel);
+
+    size_t stride = panel->conf->width * sizeof(uint16_t);
+    size_t row_bytes = (x_end - x_start) * sizeof(uint16_t);
+    uint8_t *first = (uint8_t *)fb + y_start * stride + x_start * sizeof(uint16_t);
+    uint8_t *last = (uint8_t *)fb + (y_end - 1) * stride + x_end * sizeof(uint16_t);
+
+    // Rows are contiguous in the frame buffer, one range covers the area unless the
+    // bytes between narrow rows cost more than a call per row
+    size_t span_bytes = last - first;
+    size_t rows = y_end - y_start;
+    if (span_bytes <= rows * row_bytes + (rows - 1) * ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES)
+    {
+        rows = 1;
+        row_bytes = span_bytes;
+    }
+
+    for (size_t row = 0; row < rows; row++)
+    {
+        esp_err_t error = esp_cache_msync(first + row * stride, row_bytes, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+        if (error != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to write back ST7262 LCD panel frame buffer: %s", esp_err_to_name(error));
+            return error;
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_writeback_dirty(const esp_lcd_panel_st7262_panel_handle_t panel, const void *fb, esp_lcd_panel_st7262_dirty_t *dirty)
+{
+    if (panel == NULL || panel->handle == NULL || fb == NULL || dirty == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t count = esp_lcd_panel_st7262_dirty_coalesce(dirty);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const esp_lcd_panel_st7262_rect_t *rect = &dirty->rects[i];
+        esp_err_t error = esp_lcd_panel_st7262_writeback(panel, fb, rect->x_start, rect->y_start, rect->x_end, rect->y_end);
+        if (error != ESP_OK)
+        {
+            return error;
+        }
+    }
+
+    esp_lcd_panel_st7262_dirty_reset(dirty);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_get_back_buffer(const esp_lcd_panel_st7262_panel_handle_t panel, void **buf, uint32_t timeout_ms)
+{
+    if (panel == NULL || panel->handle == NULL || buf == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->flip.num_fbs < 2)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel has a single frame buffer, page flipping is not available.");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    while (true)
+    {
+        portENTER_CRITICAL(&panel->lock);
+        int back = esp_lcd_panel_st7262_flip_state_back(&panel->flip);
+        portEXIT_CRITICAL(&panel->lock);
+
+        if (back >= 0)
+        {
+            *buf = panel->fbs[back];
+            return ESP_OK;
+        }
+
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || xSemaphoreTake(panel->flip_done, timeout - elapsed) != pdTRUE)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+}
+
+esp_err_t esp_lcd_panel_st7262_flip(const esp_lcd_panel_st7262_panel_handle_t panel)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->flip.num_fbs < 2)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel has a single frame buffer, page flipping is not available.");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    portENTER_CRITICAL(&panel->lock);
+    int back = esp_lcd_panel_st7262_flip_state_back(&panel->flip);
+    portEXIT_CRITICAL(&panel->lock);
+
+    if (back < 0)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel swap is already pending.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return esp_lcd_panel_st7262_present(panel, back, 0, 0, panel->conf->width, panel->conf->height);
+}
+
+esp_err_t esp_lcd_panel_st7262_wait_flip(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t timeout_ms)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    while (true)
+    {
+        portENTER_CRITICAL(&panel->lock);
+        bool pending = panel->flip.pending;
+        portEXIT_CRITICAL(&panel->lock);
+
+        if (!pending)
+        {
+            return ESP_OK;
+        }
+
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || xSemaphoreTake(panel->flip_done, timeout - elapsed) != pdTRUE)
+        {
+            ESP_LOGE(TAG, "Timed out waiting for ST7262 LCD panel frame buffer swap.");
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+}
+
+esp_err_t esp_lcd_panel_st7262_flip_sync(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t timeout_ms)
+{
+    esp_err_t error = esp_lcd_panel_st7262_flip(panel);
     if (error != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to draw bitmap on ST7262 LCD panel: %s", esp_err_to_name(error));
         return error;
     }
 
+    return esp_lcd_panel_st7262_wait_flip(panel, timeout_ms);
+}
+
+esp_err_t esp_lcd_panel_st7262_register_vsync_cb(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_vsync_cb_t cb, void *user_ctx)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&panel->lock);
+    panel->vsync_cb = cb;
+    panel->vsync_cb_ctx = user_ctx;
+    portEXIT_CRITICAL(&panel->lock);
+
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t esp_lcd_panel_st7262_set_refresh_policy(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t idle_frames, uint32_t keepalive_ms)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->refresh_timer == NULL)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel was not created with on-demand refresh.");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    portENTER_CRITICAL(&panel->lock);
+    panel->refresh.idle_frames = idle_frames;
+    panel->refresh.keepalive_frames = keepalive_ms * 1000 / esp_lcd_panel_st7262_refresh_period_us(panel->frame_period_us);
+    portEXIT_CRITICAL(&panel->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_get_refresh_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_refresh_stats_t *stats)
+{
+    if (panel == NULL || panel->handle == NULL || stats == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->refresh_timer == NULL)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel was not created with on-demand refresh.");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    portENTER_CRITICAL(&panel->lock);
+    *stats = panel->refresh.stats;
+    portEXIT_CRITICAL(&panel->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_get_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_stats_t *stats, bool reset)
+{
+    if (panel == NULL || panel->handle == NULL || stats == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if ESP_LCD_PANEL_ST7262_STATS
+    if (reset)
+    {
+        esp_lcd_panel_st7262_stats_take(&panel->stats, stats);
+    }
+    else
+    {
+        *stats = panel->stats;
+    }
+
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t esp_lcd_panel_st7262_log_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_stats_format_t format, bool reset)
+{
+    esp_lcd_panel_st7262_stats_t stats;
+    esp_err_t error = esp_lcd_panel_st7262_get_stats(panel, &stats, reset);
+    if (error != ESP_OK)
+    {
+        return error;
+    }
+
+    size_t size = format == ESP_LCD_PANEL_ST7262_STATS_BINARY ? ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE : esp_lcd_panel_st7262_stats_csv(&stats, NULL, 0) + 1;
+    char *buf = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    if (buf == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate ST7262 LCD panel statistics buffer.");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (format == ESP_LCD_PANEL_ST7262_STATS_BINARY)
+    {
+        size = esp_lcd_panel_st7262_stats_pack(&stats, (uint8_t *)buf, size);
+        ESP_LOG_BUFFER_HEX(TAG, buf, size);
+    }
+    else
+    {
+        esp_lcd_panel_st7262_stats_csv(&stats, buf, size);
+        for (char *line = strtok(buf, "\n"); line != NULL; line = strtok(NULL, "\n"))
+        {
+            ESP_LOGI(TAG, "%s", line);
+        }
+    }
+
+    heap_caps_free(buf);
+    return ESP_OK;
+}
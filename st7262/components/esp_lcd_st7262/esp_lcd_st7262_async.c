@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <esp_log.h>
+#include <esp_heap_caps.h>
+#include "esp_lcd_st7262.h"
+
+#define TAG "ESP_LCD_ST7262"
+
+typedef struct
+{
+    int x_start;
+    int y_start;
+    int x_end;
+    int y_end;
+    const void *color_data;
+    esp_lcd_panel_st7262_draw_done_cb_t done_cb;
+    void *user_ctx;
+} esp_lcd_panel_st7262_async_request_t;
+
+// Request ring between the submitting task and the worker, the requests follow the struct
+struct esp_lcd_panel_st7262_async
+{
+    esp_lcd_panel_st7262_queue_t queue;
+    SemaphoreHandle_t space; // Given by the worker after a pop while the producer waits on a full ring
+    uint32_t stopped;        // Set by the worker right before it deletes itself
+};
+
+static esp_err_t esp_lcd_panel_st7262_async_push(const esp_lcd_panel_st7262_panel_handle_t panel, const esp_lcd_panel_st7262_async_request_t *request, uint32_t timeout_ms)
+{
+    esp_lcd_panel_st7262_queue_t *queue = &panel->async->queue;
+
+    // A full ring is the throttling case. The worker gives the semaphore right after the pop
+    // that frees a slot, so the caller's task notification stays untouched. Rounded up, a
+    // timeout below a tick still waits for one.
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = timeout_ms == portMAX_DELAY ? portMAX_DELAY
+                                                     : (TickType_t)(((uint64_t)timeout_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+    while (!esp_lcd_panel_st7262_queue_push(queue, request))
+    {
+        if (esp_lcd_panel_st7262_queue_prepare_push_wait(queue))
+        {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (timeout != portMAX_DELAY && elapsed >= timeout)
+            {
+                esp_lcd_panel_st7262_queue_end_push_wait(queue);
+                return ESP_ERR_TIMEOUT;
+            }
+            xSemaphoreTake(panel->async->space, timeout == portMAX_DELAY ? portMAX_DELAY : timeout - elapsed);
+        }
+        esp_lcd_panel_st7262_queue_end_push_wait(queue);
+    }
+
+    if (esp_lcd_panel_st7262_queue_wake_consumer(queue))
+    {
+        xTaskNotifyGive(panel->async_task);
+    }
+
+    return ESP_OK;
+}
+
+static void esp_lcd_panel_st7262_async_task(void *arg)
+{
+    esp_lcd_panel_st7262_panel_handle_t panel = (esp_lcd_panel_st7262_panel_handle_t)arg;
+    esp_lcd_panel_st7262_async_t *async = panel->async;
+    esp_lcd_panel_st7262_async_request_t request;
+
+    while (true)
+    {
+        if (!esp_lcd_panel_st7262_queue_pop(&async->queue, &request))
+        {
+            if (esp_lcd_panel_st7262_queue_stopped(&async->queue))
+            {
+                // Everything submitted before the stop has been drawn
+                __atomic_store_n(&async->stopped, 1, __ATOMIC_RELEASE);
+                vTaskDelete(NULL);
+            }
+
+            if (esp_lcd_panel_st7262_queue_prepare_wait(&async->queue))
+            {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            }
+            esp_lcd_panel_st7262_queue_end_wait(&async->queue);
+            continue;
+        }
+
+        if (esp_lcd_panel_st7262_queue_wake_producer(&async->queue))
+        {
+            xSemaphoreGive(async->space);
+        }
+
+        esp_err_t error = esp_lcd_panel_st7262_draw_bitmap(panel, request.x_start, request.y_start, request.x_end, request.y_end, request.color_data);
+        if (request.done_cb != NULL)
+        {
+            request.done_cb(panel, error, request.user_ctx);
+        }
+    }
+}
+
+esp_err_t esp_lcd_panel_st7262_async_start(const esp_lcd_panel_st7262_panel_handle_t panel, const esp_lcd_panel_st7262_async_config_t *config)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->async_task != NULL)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel draw worker is already running.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const esp_lcd_panel_st7262_async_config_t default_config = ESP_LCD_PANEL_ST7262_ASYNC_DEFAULT_CONFIG();
+    if (config == NULL)
+    {
+        config = &default_config;
+    }
+
+    if (config->queue_depth == 0)
+    {
+        ESP_LOGE(TAG, "Invalid queue depth for ST7262 LCD panel draw worker.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    panel->async = (esp_lcd_panel_st7262_async_t *)heap_caps_calloc(1, sizeof(esp_lcd_panel_st7262_async_t) + config->queue_depth * sizeof(esp_lcd_panel_st7262_async_request_t),
+                                                                   MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (panel->async == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create ST7262 LCD panel draw queue.");
+        return ESP_ERR_NO_MEM;
+    }
+    esp_lcd_panel_st7262_queue_init(&panel->async->queue, panel->async + 1, config->queue_depth, sizeof(esp_lcd_panel_st7262_async_request_t));
+    panel->async->space = xSemaphoreCreateBinary();
+    if (panel->async->space == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to create ST7262 LCD panel draw queue.");
+        free(panel->async);
+        panel->async = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (xTaskCreatePinnedToCore(esp_lcd_panel_st7262_async_task, "st7262_draw", config->task_stack, panel, config->task_priority,
+                                &panel->async_task, config->task_core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create ST7262 LCD panel draw task.");
+        vSemaphoreDelete(panel->async->space);
+        free(panel->async);
+        panel->async = NULL;
+        panel->async_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_async_stop(const esp_lcd_panel_st7262_panel_handle_t panel)
+{
+    if (panel == NULL || panel->handle == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->async_task == NULL)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel draw worker is not running.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // The stop is a flag next to the ring, so any task can stop the worker without
+    // becoming a second producer or giving up its own task notification
+    esp_lcd_panel_st7262_queue_stop(&panel->async->queue);
+    if (esp_lcd_panel_st7262_queue_wake_consumer(&panel->async->queue))
+    {
+        xTaskNotifyGive(panel->async_task);
+    }
+    while (!__atomic_load_n(&panel->async->stopped, __ATOMIC_ACQUIRE))
+    {
+        vTaskDelay(1);
+    }
+
+    vSemaphoreDelete(panel->async->space);
+    free(panel->async);
+    panel->async = NULL;
+    panel->async_task = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_st7262_draw_bitmap_async(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                                 const void *color_data, esp_lcd_panel_st7262_draw_done_cb_t done_cb, void *user_ctx, uint32_t timeout_ms)
+{
+    if (panel == NULL || panel->handle == NULL || color_data == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid handle for ST7262 LCD panel. Pointer is NULL.");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (panel->async == NULL)
+    {
+        ESP_LOGE(TAG, "ST7262 LCD panel draw worker is not running.");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const esp_lcd_panel_st7262_async_request_t request = {
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .color_data = color_data,
+        .done_cb = done_cb,
+        .user_ctx = user_ctx,
+    };
+
+    return esp_lcd_panel_st7262_async_push(panel, &request, timeout_ms);
+}
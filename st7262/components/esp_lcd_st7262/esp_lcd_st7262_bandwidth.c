@@ -0,0 +1,56 @@
+#include "esp_lcd_st7262_bandwidth.h"
+#include <stddef.h>
+
+static uint32_t default_if_zero(uint32_t value, uint32_t fallback)
+{
+    return value == 0 ? fallback : value;
+}
+
+bool esp_lcd_panel_st7262_bandwidth_estimate(const esp_lcd_panel_st7262_bandwidth_params_t *params, esp_lcd_panel_st7262_bandwidth_t *out)
+{
+    if (params == NULL || out == NULL || params->h_res == 0 || params->v_res == 0 || params->bytes_per_px == 0)
+    {
+        return false;
+    }
+
+    uint64_t psram = default_if_zero(params->psram_bytes_per_s, ESP_LCD_PANEL_ST7262_PSRAM_BYTES_PER_S);
+    uint64_t reserve = params->cpu_reserve_pct == 0 ? ESP_LCD_PANEL_ST7262_CPU_RESERVE_PCT : params->cpu_reserve_pct;
+    uint64_t burst = default_if_zero(params->dma_burst_size, 64);
+    uint64_t h_total = params->h_res + params->h_blank;
+    uint64_t v_total = params->v_res + params->v_blank;
+
+    if (reserve >= 100)
+    {
+        reserve = 99;
+    }
+
+    // Share left for the scanout, reduced by the per-burst overhead
+    uint64_t available = psram * (100 - reserve) / 100;
+    available = available * burst / (burst + ESP_LCD_PANEL_ST7262_PSRAM_BURST_OVERHEAD);
+
+    uint64_t max_pclk;
+    uint64_t required;
+    if (params->bounce_buffer_lines == 0)
+    {
+        // GDMA streams from PSRAM while pixels are clocked out, so it has to match the peak rate
+        available = available * default_if_zero(params->direct_dma_eff_pct, ESP_LCD_PANEL_ST7262_DIRECT_DMA_EFF_PCT) / 100;
+        max_pclk = available / params->bytes_per_px;
+        required = (uint64_t)params->pclk_hz * params->bytes_per_px;
+    }
+    else
+    {
+        // Bounce buffers are refilled over the whole line, horizontal blanking included
+        available = available * default_if_zero(params->bounce_copy_eff_pct, ESP_LCD_PANEL_ST7262_BOUNCE_COPY_EFF_PCT) / 100;
+        max_pclk = available * h_total / ((uint64_t)params->h_res * params->bytes_per_px);
+        required = (uint64_t)params->pclk_hz * params->bytes_per_px * params->h_res / h_total;
+    }
+
+    out->available_bytes_per_s = (uint32_t)available;
+    out->required_bytes_per_s = (uint32_t)required;
+    out->max_pclk_hz = (uint32_t)max_pclk;
+    out->max_fps_x100 = (uint32_t)(max_pclk * 100 / (h_total * v_total));
+    out->fps_x100 = (uint32_t)((uint64_t)params->pclk_hz * 100 / (h_total * v_total));
+    out->sustainable = required <= available;
+
+    return true;
+}
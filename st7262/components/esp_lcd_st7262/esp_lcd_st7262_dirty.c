@@ -0,0 +1,161 @@
+#include "esp_lcd_st7262_dirty.h"
+#include <stddef.h>
+
+static uint64_t rect_bytes(const esp_lcd_panel_st7262_dirty_t *dirty, const esp_lcd_panel_st7262_rect_t *rect)
+{
+    return (uint64_t)(rect->x_end - rect->x_start) * (uint64_t)(rect->y_end - rect->y_start) * dirty->bytes_per_px;
+}
+
+static esp_lcd_panel_st7262_rect_t rect_union(const esp_lcd_panel_st7262_rect_t *a, const esp_lcd_panel_st7262_rect_t *b)
+{
+    esp_lcd_panel_st7262_rect_t out = {
+        .x_start = a->x_start < b->x_start ? a->x_start : b->x_start,
+        .y_start = a->y_start < b->y_start ? a->y_start : b->y_start,
+        .x_end = a->x_end > b->x_end ? a->x_end : b->x_end,
+        .y_end = a->y_end > b->y_end ? a->y_end : b->y_end,
+    };
+    return out;
+}
+
+static uint64_t rect_overlap_bytes(const esp_lcd_panel_st7262_dirty_t *dirty, const esp_lcd_panel_st7262_rect_t *a, const esp_lcd_panel_st7262_rect_t *b)
+{
+    esp_lcd_panel_st7262_rect_t overlap = {
+        .x_start = a->x_start > b->x_start ? a->x_start : b->x_start,
+        .y_start = a->y_start > b->y_start ? a->y_start : b->y_start,
+        .x_end = a->x_end < b->x_end ? a->x_end : b->x_end,
+        .y_end = a->y_end < b->y_end ? a->y_end : b->y_end,
+    };
+
+    if (overlap.x_start >= overlap.x_end || overlap.y_start >= overlap.y_end)
+    {
+        return 0;
+    }
+
+    return rect_bytes(dirty, &overlap);
+}
+
+// Bytes the bounding box adds on top of drawing a and b separately, minus the saved call
+static int64_t merge_cost(const esp_lcd_panel_st7262_dirty_t *dirty, const esp_lcd_panel_st7262_rect_t *a, const esp_lcd_panel_st7262_rect_t *b)
+{
+    esp_lcd_panel_st7262_rect_t merged = rect_union(a, b);
+    int64_t separate = (int64_t)(rect_bytes(dirty, a) + rect_bytes(dirty, b) - rect_overlap_bytes(dirty, a, b));
+    return (int64_t)rect_bytes(dirty, &merged) - separate - (int64_t)dirty->call_overhead_bytes;
+}
+
+bool esp_lcd_panel_st7262_dirty_init(esp_lcd_panel_st7262_dirty_t *dirty, uint32_t width, uint32_t height, uint32_t bytes_per_px,
+                                     uint32_t align_px, uint32_t call_overhead_bytes)
+{
+    if (dirty == NULL || width == 0 || height == 0 || bytes_per_px == 0)
+    {
+        return false;
+    }
+
+    dirty->width = width;
+    dirty->height = height;
+    dirty->bytes_per_px = bytes_per_px;
+    dirty->align_px = align_px == 0 ? 1 : align_px;
+    dirty->call_overhead_bytes = call_overhead_bytes == 0 ? ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES : call_overhead_bytes;
+    dirty->count = 0;
+    dirty->bytes_added = 0;
+    dirty->bytes_emitted = 0;
+    dirty->rects_added = 0;
+    dirty->rects_emitted = 0;
+
+    return true;
+}
+
+void esp_lcd_panel_st7262_dirty_reset(esp_lcd_panel_st7262_dirty_t *dirty)
+{
+    if (dirty != NULL)
+    {
+        dirty->count = 0;
+    }
+}
+
+bool esp_lcd_panel_st7262_dirty_add(esp_lcd_panel_st7262_dirty_t *dirty, int x_start, int y_start, int x_end, int y_end)
+{
+    if (dirty == NULL)
+    {
+        return false;
+    }
+
+    esp_lcd_panel_st7262_rect_t rect = {
+        .x_start = x_start < 0 ? 0 : x_start,
+        .y_start = y_start < 0 ? 0 : y_start,
+        .x_end = x_end > (int)dirty->width ? (int)dirty->width : x_end,
+        .y_end = y_end > (int)dirty->height ? (int)dirty->height : y_end,
+    };
+
+    if (rect.x_start >= rect.x_end || rect.y_start >= rect.y_end)
+    {
+        return false;
+    }
+
+    dirty->bytes_added += rect_bytes(dirty, &rect);
+    dirty->rects_added++;
+
+    // Round out to whole cache lines so neighbouring copies never share one
+    int align = (int)dirty->align_px;
+    rect.x_start -= rect.x_start % align;
+    rect.x_end += (align - rect.x_end % align) % align;
+    if (rect.x_end > (int)dirty->width)
+    {
+        rect.x_end = (int)dirty->width;
+    }
+
+    if (dirty->count < ESP_LCD_PANEL_ST7262_DIRTY_MAX_RECTS)
+    {
+        dirty->rects[dirty->count++] = rect;
+        return true;
+    }
+
+    uint32_t best = 0;
+    int64_t best_cost = INT64_MAX;
+    for (uint32_t i = 0; i < dirty->count; i++)
+    {
+        int64_t cost = merge_cost(dirty, &dirty->rects[i], &rect);
+        if (cost < best_cost)
+        {
+            best_cost = cost;
+            best = i;
+        }
+    }
+    dirty->rects[best] = rect_union(&dirty->rects[best], &rect);
+
+    return true;
+}
+
+uint32_t esp_lcd_panel_st7262_dirty_coalesce(esp_lcd_panel_st7262_dirty_t *dirty)
+{
+    if (dirty == NULL)
+    {
+        return 0;
+    }
+
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (uint32_t i = 0; i < dirty->count && !merged; i++)
+        {
+            for (uint32_t j = i + 1; j < dirty->count; j++)
+            {
+                if (merge_cost(dirty, &dirty->rects[i], &dirty->rects[j]) <= 0)
+                {
+                    dirty->rects[i] = rect_union(&dirty->rects[i], &dirty->rects[j]);
+                    dirty->rects[j] = dirty->rects[--dirty->count];
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < dirty->count; i++)
+    {
+        dirty->bytes_emitted += rect_bytes(dirty, &dirty->rects[i]);
+    }
+    dirty->rects_emitted += dirty->count;
+
+    return dirty->count;
+}
@@ -0,0 +1,63 @@
+#include "esp_lcd_st7262_flip.h"
+#include <stddef.h>
+
+bool esp_lcd_panel_st7262_flip_state_init(esp_lcd_panel_st7262_flip_state_t *state, uint8_t num_fbs)
+{
+    if (state == NULL || num_fbs == 0 || num_fbs > ESP_LCD_PANEL_ST7262_MAX_FBS)
+    {
+        return false;
+    }
+
+    state->num_fbs = num_fbs;
+    state->front = 0;
+    state->queued = 0;
+    state->pending = false;
+    state->flips = 0;
+
+    return true;
+}
+
+int esp_lcd_panel_st7262_flip_state_back(const esp_lcd_panel_st7262_flip_state_t *state)
+{
+    if (state == NULL || state->num_fbs < 2)
+    {
+        return -1;
+    }
+
+    // Next buffer after the newest one handed to the display
+    uint8_t newest = state->pending ? state->queued : state->front;
+    uint8_t back = (newest + 1) % state->num_fbs;
+    if (back == state->front)
+    {
+        return -1;
+    }
+
+    return back;
+}
+
+bool esp_lcd_panel_st7262_flip_state_queue(esp_lcd_panel_st7262_flip_state_t *state, uint8_t index)
+{
+    if (state == NULL || state->pending || index >= state->num_fbs || index == state->front)
+    {
+        return false;
+    }
+
+    state->queued = index;
+    state->pending = true;
+
+    return true;
+}
+
+bool esp_lcd_panel_st7262_flip_state_vsync(esp_lcd_panel_st7262_flip_state_t *state)
+{
+    if (state == NULL || !state->pending)
+    {
+        return false;
+    }
+
+    state->front = state->queued;
+    state->pending = false;
+    state->flips++;
+
+    return true;
+}
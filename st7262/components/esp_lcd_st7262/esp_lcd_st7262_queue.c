@@ -0,0 +1,93 @@
+#include "esp_lcd_st7262_queue.h"
+#include <string.h>
+
+bool esp_lcd_panel_st7262_queue_init(esp_lcd_panel_st7262_queue_t *queue, void *slots, uint32_t depth, uint32_t slot_size)
+{
+    if (queue == NULL || slots == NULL || depth == 0 || slot_size == 0)
+    {
+        return false;
+    }
+
+    queue->slots = (uint8_t *)slots;
+    queue->depth = depth;
+    queue->slot_size = slot_size;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->consumer_waiting = 0;
+    queue->producer_waiting = 0;
+    queue->stop = 0;
+
+    return true;
+}
+
+bool esp_lcd_panel_st7262_queue_push(esp_lcd_panel_st7262_queue_t *queue, const void *request)
+{
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    if (head - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE) >= queue->depth)
+    {
+        return false;
+    }
+
+    memcpy(queue->slots + (head % queue->depth) * queue->slot_size, request, queue->slot_size);
+    // Sequentially consistent, so the consumer_waiting check that follows cannot move before it
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+bool esp_lcd_panel_st7262_queue_pop(esp_lcd_panel_st7262_queue_t *queue, void *request)
+{
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    if (tail == __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    memcpy(request, queue->slots + (tail % queue->depth) * queue->slot_size, queue->slot_size);
+    // Sequentially consistent, so the producer_waiting check that follows cannot move before it
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_SEQ_CST);
+    return true;
+}
+
+bool esp_lcd_panel_st7262_queue_wake_consumer(esp_lcd_panel_st7262_queue_t *queue)
+{
+    return __atomic_exchange_n(&queue->consumer_waiting, 0, __ATOMIC_SEQ_CST) != 0;
+}
+
+bool esp_lcd_panel_st7262_queue_prepare_wait(esp_lcd_panel_st7262_queue_t *queue)
+{
+    __atomic_store_n(&queue->consumer_waiting, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&queue->head, __ATOMIC_SEQ_CST) == __atomic_load_n(&queue->tail, __ATOMIC_RELAXED) &&
+           !__atomic_load_n(&queue->stop, __ATOMIC_SEQ_CST);
+}
+
+void esp_lcd_panel_st7262_queue_end_wait(esp_lcd_panel_st7262_queue_t *queue)
+{
+    __atomic_store_n(&queue->consumer_waiting, 0, __ATOMIC_SEQ_CST);
+}
+
+bool esp_lcd_panel_st7262_queue_wake_producer(esp_lcd_panel_st7262_queue_t *queue)
+{
+    return __atomic_exchange_n(&queue->producer_waiting, 0, __ATOMIC_SEQ_CST) != 0;
+}
+
+bool esp_lcd_panel_st7262_queue_prepare_push_wait(esp_lcd_panel_st7262_queue_t *queue)
+{
+    __atomic_store_n(&queue->producer_waiting, 1, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&queue->head, __ATOMIC_RELAXED) - __atomic_load_n(&queue->tail, __ATOMIC_SEQ_CST) >= queue->depth;
+}
+
+void esp_lcd_panel_st7262_queue_end_push_wait(esp_lcd_panel_st7262_queue_t *queue)
+{
+    __atomic_store_n(&queue->producer_waiting, 0, __ATOMIC_SEQ_CST);
+}
+
+void esp_lcd_panel_st7262_queue_stop(esp_lcd_panel_st7262_queue_t *queue)
+{
+    __atomic_store_n(&queue->stop, 1, __ATOMIC_SEQ_CST);
+}
+
+bool esp_lcd_panel_st7262_queue_stopped(esp_lcd_panel_st7262_queue_t *queue)
+{
+    return __atomic_load_n(&queue->stop, __ATOMIC_ACQUIRE) &&
+           __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+}
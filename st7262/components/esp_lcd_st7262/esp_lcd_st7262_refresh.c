@@ -0,0 +1,91 @@
+#include "esp_lcd_st7262_refresh.h"
+#include <stddef.h>
+
+uint32_t esp_lcd_panel_st7262_refresh_period_us(uint32_t frame_period_us)
+{
+    return frame_period_us + frame_period_us * ESP_LCD_PANEL_ST7262_REFRESH_MARGIN_PCT / 100;
+}
+
+bool esp_lcd_panel_st7262_refresh_init(esp_lcd_panel_st7262_refresh_t *state, uint32_t frame_bytes, uint32_t idle_frames, uint32_t keepalive_frames)
+{
+    if (state == NULL || frame_bytes == 0)
+    {
+        return false;
+    }
+
+    state->frame_bytes = frame_bytes;
+    state->idle_frames = idle_frames;
+    state->keepalive_frames = keepalive_frames;
+    state->idle_count = 0;
+    state->since_refresh = 0;
+    state->dirty = true;
+    state->in_flight = false;
+    state->stats = (esp_lcd_panel_st7262_refresh_stats_t){0};
+
+    return true;
+}
+
+void esp_lcd_panel_st7262_refresh_mark_dirty(esp_lcd_panel_st7262_refresh_t *state)
+{
+    if (state != NULL)
+    {
+        state->dirty = true;
+    }
+}
+
+bool esp_lcd_panel_st7262_refresh_tick(esp_lcd_panel_st7262_refresh_t *state)
+{
+    if (state == NULL)
+    {
+        return false;
+    }
+
+    // Restarting the DMA mid-frame would tear, wait for the vsync of the running refresh
+    // unless it is so late that it was lost
+    if (state->in_flight && ++state->since_refresh < ESP_LCD_PANEL_ST7262_REFRESH_STALL_FRAMES)
+    {
+        state->stats.deferred++;
+        return false;
+    }
+    state->in_flight = false;
+
+    bool refresh;
+    if (state->dirty)
+    {
+        state->dirty = false;
+        state->idle_count = 0;
+        refresh = true;
+    }
+    else if (state->idle_count < state->idle_frames)
+    {
+        state->idle_count++;
+        refresh = true;
+    }
+    else
+    {
+        refresh = state->keepalive_frames > 0 && state->since_refresh + 1 >= state->keepalive_frames;
+    }
+
+    if (refresh)
+    {
+        state->since_refresh = 0;
+        state->in_flight = true;
+        state->stats.refreshed++;
+    }
+    else
+    {
+        state->since_refresh++;
+        state->stats.skipped++;
+        state->stats.bytes_saved += state->frame_bytes;
+    }
+
+    return refresh;
+}
+
+void esp_lcd_panel_st7262_refresh_done(esp_lcd_panel_st7262_refresh_t *state)
+{
+    if (state != NULL)
+    {
+        state->in_flight = false;
+    }
+}
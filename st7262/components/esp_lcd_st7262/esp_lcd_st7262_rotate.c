@@ -0,0 +1,122 @@
+#include "esp_lcd_st7262_rotate.h"
+#include <stddef.h>
+
+#define ROW(ptr, stride, y) ((uint16_t *)((uint8_t *)(ptr) + (size_t)(y) * (stride)))
+#define CONST_ROW(ptr, stride, y) ((const uint16_t *)((const uint8_t *)(ptr) + (size_t)(y) * (stride)))
+
+static void rotate_90(const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint16_t *dst, uint32_t dst_stride)
+{
+    // (x, y) -> (y, w - 1 - x)
+    for (uint32_t ty = 0; ty < h; ty += ESP_LCD_PANEL_ST7262_ROTATE_TILE)
+    {
+        uint32_t ty_end = ty + ESP_LCD_PANEL_ST7262_ROTATE_TILE < h ? ty + ESP_LCD_PANEL_ST7262_ROTATE_TILE : h;
+        for (uint32_t tx = 0; tx < w; tx += ESP_LCD_PANEL_ST7262_ROTATE_TILE)
+        {
+            uint32_t tx_end = tx + ESP_LCD_PANEL_ST7262_ROTATE_TILE < w ? tx + ESP_LCD_PANEL_ST7262_ROTATE_TILE : w;
+            for (uint32_t x = tx; x < tx_end; x++)
+            {
+                uint16_t *d = ROW(dst, dst_stride, w - 1 - x);
+                for (uint32_t y = ty; y < ty_end; y++)
+                {
+                    d[y] = CONST_ROW(src, src_stride, y)[x];
+                }
+            }
+        }
+    }
+}
+
+static void rotate_270(const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint16_t *dst, uint32_t dst_stride)
+{
+    // (x, y) -> (h - 1 - y, x)
+    for (uint32_t ty = 0; ty < h; ty += ESP_LCD_PANEL_ST7262_ROTATE_TILE)
+    {
+        uint32_t ty_end = ty + ESP_LCD_PANEL_ST7262_ROTATE_TILE < h ? ty + ESP_LCD_PANEL_ST7262_ROTATE_TILE : h;
+        for (uint32_t tx = 0; tx < w; tx += ESP_LCD_PANEL_ST7262_ROTATE_TILE)
+        {
+            uint32_t tx_end = tx + ESP_LCD_PANEL_ST7262_ROTATE_TILE < w ? tx + ESP_LCD_PANEL_ST7262_ROTATE_TILE : w;
+            for (uint32_t x = tx; x < tx_end; x++)
+            {
+                uint16_t *d = ROW(dst, dst_stride, x);
+                for (uint32_t y = ty; y < ty_end; y++)
+                {
+                    d[h - 1 - y] = CONST_ROW(src, src_stride, y)[x];
+                }
+            }
+        }
+    }
+}
+
+static void rotate_180(const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint16_t *dst, uint32_t dst_stride)
+{
+    // Rows stay contiguous, only their order and direction change
+    for (uint32_t y = 0; y < h; y++)
+    {
+        const uint16_t *s = CONST_ROW(src, src_stride, y);
+        uint16_t *d = ROW(dst, dst_stride, h - 1 - y);
+        for (uint32_t x = 0; x < w; x++)
+        {
+            d[w - 1 - x] = s[x];
+        }
+    }
+}
+
+void esp_lcd_panel_st7262_rotate_rgb565(const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h,
+                                        uint16_t *dst, uint32_t dst_stride, esp_lcd_panel_st7262_rotation_t rotation)
+{
+    switch (rotation)
+    {
+    case ESP_LCD_PANEL_ST7262_ROTATION_90:
+        rotate_90(src, src_stride, w, h, dst, dst_stride);
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_180:
+        rotate_180(src, src_stride, w, h, dst, dst_stride);
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_270:
+        rotate_270(src, src_stride, w, h, dst, dst_stride);
+        break;
+    default:
+        for (uint32_t y = 0; y < h; y++)
+        {
+            const uint16_t *s = CONST_ROW(src, src_stride, y);
+            uint16_t *d = ROW(dst, dst_stride, y);
+            for (uint32_t x = 0; x < w; x++)
+            {
+                d[x] = s[x];
+            }
+        }
+        break;
+    }
+}
+
+void esp_lcd_panel_st7262_rotate_area(uint32_t width, uint32_t height, esp_lcd_panel_st7262_rotation_t rotation,
+                                      int *x_start, int *y_start, int *x_end, int *y_end)
+{
+    int x1 = *x_start;
+    int y1 = *y_start;
+    int x2 = *x_end;
+    int y2 = *y_end;
+
+    switch (rotation)
+    {
+    case ESP_LCD_PANEL_ST7262_ROTATION_90:
+        *x_start = y1;
+        *x_end = y2;
+        *y_start = (int)height - x2;
+        *y_end = (int)height - x1;
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_180:
+        *x_start = (int)width - x2;
+        *x_end = (int)width - x1;
+        *y_start = (int)height - y2;
+        *y_end = (int)height - y1;
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_270:
+        *x_start = (int)width - y2;
+        *x_end = (int)width - y1;
+        *y_start = x1;
+        *y_end = x2;
+        break;
+    default:
+        break;
+    }
+}
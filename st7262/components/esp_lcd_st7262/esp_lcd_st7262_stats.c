@@ -0,0 +1,148 @@
+#include "esp_lcd_st7262_stats.h"
+#include <stdio.h>
+
+#define STATS_PACK_VERSION 1
+
+static uint32_t bucket_of(uint32_t value)
+{
+    uint32_t bucket = value == 0 ? 0 : 32 - (uint32_t)__builtin_clz(value);
+    return bucket < ESP_LCD_PANEL_ST7262_HIST_BUCKETS ? bucket : ESP_LCD_PANEL_ST7262_HIST_BUCKETS - 1;
+}
+
+void esp_lcd_panel_st7262_histogram_record(esp_lcd_panel_st7262_histogram_t *hist, uint32_t value)
+{
+    __atomic_fetch_add(&hist->buckets[bucket_of(value)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+
+    uint32_t max = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > max && !__atomic_compare_exchange_n(&hist->max, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+uint32_t esp_lcd_panel_st7262_histogram_percentile(const esp_lcd_panel_st7262_histogram_t *hist, uint32_t pct)
+{
+    if (hist == NULL || hist->count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t target = ((uint64_t)hist->count * (pct > 100 ? 100 : pct) + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen >= target && hist->buckets[i] > 0)
+        {
+            if (i == ESP_LCD_PANEL_ST7262_HIST_BUCKETS - 1)
+            {
+                return hist->max;
+            }
+            uint32_t upper = i == 0 ? 0 : (1u << i) - 1;
+            return upper < hist->max ? upper : hist->max;
+        }
+    }
+
+    return hist->max;
+}
+
+static void histogram_take(esp_lcd_panel_st7262_histogram_t *hist, esp_lcd_panel_st7262_histogram_t *out)
+{
+    esp_lcd_panel_st7262_histogram_t copy;
+    for (uint32_t i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        copy.buckets[i] = __atomic_exchange_n(&hist->buckets[i], 0, __ATOMIC_RELAXED);
+    }
+    copy.count = __atomic_exchange_n(&hist->count, 0, __ATOMIC_RELAXED);
+    copy.max = __atomic_exchange_n(&hist->max, 0, __ATOMIC_RELAXED);
+
+    if (out != NULL)
+    {
+        *out = copy;
+    }
+}
+
+void esp_lcd_panel_st7262_stats_take(esp_lcd_panel_st7262_stats_t *stats, esp_lcd_panel_st7262_stats_t *out)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    esp_lcd_panel_st7262_stats_t copy;
+    histogram_take(&stats->vsync_interval_us, &copy.vsync_interval_us);
+    histogram_take(&stats->draw_bytes, &copy.draw_bytes);
+    histogram_take(&stats->draw_us, &copy.draw_us);
+    copy.missed_vsyncs = __atomic_exchange_n(&stats->missed_vsyncs, 0, __ATOMIC_RELAXED);
+
+    if (out != NULL)
+    {
+        *out = copy;
+    }
+}
+
+static size_t histogram_csv(const char *name, const esp_lcd_panel_st7262_histogram_t *hist, char *buf, size_t len, size_t pos)
+{
+    pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, "%s,%lu,%lu", name, (unsigned long)hist->count, (unsigned long)hist->max);
+    for (uint32_t i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, ",%lu", (unsigned long)hist->buckets[i]);
+    }
+    pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, "\n");
+
+    return pos;
+}
+
+size_t esp_lcd_panel_st7262_stats_csv(const esp_lcd_panel_st7262_stats_t *stats, char *buf, size_t len)
+{
+    if (stats == NULL)
+    {
+        return 0;
+    }
+
+    size_t pos = 0;
+    pos = histogram_csv("vsync_interval_us", &stats->vsync_interval_us, buf, len, pos);
+    pos = histogram_csv("draw_bytes", &stats->draw_bytes, buf, len, pos);
+    pos = histogram_csv("draw_us", &stats->draw_us, buf, len, pos);
+    pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, "missed_vsyncs,%lu\n", (unsigned long)stats->missed_vsyncs);
+
+    return pos;
+}
+
+static uint8_t *put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+    return out + 4;
+}
+
+static uint8_t *histogram_pack(const esp_lcd_panel_st7262_histogram_t *hist, uint8_t *out)
+{
+    out = put_u32(out, hist->count);
+    out = put_u32(out, hist->max);
+    for (uint32_t i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        out = put_u32(out, hist->buckets[i]);
+    }
+    return out;
+}
+
+size_t esp_lcd_panel_st7262_stats_pack(const esp_lcd_panel_st7262_stats_t *stats, uint8_t *buf, size_t len)
+{
+    if (stats == NULL || buf == NULL || len < ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE)
+    {
+        return 0;
+    }
+
+    uint8_t *out = buf;
+    out = put_u32(out, STATS_PACK_VERSION);
+    out = put_u32(out, ESP_LCD_PANEL_ST7262_HIST_BUCKETS);
+    out = histogram_pack(&stats->vsync_interval_us, out);
+    out = histogram_pack(&stats->draw_bytes, out);
+    out = histogram_pack(&stats->draw_us, out);
+    out = put_u32(out, stats->missed_vsyncs);
+
+    return (size_t)(out - buf);
+}
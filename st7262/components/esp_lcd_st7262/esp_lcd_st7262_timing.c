@@ -0,0 +1,77 @@
+#include "esp_lcd_st7262_timing.h"
+#include <stddef.h>
+#include <string.h>
+
+const esp_lcd_panel_st7262_timing_profile_t *esp_lcd_panel_st7262_timing_find(const esp_lcd_panel_st7262_timing_profile_t *profiles, uint32_t count,
+                                                                            const char *name)
+{
+    if (profiles == NULL || name == NULL)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (profiles[i].name != NULL && strcmp(profiles[i].name, name) == 0)
+        {
+            return &profiles[i];
+        }
+    }
+
+    return NULL;
+}
+
+bool esp_lcd_panel_st7262_timing_calc(const esp_lcd_panel_st7262_timing_mode_t *mode, const esp_lcd_panel_st7262_timing_profile_t *profile,
+                                      esp_lcd_panel_st7262_timing_result_t *out)
+{
+    if (mode == NULL || profile == NULL || out == NULL || profile->pclk_hz == 0)
+    {
+        return false;
+    }
+
+    const esp_lcd_panel_st7262_bandwidth_params_t params = {
+        .h_res = mode->h_res,
+        .v_res = mode->v_res,
+        .h_blank = profile->hsync_pulse_width + profile->hsync_back_porch + profile->hsync_front_porch,
+        .v_blank = profile->vsync_pulse_width + profile->vsync_back_porch + profile->vsync_front_porch,
+        .pclk_hz = profile->pclk_hz,
+        .bytes_per_px = mode->bytes_per_px,
+        .bounce_buffer_lines = mode->bounce_buffer_lines,
+        .dma_burst_size = mode->dma_burst_size,
+    };
+
+    if (!esp_lcd_panel_st7262_bandwidth_estimate(&params, &out->bandwidth))
+    {
+        return false;
+    }
+
+    out->h_total = params.h_res + params.h_blank;
+    out->v_total = params.v_res + params.v_blank;
+    out->line_time_ns = (uint32_t)((uint64_t)out->h_total * 1000 * 1000 * 1000 / profile->pclk_hz);
+    out->frame_time_us = (uint32_t)((uint64_t)out->h_total * out->v_total * 1000 * 1000 / profile->pclk_hz);
+    out->fps_x100 = out->bandwidth.fps_x100;
+    out->headroom_pct = out->bandwidth.max_pclk_hz > profile->pclk_hz
+                            ? (uint32_t)((uint64_t)(out->bandwidth.max_pclk_hz - profile->pclk_hz) * 100 / out->bandwidth.max_pclk_hz)
+                            : 0;
+
+    return true;
+}
+
+esp_lcd_panel_st7262_timing_status_t esp_lcd_panel_st7262_timing_validate(const esp_lcd_panel_st7262_timing_mode_t *mode,
+                                                                          const esp_lcd_panel_st7262_timing_profile_t *profile,
+                                                                          esp_lcd_panel_st7262_timing_result_t *out)
+{
+    esp_lcd_panel_st7262_timing_result_t result;
+    if (profile == NULL || profile->hsync_pulse_width == 0 || profile->vsync_pulse_width == 0 ||
+        !esp_lcd_panel_st7262_timing_calc(mode, profile, &result))
+    {
+        return ESP_LCD_PANEL_ST7262_TIMING_INVALID;
+    }
+
+    if (out != NULL)
+    {
+        *out = result;
+    }
+
+    return result.bandwidth.sustainable ? ESP_LCD_PANEL_ST7262_TIMING_OK : ESP_LCD_PANEL_ST7262_TIMING_UNSUSTAINABLE;
+}
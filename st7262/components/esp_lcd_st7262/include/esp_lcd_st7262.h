@@ -9,7 +9,36 @@
 #ifndef _ESP_LCD_ST7262_H_
 #define _ESP_LCD_ST7262_H_
 #include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 #include <esp_lcd_panel_rgb.h>
+#include <esp_timer.h>
+#include "esp_lcd_st7262_bandwidth.h"
+#include "esp_lcd_st7262_timing.h"
+#include "esp_lcd_st7262_flip.h"
+#include "esp_lcd_st7262_dirty.h"
+#include "esp_lcd_st7262_rotate.h"
+#include "esp_lcd_st7262_refresh.h"
+#include "esp_lcd_st7262_stats.h"
+#include "esp_lcd_st7262_queue.h"
+
+/**
+ * @brief Lines of the rotation scratch buffer, sized by the longer panel edge.
+ */
+#define ESP_LCD_PANEL_ST7262_ROTATE_BUF_LINES 16
+
+/**
+ * @brief Default configuration of the asynchronous draw worker.
+ */
+#define ESP_LCD_PANEL_ST7262_ASYNC_DEFAULT_CONFIG() \
+    {                                               \
+        .queue_depth = 4,                           \
+        .task_stack = 4096,                         \
+        .task_priority = 10,                        \
+        .task_core = tskNO_AFFINITY,                \
+    }
 
 /**
  * @brief Structure definition for the ST7262 LCD driver configuration.
@@ -87,6 +116,31 @@ typedef struct
     int pclk;
 } esp_lcd_panel_st7262_gpio_t;
 
+/**
+ * @brief Structure defining how the frame buffer is streamed to the ST7262 LCD panel.
+ *
+ * With bounce buffers enabled the GDMA reads from small internal RAM buffers that the
+ * CPU refills from the PSRAM frame buffer, which allows higher PCLK than a direct
+ * PSRAM -> LCD stream. Use esp_lcd_panel_st7262_bandwidth() to check a setting.
+ *
+ * With refresh_on_demand the GDMA only reads the frame buffer when the driver starts
+ * a frame: every frame period while the content changes, then only every keepalive_ms
+ * once it has been idle for idle_frames frames. Draws are copied and written back by
+ * the driver and flips wait for the refresh timer, so no frame starts outside the
+ * policy or before the vsync of the previous one. Requires bounce_buffer_lines = 0.
+ */
+typedef struct
+{
+    uint32_t bounce_buffer_lines; // Bounce buffer height in lines, 0 disables bounce buffers
+    uint32_t sram_trans_align;    // Alignment of buffers in internal RAM
+    uint32_t psram_trans_align;   // Alignment of buffers in PSRAM
+    uint32_t dma_burst_size;      // GDMA burst size in bytes
+    uint32_t num_fbs;             // Frame buffers in PSRAM, 1 or 2, 2 enables page flipping
+    bool refresh_on_demand;       // Only send frames when the content changed
+    uint32_t idle_frames;         // Frames still sent after the last change
+    uint32_t keepalive_ms;        // Refresh interval of an idle panel, 0 stops refreshing
+} esp_lcd_panel_st7262_scanout_t;
+
 /**
  * @brief Structure representing the configuration for the ST7262 LCD panel.
  *
@@ -101,10 +155,44 @@ typedef struct
     esp_lcd_panel_st7262_gpio_t gpio;
     esp_lcd_panel_st7262_timing_t timing;
     esp_lcd_panel_st7262_rgb565_t colour;
+    esp_lcd_panel_st7262_scanout_t scanout;
 } esp_lcd_panel_st7262_conf_t;
 
 typedef esp_lcd_panel_st7262_conf_t *esp_lcd_panel_st7262_config_handle_t;
 
+/**
+ * @brief Output format of esp_lcd_panel_st7262_log_stats().
+ */
+typedef enum
+{
+    ESP_LCD_PANEL_ST7262_STATS_CSV,    // One CSV line per histogram
+    ESP_LCD_PANEL_ST7262_STATS_BINARY, // Hex dump of esp_lcd_panel_st7262_stats_pack()
+} esp_lcd_panel_st7262_stats_format_t;
+
+typedef struct esp_lcd_panel_st7262_async esp_lcd_panel_st7262_async_t;
+
+/**
+ * @brief Structure configuring the asynchronous draw worker of the ST7262 LCD panel.
+ */
+typedef struct
+{
+    uint32_t queue_depth;      // Draw requests that can wait, further submissions sleep
+    uint32_t task_stack;       // Worker task stack size in bytes
+    UBaseType_t task_priority; // Worker task priority
+    BaseType_t task_core;      // Core the worker is pinned to, tskNO_AFFINITY to let it float
+} esp_lcd_panel_st7262_async_config_t;
+
+/**
+ * @brief Callback run from the vsync interrupt
+ *
+ * Runs in interrupt context, keep it short and do not block.
+ *
+ * @param timestamp_us esp_timer time of the vsync
+ * @param user_ctx User context passed at registration
+ * @return Whether a higher priority task was woken
+ */
+typedef bool (*esp_lcd_panel_st7262_vsync_cb_t)(int64_t timestamp_us, void *user_ctx);
+
 /**
  * @brief ST7262 LCD panel specific structure
  *
@@ -115,10 +203,41 @@ typedef esp_lcd_panel_st7262_conf_t *esp_lcd_panel_st7262_config_handle_t;
 typedef struct
 {
     esp_lcd_panel_handle_t handle;
+    const esp_lcd_panel_st7262_conf_t *conf;
+    void *fbs[ESP_LCD_PANEL_ST7262_MAX_FBS];
+    esp_lcd_panel_st7262_flip_state_t flip;
+    SemaphoreHandle_t flip_done;
+    portMUX_TYPE lock;
+    esp_lcd_panel_st7262_rotation_t rotation;
+    uint16_t *rotate_buf;
+    size_t rotate_buf_px;
+    esp_lcd_panel_st7262_async_t *async; // Request ring of the draw worker
+    TaskHandle_t async_task;
+    esp_lcd_panel_st7262_refresh_t refresh;
+    esp_timer_handle_t refresh_timer;
+    uint32_t frame_period_us;
+    bool flip_started; // On demand: the running frame shows the queued buffer
+    esp_lcd_panel_st7262_vsync_cb_t vsync_cb;
+    void *vsync_cb_ctx;
+    // Always present so the struct layout does not depend on ESP_LCD_PANEL_ST7262_STATS,
+    // they stay zero when the recording is compiled out
+    esp_lcd_panel_st7262_stats_t stats;
+    int64_t last_vsync_us;
 } esp_lcd_panel_st7262_panel_t;
 
 typedef esp_lcd_panel_st7262_panel_t *esp_lcd_panel_st7262_panel_handle_t;
 
+/**
+ * @brief Callback run by the asynchronous draw worker once a bitmap has been drawn
+ *
+ * Runs in the worker task. The bitmap memory can be reused from here on.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param result Result of esp_lcd_panel_st7262_draw_bitmap() for the request
+ * @param user_ctx User context passed with the request
+ */
+typedef void (*esp_lcd_panel_st7262_draw_done_cb_t)(esp_lcd_panel_st7262_panel_handle_t panel, esp_err_t result, void *user_ctx);
+
 /** Concrete device implementations */
 
 /**
@@ -161,24 +280,39 @@ static const esp_lcd_panel_st7262_conf_t ESP_LCD_PANEL_ST7262_8048S043 =
             .back_porch = 8,
             .pulse_width = 4,
         },
-        .pclk_hz = 16 * 1000 * 1000,
+        .pclk_hz = 16 * 1000 * 1000, // Profile "16MHZ" of ESP_LCD_PANEL_ST7262_8048S043_TIMINGS
         .pclk_active_neg = 1,
     },
     .colour = {
         .r_0 = 45, .r_1 = 48, .r_2 = 47, .r_3 = 21, .r_4 = 14, 
         .g_0 = 5, .g_1 = 6, .g_2 = 7, .g_3 = 15, .g_4 = 16, .g_5 = 4, 
         .b_0 = 8, .b_1 = 3, .b_2 = 46, .b_3 = 9, .b_4 = 1
+    },
+    .scanout = {
+        .bounce_buffer_lines = 10,
+        .sram_trans_align = 8,
+        .psram_trans_align = 64,
+        .dma_burst_size = 64,
+        .num_fbs = 1,
+        .refresh_on_demand = false,
+        .idle_frames = 2,
+        .keepalive_ms = 1000,
     }
 };
 
 /**
  * @brief Create a new ST7262 LCD panel instance
  *
+ * The timing is checked against the PSRAM bandwidth of the scanout mode first.
+ * At most two frame buffers are supported: the RGB driver holds one pending buffer
+ * switch, so a third buffer could never be queued while a swap waits for the vsync.
+ *
  * @param conf Configuration handle for the ST7262 panel
  * @param out_handle Output handle for the created panel instance
  * @return
  *      - ESP_OK: Success
  *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: The scanout mode cannot sustain the PCLK
  *      - ESP_FAIL: Other errors
  */
 esp_err_t esp_lcd_panel_st7262_new(const esp_lcd_panel_st7262_config_handle_t conf, esp_lcd_panel_st7262_panel_handle_t out_handle);
@@ -218,9 +352,29 @@ esp_err_t esp_lcd_panel_st7262_init(const esp_lcd_panel_st7262_panel_handle_t pa
  */
 esp_err_t esp_lcd_panel_st7262_mirror(const esp_lcd_panel_st7262_panel_handle_t panel, bool mirror_x, bool mirror_y);
 
+/**
+ * @brief Set the software rotation of the ST7262 LCD panel
+ *
+ * The RGB interface cannot rotate in hardware, so esp_lcd_panel_st7262_draw_bitmap()
+ * rotates every area through an internal RAM scratch buffer and moves it to the
+ * matching panel position. Coordinates passed to draw_bitmap are then in the rotated
+ * (logical) space, which is what LVGL produces with lv_display_set_rotation().
+ * Frame buffers passed to draw_bitmap are never rotated.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param rotation Rotation, same values as lv_display_rotation_t
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NO_MEM: Could not allocate the scratch buffer
+ */
+esp_err_t esp_lcd_panel_st7262_set_rotation(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_rotation_t rotation);
+
 /**
  * @brief Swap the X and Y axes of the ST7262 LCD panel
  *
+ * The RGB panel cannot swap axes in hardware, use esp_lcd_panel_st7262_set_rotation().
+ *
  * @param panel Handle to the ST7262 panel instance
  * @param swap_axes Enable or disable axis swapping
  * @return
@@ -279,6 +433,10 @@ esp_err_t esp_lcd_panel_st7262_disp_on_ff(const esp_lcd_panel_st7262_panel_handl
 /**
  * @brief Draw a bitmap on the ST7262 LCD panel
  *
+ * When color_data is one of the panel's own frame buffers nothing is copied: the area
+ * is written back from the cache and, with several frame buffers, that buffer is
+ * queued to be shown at the next vsync.
+ *
  * @param panel Handle to the ST7262 panel instance
  * @param x_start Starting X coordinate
  * @param y_start Starting Y coordinate
@@ -292,6 +450,67 @@ esp_err_t esp_lcd_panel_st7262_disp_on_ff(const esp_lcd_panel_st7262_panel_handl
  */
 esp_err_t esp_lcd_panel_st7262_draw_bitmap(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end, const void *color_data);
 
+/**
+ * @brief Start the asynchronous draw worker of the ST7262 LCD panel
+ *
+ * The worker takes requests submitted with esp_lcd_panel_st7262_draw_bitmap_async()
+ * from a bounded lock-free ring and draws them in submission order, so the copy into
+ * the PSRAM frame buffer overlaps with whatever the submitting task does next. Pin
+ * the worker to the other core than the submitting task to run both in parallel.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param config Worker configuration, NULL selects ESP_LCD_PANEL_ST7262_ASYNC_DEFAULT_CONFIG()
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_INVALID_STATE: The worker is already running
+ *      - ESP_ERR_NO_MEM: Could not create the queue or the task
+ */
+esp_err_t esp_lcd_panel_st7262_async_start(const esp_lcd_panel_st7262_panel_handle_t panel, const esp_lcd_panel_st7262_async_config_t *config);
+
+/**
+ * @brief Stop the asynchronous draw worker of the ST7262 LCD panel
+ *
+ * Requests already submitted are drawn and their callbacks run before this returns.
+ * Any task can stop the worker, the stop is signalled next to the request ring and
+ * does not use the calling task's notification. It must not run concurrently with
+ * esp_lcd_panel_st7262_draw_bitmap_async().
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_INVALID_STATE: The worker is not running
+ */
+esp_err_t esp_lcd_panel_st7262_async_stop(const esp_lcd_panel_st7262_panel_handle_t panel);
+
+/**
+ * @brief Queue a bitmap to be drawn by the asynchronous draw worker
+ *
+ * Same as esp_lcd_panel_st7262_draw_bitmap(), but returns as soon as the request is
+ * queued. color_data must stay valid until done_cb runs. When the queue is full the
+ * call sleeps for up to timeout_ms, which throttles a producer that outruns the panel.
+ * The worker wakes it as soon as it takes the next request, without using the caller's
+ * task notification. The queue has a single producer: submit from one task at a time.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param x_start Starting X coordinate
+ * @param y_start Starting Y coordinate
+ * @param x_end Ending X coordinate
+ * @param y_end Ending Y coordinate
+ * @param color_data Pointer to the color data for the bitmap
+ * @param done_cb Callback run after the bitmap was drawn, may be NULL
+ * @param user_ctx User context passed to done_cb
+ * @param timeout_ms Time to wait for room in the queue, rounded up to whole ticks.
+ *                   portMAX_DELAY waits forever, 0 returns at once when the queue is full.
+ * @return
+ *      - ESP_OK: Request queued
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_INVALID_STATE: The worker is not running
+ *      - ESP_ERR_TIMEOUT: The queue stayed full
+ */
+esp_err_t esp_lcd_panel_st7262_draw_bitmap_async(const esp_lcd_panel_st7262_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end,
+                                                 const void *color_data, esp_lcd_panel_st7262_draw_done_cb_t done_cb, void *user_ctx, uint32_t timeout_ms);
 
 /**
  * @brief Turn the backlight on or off for the ST7262 LCD panel
@@ -305,4 +524,208 @@ esp_err_t esp_lcd_panel_st7262_draw_bitmap(const esp_lcd_panel_st7262_panel_hand
  */
 esp_err_t esp_lcd_panel_st7262_backlight_on_ff(const esp_lcd_panel_st7262_config_handle_t conf, bool on);
 
+/**
+ * @brief Get the frame buffer to render the next frame into
+ *
+ * Requires a panel created with two or more frame buffers. The returned buffer is
+ * neither scanned out nor queued for scanout, so it can be written without tearing.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param buf Output pointer to the back buffer (width * height RGB565 pixels)
+ * @param timeout_ms Time to wait for a pending swap to finish, 0 returns immediately
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Panel has a single frame buffer
+ *      - ESP_ERR_TIMEOUT: No back buffer became free in time
+ */
+esp_err_t esp_lcd_panel_st7262_get_back_buffer(const esp_lcd_panel_st7262_panel_handle_t panel, void **buf, uint32_t timeout_ms);
+
+/**
+ * @brief Queue the back buffer to be shown at the next vsync and return immediately
+ *
+ * The whole back buffer is written back from the cache before it is queued.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @return
+ *      - ESP_OK: Swap queued
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Panel has a single frame buffer
+ *      - ESP_ERR_INVALID_STATE: A swap is already pending
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t esp_lcd_panel_st7262_flip(const esp_lcd_panel_st7262_panel_handle_t panel);
+
+/**
+ * @brief Queue the back buffer to be shown at the next vsync and wait for the swap
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param timeout_ms Time to wait for the swap to take effect
+ * @return
+ *      - ESP_OK: The back buffer is now scanned out
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Panel has a single frame buffer
+ *      - ESP_ERR_INVALID_STATE: A swap is already pending
+ *      - ESP_ERR_TIMEOUT: The swap did not happen in time
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t esp_lcd_panel_st7262_flip_sync(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t timeout_ms);
+
+/**
+ * @brief Wait until a queued frame buffer swap has taken effect
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param timeout_ms Time to wait for the swap
+ * @return
+ *      - ESP_OK: No swap is pending
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_TIMEOUT: The swap did not happen in time
+ */
+esp_err_t esp_lcd_panel_st7262_wait_flip(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t timeout_ms);
+
+/**
+ * @brief Get the frame buffers scanned out by the ST7262 LCD panel
+ *
+ * Rendering straight into these buffers avoids the copy done by
+ * esp_lcd_panel_st7262_draw_bitmap(). Written areas must be made visible to the
+ * GDMA with esp_lcd_panel_st7262_writeback() or by passing the frame buffer to
+ * esp_lcd_panel_st7262_draw_bitmap().
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param fbs Array of ESP_LCD_PANEL_ST7262_MAX_FBS pointers, unused entries are set to NULL
+ * @param num_fbs Output number of frame buffers
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t esp_lcd_panel_st7262_get_frame_buffers(const esp_lcd_panel_st7262_panel_handle_t panel, void **fbs, uint32_t *num_fbs);
+
+/**
+ * @brief Write an area of a frame buffer back from the data cache to PSRAM
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param fb Frame buffer returned by esp_lcd_panel_st7262_get_frame_buffers()
+ * @param x_start Starting X coordinate
+ * @param y_start Starting Y coordinate
+ * @param x_end Ending X coordinate (exclusive)
+ * @param y_end Ending Y coordinate (exclusive)
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t esp_lcd_panel_st7262_writeback(const esp_lcd_panel_st7262_panel_handle_t panel, const void *fb, int x_start, int y_start, int x_end, int y_end);
+
+/**
+ * @brief Write back every area collected by a dirty-rectangle tracker
+ *
+ * The tracker is coalesced first so overlapping and neighbouring areas are written
+ * back with as few cache operations as possible, then reset for the next frame.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param fb Frame buffer returned by esp_lcd_panel_st7262_get_frame_buffers()
+ * @param dirty Tracker holding the areas of the frame
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t esp_lcd_panel_st7262_writeback_dirty(const esp_lcd_panel_st7262_panel_handle_t panel, const void *fb, esp_lcd_panel_st7262_dirty_t *dirty);
+
+/**
+ * @brief Register a callback run at every vsync of the ST7262 LCD panel
+ *
+ * The vsync marks the start of a new frame, anything written before it is on screen
+ * during that frame.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param cb Callback, NULL to unregister
+ * @param user_ctx User context passed to cb
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t esp_lcd_panel_st7262_register_vsync_cb(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_vsync_cb_t cb, void *user_ctx);
+
+/**
+ * @brief Change the on-demand refresh policy of the ST7262 LCD panel
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param idle_frames Frames still sent after the last change
+ * @param keepalive_ms Refresh interval of an idle panel, 0 stops refreshing
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Panel was not created with refresh_on_demand
+ */
+esp_err_t esp_lcd_panel_st7262_set_refresh_policy(const esp_lcd_panel_st7262_panel_handle_t panel, uint32_t idle_frames, uint32_t keepalive_ms);
+
+/**
+ * @brief Get the counters of the on-demand refresh policy
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param stats Output counters, bytes_saved is the PSRAM traffic avoided by skipped frames
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Panel was not created with refresh_on_demand
+ */
+esp_err_t esp_lcd_panel_st7262_get_refresh_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_refresh_stats_t *stats);
+
+/**
+ * @brief Apply a timing profile to an ST7262 configuration
+ *
+ * Copies the PCLK and porches of the profile, polarities and resolution are kept.
+ *
+ * @param conf Configuration handle for the ST7262 panel
+ * @param profile Profile, e.g. from ESP_LCD_PANEL_ST7262_8048S043_TIMINGS
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t esp_lcd_panel_st7262_set_timing_profile(const esp_lcd_panel_st7262_config_handle_t conf, const esp_lcd_panel_st7262_timing_profile_t *profile);
+
+/**
+ * @brief Get the display path statistics of the ST7262 LCD panel
+ *
+ * Requires CONFIG_ESP_LCD_ST7262_STATS, which sets ESP_LCD_PANEL_ST7262_STATS=1.
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param stats Output statistics
+ * @param reset Clear the statistics after copying them
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NOT_SUPPORTED: Statistics are compiled out
+ */
+esp_err_t esp_lcd_panel_st7262_get_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_stats_t *stats, bool reset);
+
+/**
+ * @brief Write the display path statistics of the ST7262 LCD panel to the log
+ *
+ * @param panel Handle to the ST7262 panel instance
+ * @param format CSV lines or a hex dump of the packed binary form
+ * @param reset Clear the statistics after logging them
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ *      - ESP_ERR_NO_MEM: Could not allocate the output buffer
+ *      - ESP_ERR_NOT_SUPPORTED: Statistics are compiled out
+ */
+esp_err_t esp_lcd_panel_st7262_log_stats(const esp_lcd_panel_st7262_panel_handle_t panel, esp_lcd_panel_st7262_stats_format_t format, bool reset);
+
+/**
+ * @brief Estimate the PSRAM bandwidth needed by the ST7262 configuration
+ *
+ * Runs the bandwidth model for the timing and scanout settings of the configuration
+ * and reports the highest PCLK and frame rate they can sustain.
+ *
+ * @param conf Configuration handle for the ST7262 panel
+ * @param out Bandwidth estimate
+ * @return
+ *      - ESP_OK: Success
+ *      - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t esp_lcd_panel_st7262_bandwidth(const esp_lcd_panel_st7262_config_handle_t conf, esp_lcd_panel_st7262_bandwidth_t *out);
+
 #endif
\ No newline at end of file
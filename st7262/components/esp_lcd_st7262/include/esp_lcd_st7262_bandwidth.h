@@ -0,0 +1,91 @@
+/**
+ * @file esp_lcd_st7262_bandwidth.h
+ * @brief PSRAM bandwidth model for the ST7262 RGB scanout.
+ *
+ * This file only depends on the C standard library so the model can be
+ * compiled and run on the host as well as on the ESP32.
+ */
+
+#ifndef _ESP_LCD_ST7262_BANDWIDTH_H_
+#define _ESP_LCD_ST7262_BANDWIDTH_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Default raw PSRAM throughput in bytes per second (octal DDR @ 80 MHz).
+ */
+#define ESP_LCD_PANEL_ST7262_PSRAM_BYTES_PER_S (160 * 1000 * 1000)
+
+/**
+ * @brief Default share of the PSRAM bandwidth kept free for the CPU, in percent.
+ *
+ * The CPU executes code from PSRAM (CONFIG_SPIRAM_XIP_FROM_PSRAM) so the scanout
+ * can never use the whole bus.
+ */
+#define ESP_LCD_PANEL_ST7262_CPU_RESERVE_PCT 50
+
+/**
+ * @brief Default efficiency of a direct PSRAM -> LCD GDMA stream, in percent.
+ *
+ * Without a bounce buffer the GDMA FIFO has to absorb the full PSRAM access latency,
+ * calibrated so that the 8048S043 tops out around 16 MHz PCLK.
+ */
+#define ESP_LCD_PANEL_ST7262_DIRECT_DMA_EFF_PCT 62
+
+/**
+ * @brief Default efficiency of the CPU copy that fills the bounce buffers, in percent.
+ */
+#define ESP_LCD_PANEL_ST7262_BOUNCE_COPY_EFF_PCT 90
+
+/**
+ * @brief Fixed cost of every PSRAM burst expressed in bytes (command, address and latency).
+ */
+#define ESP_LCD_PANEL_ST7262_PSRAM_BURST_OVERHEAD 32
+
+/**
+ * @brief Input parameters of the bandwidth model.
+ *
+ * Zero values in the tuning fields select the defaults above.
+ */
+typedef struct
+{
+    uint32_t h_res;
+    uint32_t v_res;
+    uint32_t h_blank;             // hsync pulse width + back porch + front porch
+    uint32_t v_blank;             // vsync pulse width + back porch + front porch
+    uint32_t pclk_hz;             // PCLK that is going to be checked
+    uint32_t bytes_per_px;        // 2 for RGB565
+    uint32_t bounce_buffer_lines; // 0 = GDMA reads directly from PSRAM
+    uint32_t dma_burst_size;      // 0 = 64 bytes
+    /* Tuning */
+    uint32_t psram_bytes_per_s;
+    uint32_t cpu_reserve_pct;
+    uint32_t direct_dma_eff_pct;
+    uint32_t bounce_copy_eff_pct;
+} esp_lcd_panel_st7262_bandwidth_params_t;
+
+/**
+ * @brief Result of the bandwidth model.
+ */
+typedef struct
+{
+    uint32_t available_bytes_per_s; // PSRAM bandwidth the scanout can use
+    uint32_t required_bytes_per_s;  // PSRAM bandwidth needed at the requested PCLK
+    uint32_t max_pclk_hz;           // Highest PCLK the selected mode can sustain
+    uint32_t max_fps_x100;          // Frame rate at max_pclk_hz, in 1/100 Hz
+    uint32_t fps_x100;              // Frame rate at the requested PCLK, in 1/100 Hz
+    bool sustainable;               // Requested PCLK fits in the available bandwidth
+} esp_lcd_panel_st7262_bandwidth_t;
+
+/**
+ * @brief Estimate the PSRAM bandwidth budget of a scanout configuration.
+ *
+ * @param params Model input
+ * @param out Model output
+ * @return
+ *      - true: Estimate is valid
+ *      - false: Invalid arguments (NULL pointers, zero resolution or pixel size)
+ */
+bool esp_lcd_panel_st7262_bandwidth_estimate(const esp_lcd_panel_st7262_bandwidth_params_t *params, esp_lcd_panel_st7262_bandwidth_t *out);
+
+#endif
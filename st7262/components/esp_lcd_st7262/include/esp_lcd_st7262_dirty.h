@@ -0,0 +1,103 @@
+/**
+ * @file esp_lcd_st7262_dirty.h
+ * @brief Dirty-rectangle tracker for the ST7262 LCD driver.
+ *
+ * Collects the areas changed during a frame and merges them into the smallest set of
+ * cache-line-aligned rectangles, trading extra bytes against per-call overhead. It has
+ * no ESP-IDF dependencies so traces can be replayed on the host.
+ */
+
+#ifndef _ESP_LCD_ST7262_DIRTY_H_
+#define _ESP_LCD_ST7262_DIRTY_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ESP_LCD_PANEL_ST7262_DIRTY_MAX_RECTS 16
+
+/**
+ * @brief Default cost of one extra copy or cache write-back call, expressed in bytes.
+ */
+#define ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES 256
+
+/**
+ * @brief Rectangle with exclusive end coordinates, like esp_lcd_panel_st7262_draw_bitmap().
+ */
+typedef struct
+{
+    int x_start;
+    int y_start;
+    int x_end;
+    int y_end;
+} esp_lcd_panel_st7262_rect_t;
+
+/**
+ * @brief Dirty-rectangle tracker state.
+ */
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t bytes_per_px;
+    uint32_t align_px;            // Horizontal alignment in pixels, usually one cache line
+    uint32_t call_overhead_bytes; // Cost of one extra rectangle
+    esp_lcd_panel_st7262_rect_t rects[ESP_LCD_PANEL_ST7262_DIRTY_MAX_RECTS];
+    uint32_t count;
+    /* Statistics */
+    uint64_t bytes_added;   // Bytes of the rectangles as they were added
+    uint64_t bytes_emitted; // Bytes of the coalesced rectangles
+    uint32_t rects_added;
+    uint32_t rects_emitted;
+} esp_lcd_panel_st7262_dirty_t;
+
+/**
+ * @brief Initialize a dirty-rectangle tracker.
+ *
+ * @param dirty Tracker state
+ * @param width Frame width in pixels
+ * @param height Frame height in pixels
+ * @param bytes_per_px Bytes per pixel
+ * @param align_px Horizontal alignment in pixels, 0 or 1 disables alignment
+ * @param call_overhead_bytes Cost of an extra rectangle, 0 selects ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES
+ * @return
+ *      - true: Success
+ *      - false: Invalid arguments
+ */
+bool esp_lcd_panel_st7262_dirty_init(esp_lcd_panel_st7262_dirty_t *dirty, uint32_t width, uint32_t height, uint32_t bytes_per_px,
+                                     uint32_t align_px, uint32_t call_overhead_bytes);
+
+/**
+ * @brief Forget the rectangles of the current frame, statistics are kept.
+ *
+ * @param dirty Tracker state
+ */
+void esp_lcd_panel_st7262_dirty_reset(esp_lcd_panel_st7262_dirty_t *dirty);
+
+/**
+ * @brief Add a changed area to the current frame.
+ *
+ * The area is clipped to the frame and aligned. When the tracker is full the area is
+ * merged into the rectangle where it adds the least cost.
+ *
+ * @param dirty Tracker state
+ * @param x_start Starting X coordinate
+ * @param y_start Starting Y coordinate
+ * @param x_end Ending X coordinate (exclusive)
+ * @param y_end Ending Y coordinate (exclusive)
+ * @return
+ *      - true: Area added
+ *      - false: Area is empty after clipping
+ */
+bool esp_lcd_panel_st7262_dirty_add(esp_lcd_panel_st7262_dirty_t *dirty, int x_start, int y_start, int x_end, int y_end);
+
+/**
+ * @brief Merge overlapping and adjacent rectangles while that lowers the total cost.
+ *
+ * Two rectangles are replaced by their bounding box when the bytes it adds are
+ * cheaper than the call it saves. Updates the emitted statistics.
+ *
+ * @param dirty Tracker state
+ * @return Number of rectangles left in dirty->rects
+ */
+uint32_t esp_lcd_panel_st7262_dirty_coalesce(esp_lcd_panel_st7262_dirty_t *dirty);
+
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file esp_lcd_st7262_flip.h
+ * @brief Frame buffer page-flip state machine for the ST7262 LCD driver.
+ *
+ * The state machine only tracks buffer indices and has no ESP-IDF dependencies,
+ * so it can be driven from a host-side mock panel. The driver calls
+ * esp_lcd_panel_st7262_flip_state_vsync() from the vsync interrupt and guards
+ * the state with a spinlock.
+ */
+
+#ifndef _ESP_LCD_ST7262_FLIP_H_
+#define _ESP_LCD_ST7262_FLIP_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ESP_LCD_PANEL_ST7262_MAX_FBS 3
+
+/**
+ * @brief Page-flip state of a panel with one or more frame buffers.
+ */
+typedef struct
+{
+    uint8_t num_fbs;
+    uint8_t front;     // Frame buffer currently scanned out
+    uint8_t queued;    // Frame buffer waiting for the next vsync
+    bool pending;      // A swap is waiting for the next vsync
+    uint32_t flips;    // Number of completed swaps
+} esp_lcd_panel_st7262_flip_state_t;
+
+/**
+ * @brief Reset the page-flip state, frame buffer 0 is scanned out.
+ *
+ * @param state Page-flip state
+ * @param num_fbs Number of frame buffers (1 to ESP_LCD_PANEL_ST7262_MAX_FBS)
+ * @return
+ *      - true: Success
+ *      - false: Invalid number of frame buffers
+ */
+bool esp_lcd_panel_st7262_flip_state_init(esp_lcd_panel_st7262_flip_state_t *state, uint8_t num_fbs);
+
+/**
+ * @brief Get the frame buffer that can be rendered into without tearing.
+ *
+ * @param state Page-flip state
+ * @return Frame buffer index, or -1 when every other buffer is still queued or scanned out
+ */
+int esp_lcd_panel_st7262_flip_state_back(const esp_lcd_panel_st7262_flip_state_t *state);
+
+/**
+ * @brief Queue a frame buffer to become the front buffer at the next vsync.
+ *
+ * @param state Page-flip state
+ * @param index Frame buffer index returned by esp_lcd_panel_st7262_flip_state_back()
+ * @return
+ *      - true: Swap queued
+ *      - false: A swap is already pending or the index is not a back buffer
+ */
+bool esp_lcd_panel_st7262_flip_state_queue(esp_lcd_panel_st7262_flip_state_t *state, uint8_t index);
+
+/**
+ * @brief Advance the state machine on vsync.
+ *
+ * @param state Page-flip state
+ * @return
+ *      - true: The queued buffer became the front buffer
+ *      - false: Nothing was pending
+ */
+bool esp_lcd_panel_st7262_flip_state_vsync(esp_lcd_panel_st7262_flip_state_t *state);
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * @file esp_lcd_st7262_lv_blend.h
+ * @brief LVGL software renderer hooks backed by the ST7262 pixel kernels.
+ *
+ * Select it with CONFIG_LV_DRAW_SW_ASM_CUSTOM=y and
+ * CONFIG_LV_DRAW_SW_ASM_CUSTOM_INCLUDE="esp_lcd_st7262_lv_blend.h". LVGL includes
+ * this file from its RGB565 blend routines and falls back to its own code for every
+ * case that is not defined here (masks, other colour formats).
+ */
+
+#ifndef _ESP_LCD_ST7262_LV_BLEND_H_
+#define _ESP_LCD_ST7262_LV_BLEND_H_
+#include "esp_lcd_st7262_pixel.h"
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                                                            \
+    (esp_lcd_panel_st7262_pixel_fill((uint16_t *)(dsc)->dest_buf, (dsc)->dest_stride, (dsc)->dest_w, \
+                                     (dsc)->dest_h, lv_color_to_u16((dsc)->color)),                  \
+     LV_RESULT_OK)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                                                          \
+    (esp_lcd_panel_st7262_pixel_blend_colour((uint16_t *)(dsc)->dest_buf, (dsc)->dest_stride, (dsc)->dest_w, \
+                                             (dsc)->dest_h, lv_color_to_u16((dsc)->color), (dsc)->opa),      \
+     LV_RESULT_OK)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565(dsc)                                                    \
+    (esp_lcd_panel_st7262_pixel_copy((uint16_t *)(dsc)->dest_buf, (dsc)->dest_stride,                \
+                                     (const uint16_t *)(dsc)->src_buf, (dsc)->src_stride,            \
+                                     (dsc)->dest_w, (dsc)->dest_h),                                  \
+     LV_RESULT_OK)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)                                           \
+    (esp_lcd_panel_st7262_pixel_blend((uint16_t *)(dsc)->dest_buf, (dsc)->dest_stride,               \
+                                      (const uint16_t *)(dsc)->src_buf, (dsc)->src_stride,           \
+                                      (dsc)->dest_w, (dsc)->dest_h, (dsc)->opa),                     \
+     LV_RESULT_OK)
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file esp_lcd_st7262_pixel.h
+ * @brief RGB565 pixel kernels for the ST7262 LCD driver.
+ *
+ * Every kernel has a portable SWAR implementation (the *_swar functions), the
+ * functions without suffix pick the fastest path for the target. On the ESP32-S3
+ * fill and copy use the PIE 128-bit vector instructions for the aligned middle of
+ * each row; define ESP_LCD_PANEL_ST7262_PIXEL_PIE to 0 to build the SWAR path only.
+ * On other targets ESP_LCD_PANEL_ST7262_PIXEL_PIE=1 builds the same row split
+ * around plain C block moves, so host tests can check it against the SWAR path.
+ *
+ * The other kernels have no PIE path:
+ * - blend and blend_colour blend the three channels of a pixel with one 32-bit
+ *   multiply. PIE only multiplies 8 or 16-bit lanes, so a vector version has to
+ *   unpack every pixel into three channel vectors and pack them again. That is not
+ *   done until it can be measured and checked bit-exact on the target.
+ * - swap_rb and swap_bytes are single in-place passes that already move two pixels
+ *   per load and store. They are bound by memory, and nothing in the LVGL flush path
+ *   calls them.
+ *
+ * Strides are in bytes, like LVGL draw buffers.
+ */
+
+#ifndef _ESP_LCD_ST7262_PIXEL_H_
+#define _ESP_LCD_ST7262_PIXEL_H_
+#include <stdint.h>
+
+#ifdef ESP_PLATFORM
+#include <sdkconfig.h>
+#endif
+
+#ifndef ESP_LCD_PANEL_ST7262_PIXEL_PIE
+#if defined(CONFIG_IDF_TARGET_ESP32S3) && CONFIG_IDF_TARGET_ESP32S3
+#define ESP_LCD_PANEL_ST7262_PIXEL_PIE 1
+#else
+#define ESP_LCD_PANEL_ST7262_PIXEL_PIE 0
+#endif
+#endif
+
+/**
+ * @brief Fill a rectangle with a solid colour.
+ *
+ * @param dst First pixel of the rectangle
+ * @param dst_stride Bytes between two rows of dst
+ * @param w Width in pixels
+ * @param h Height in pixels
+ * @param colour RGB565 colour
+ */
+void esp_lcd_panel_st7262_pixel_fill(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t colour);
+void esp_lcd_panel_st7262_pixel_fill_swar(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t colour);
+
+/**
+ * @brief Copy a rectangle of pixels.
+ *
+ * @param dst First destination pixel
+ * @param dst_stride Bytes between two rows of dst
+ * @param src First source pixel
+ * @param src_stride Bytes between two rows of src
+ * @param w Width in pixels
+ * @param h Height in pixels
+ */
+void esp_lcd_panel_st7262_pixel_copy(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h);
+void esp_lcd_panel_st7262_pixel_copy_swar(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h);
+
+/**
+ * @brief Blend a rectangle of pixels over the destination with a constant alpha.
+ *
+ * The alpha is rounded to 5 bits, 255 copies the source and 0 keeps the destination.
+ *
+ * @param dst First destination pixel
+ * @param dst_stride Bytes between two rows of dst
+ * @param src First source pixel
+ * @param src_stride Bytes between two rows of src
+ * @param w Width in pixels
+ * @param h Height in pixels
+ * @param opa Source opacity, 0 to 255
+ */
+void esp_lcd_panel_st7262_pixel_blend(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint8_t opa);
+void esp_lcd_panel_st7262_pixel_blend_swar(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint8_t opa);
+
+/**
+ * @brief Blend a solid colour over a rectangle with a constant alpha.
+ *
+ * @param dst First destination pixel
+ * @param dst_stride Bytes between two rows of dst
+ * @param w Width in pixels
+ * @param h Height in pixels
+ * @param colour RGB565 colour
+ * @param opa Colour opacity, 0 to 255
+ */
+void esp_lcd_panel_st7262_pixel_blend_colour(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t colour, uint8_t opa);
+void esp_lcd_panel_st7262_pixel_blend_colour_swar(uint16_t *dst, uint32_t dst_stride, uint32_t w, uint32_t h, uint16_t colour, uint8_t opa);
+
+/**
+ * @brief Swap the red and blue channels of RGB565 pixels in place (RGB565 <-> BGR565).
+ *
+ * @param buf Pixels
+ * @param count Number of pixels
+ */
+void esp_lcd_panel_st7262_pixel_swap_rb(uint16_t *buf, uint32_t count);
+void esp_lcd_panel_st7262_pixel_swap_rb_swar(uint16_t *buf, uint32_t count);
+
+/**
+ * @brief Swap the two bytes of RGB565 pixels in place.
+ *
+ * @param buf Pixels
+ * @param count Number of pixels
+ */
+void esp_lcd_panel_st7262_pixel_swap_bytes(uint16_t *buf, uint32_t count);
+void esp_lcd_panel_st7262_pixel_swap_bytes_swar(uint16_t *buf, uint32_t count);
+
+#endif
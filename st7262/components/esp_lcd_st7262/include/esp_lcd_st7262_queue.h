@@ -0,0 +1,139 @@
+/**
+ * @file esp_lcd_st7262_queue.h
+ * @brief Bounded single-producer single-consumer ring for the ST7262 draw worker.
+ *
+ * Hands fixed-size requests from one submitting task to the worker without locks.
+ * The ring only tracks indices and flags; sleeping and waking are left to the caller
+ * (task notifications in the driver), so it has no ESP-IDF dependencies and can be
+ * driven by threads on the host.
+ */
+
+#ifndef _ESP_LCD_ST7262_QUEUE_H_
+#define _ESP_LCD_ST7262_QUEUE_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Request ring state.
+ */
+typedef struct
+{
+    uint8_t *slots;
+    uint32_t depth;
+    uint32_t slot_size;
+    uint32_t head;             // Written by the producer
+    uint32_t tail;             // Written by the consumer
+    uint32_t consumer_waiting; // The consumer sleeps until it is woken
+    uint32_t producer_waiting; // The producer sleeps on a full ring until it is woken
+    uint32_t stop;             // Set once by esp_lcd_panel_st7262_queue_stop()
+} esp_lcd_panel_st7262_queue_t;
+
+/**
+ * @brief Initialize a request ring.
+ *
+ * @param queue Ring state
+ * @param slots Storage for depth * slot_size bytes
+ * @param depth Number of requests that can wait
+ * @param slot_size Size of one request in bytes
+ * @return
+ *      - true: Success
+ *      - false: Invalid arguments
+ */
+bool esp_lcd_panel_st7262_queue_init(esp_lcd_panel_st7262_queue_t *queue, void *slots, uint32_t depth, uint32_t slot_size);
+
+/**
+ * @brief Append a request, producer only.
+ *
+ * Call esp_lcd_panel_st7262_queue_wake_consumer() afterwards.
+ *
+ * @param queue Ring state
+ * @param request Request to copy into the ring
+ * @return
+ *      - true: Request queued
+ *      - false: The ring is full
+ */
+bool esp_lcd_panel_st7262_queue_push(esp_lcd_panel_st7262_queue_t *queue, const void *request);
+
+/**
+ * @brief Take the oldest request, consumer only.
+ *
+ * @param queue Ring state
+ * @param request Receives the request
+ * @return
+ *      - true: A request was taken
+ *      - false: The ring is empty
+ */
+bool esp_lcd_panel_st7262_queue_pop(esp_lcd_panel_st7262_queue_t *queue, void *request);
+
+/**
+ * @brief Check whether the consumer has to be woken after a push or a stop.
+ *
+ * @param queue Ring state
+ * @return true when the consumer announced a wait, the caller must wake it once
+ */
+bool esp_lcd_panel_st7262_queue_wake_consumer(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief Announce that the consumer is about to sleep, consumer only.
+ *
+ * Checks the ring again after the announcement, so a push or stop in between is not
+ * missed. Call esp_lcd_panel_st7262_queue_end_wait() once awake or when this
+ * returns false.
+ *
+ * @param queue Ring state
+ * @return true when the ring is still empty and no stop is requested, the consumer may sleep
+ */
+bool esp_lcd_panel_st7262_queue_prepare_wait(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief End the wait announced with esp_lcd_panel_st7262_queue_prepare_wait().
+ *
+ * @param queue Ring state
+ */
+void esp_lcd_panel_st7262_queue_end_wait(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief Check whether the producer has to be woken after a pop, consumer only.
+ *
+ * @param queue Ring state
+ * @return true when the producer announced a wait, the caller must wake it once
+ */
+bool esp_lcd_panel_st7262_queue_wake_producer(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief Announce that the producer is about to sleep on a full ring, producer only.
+ *
+ * Checks the ring again after the announcement, so a pop in between is not missed.
+ * Call esp_lcd_panel_st7262_queue_end_push_wait() once awake or when this returns false.
+ *
+ * @param queue Ring state
+ * @return true when the ring is still full, the producer may sleep
+ */
+bool esp_lcd_panel_st7262_queue_prepare_push_wait(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief End the wait announced with esp_lcd_panel_st7262_queue_prepare_push_wait().
+ *
+ * @param queue Ring state
+ */
+void esp_lcd_panel_st7262_queue_end_push_wait(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief Ask the consumer to stop once the ring is drained, from any task.
+ *
+ * Does not touch the ring slots. Call esp_lcd_panel_st7262_queue_wake_consumer() afterwards.
+ *
+ * @param queue Ring state
+ */
+void esp_lcd_panel_st7262_queue_stop(esp_lcd_panel_st7262_queue_t *queue);
+
+/**
+ * @brief Check whether the consumer should exit, consumer only.
+ *
+ * @param queue Ring state
+ * @return true when a stop was requested and every request before it was taken
+ */
+bool esp_lcd_panel_st7262_queue_stopped(esp_lcd_panel_st7262_queue_t *queue);
+
+#endif
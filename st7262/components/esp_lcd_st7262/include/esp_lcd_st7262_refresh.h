@@ -0,0 +1,102 @@
+/**
+ * @file esp_lcd_st7262_refresh.h
+ * @brief On-demand refresh policy for the ST7262 LCD driver.
+ *
+ * Decides once per tick whether the panel has to be refreshed. While the
+ * content changes every frame is sent, after a number of idle frames only keep-alive
+ * refreshes are sent. The policy has no ESP-IDF dependencies; the driver calls
+ * esp_lcd_panel_st7262_refresh_tick() from a frame-rate timer and
+ * esp_lcd_panel_st7262_refresh_done() from the vsync interrupt.
+ */
+
+#ifndef _ESP_LCD_ST7262_REFRESH_H_
+#define _ESP_LCD_ST7262_REFRESH_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Frame periods after which a refresh without vsync is considered lost.
+ */
+#define ESP_LCD_PANEL_ST7262_REFRESH_STALL_FRAMES 4
+
+/**
+ * @brief Margin added to the frame period between two policy ticks, in percent.
+ *
+ * A refresh is only started after the vsync of the previous one. A tick that fires
+ * exactly one frame period later can beat that vsync by its jitter and defer the
+ * refresh by a whole period, the margin keeps the tick behind it.
+ */
+#define ESP_LCD_PANEL_ST7262_REFRESH_MARGIN_PCT 10
+
+/**
+ * @brief Counters of the on-demand refresh policy.
+ */
+typedef struct
+{
+    uint32_t refreshed;   // Frames sent to the panel
+    uint32_t skipped;     // Frame periods without a refresh
+    uint32_t deferred;    // Refreshes delayed because the previous frame was still being sent
+    uint64_t bytes_saved; // PSRAM bytes not read because of skipped ticks, one frame per tick
+} esp_lcd_panel_st7262_refresh_stats_t;
+
+/**
+ * @brief On-demand refresh policy state.
+ */
+typedef struct
+{
+    uint32_t frame_bytes;      // Bytes read from PSRAM by one refresh
+    uint32_t idle_frames;      // Frames refreshed after the last change before refreshing stops
+    uint32_t keepalive_frames; // Frames between keep-alive refreshes while idle, 0 never refreshes
+    uint32_t idle_count;       // Frames refreshed since the last change
+    uint32_t since_refresh;    // Frame periods since the last refresh
+    bool dirty;                // Content changed since the last refresh
+    bool in_flight;            // A refresh has been started and its vsync has not arrived
+    esp_lcd_panel_st7262_refresh_stats_t stats;
+} esp_lcd_panel_st7262_refresh_t;
+
+/**
+ * @brief Get the interval between two policy ticks.
+ *
+ * @param frame_period_us Time to send one frame
+ * @return Frame period plus ESP_LCD_PANEL_ST7262_REFRESH_MARGIN_PCT
+ */
+uint32_t esp_lcd_panel_st7262_refresh_period_us(uint32_t frame_period_us);
+
+/**
+ * @brief Initialize the refresh policy, the first tick refreshes.
+ *
+ * @param state Policy state
+ * @param frame_bytes Bytes read from PSRAM by one refresh
+ * @param idle_frames Frames to keep refreshing after the last change
+ * @param keepalive_frames Frames between keep-alive refreshes while idle, 0 disables them
+ * @return
+ *      - true: Success
+ *      - false: Invalid arguments
+ */
+bool esp_lcd_panel_st7262_refresh_init(esp_lcd_panel_st7262_refresh_t *state, uint32_t frame_bytes, uint32_t idle_frames, uint32_t keepalive_frames);
+
+/**
+ * @brief Record that the frame buffer content changed.
+ *
+ * @param state Policy state
+ */
+void esp_lcd_panel_st7262_refresh_mark_dirty(esp_lcd_panel_st7262_refresh_t *state);
+
+/**
+ * @brief Advance the policy by one frame period.
+ *
+ * @param state Policy state
+ * @return
+ *      - true: Start a refresh now
+ *      - false: Skip this frame period
+ */
+bool esp_lcd_panel_st7262_refresh_tick(esp_lcd_panel_st7262_refresh_t *state);
+
+/**
+ * @brief Record that the frame started by the last refresh has been sent.
+ *
+ * @param state Policy state
+ */
+void esp_lcd_panel_st7262_refresh_done(esp_lcd_panel_st7262_refresh_t *state);
+
+#endif
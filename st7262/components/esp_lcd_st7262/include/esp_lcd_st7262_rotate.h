@@ -0,0 +1,61 @@
+/**
+ * @file esp_lcd_st7262_rotate.h
+ * @brief Software rotation of RGB565 areas for the ST7262 LCD driver.
+ *
+ * The RGB interface cannot swap axes in hardware, so rotated output is produced by
+ * rotating every area before it is copied into the frame buffer. Rotations follow
+ * LVGL's lv_display_rotation_t, so the enum values can be passed through directly.
+ * No ESP-IDF dependencies, strides are in bytes.
+ */
+
+#ifndef _ESP_LCD_ST7262_ROTATE_H_
+#define _ESP_LCD_ST7262_ROTATE_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Tile edge in pixels, 16 RGB565 pixels fill one 32-byte cache line.
+ */
+#define ESP_LCD_PANEL_ST7262_ROTATE_TILE 16
+
+typedef enum
+{
+    ESP_LCD_PANEL_ST7262_ROTATION_0 = 0,
+    ESP_LCD_PANEL_ST7262_ROTATION_90,
+    ESP_LCD_PANEL_ST7262_ROTATION_180,
+    ESP_LCD_PANEL_ST7262_ROTATION_270,
+} esp_lcd_panel_st7262_rotation_t;
+
+/**
+ * @brief Rotate a block of RGB565 pixels.
+ *
+ * 90 and 270 degrees are done as a tiled transpose so both the reads and the writes
+ * stay within a few cache lines. The destination is h x w pixels for 90 and 270
+ * degrees and w x h pixels otherwise.
+ *
+ * @param src First source pixel
+ * @param src_stride Bytes between two rows of src
+ * @param w Source width in pixels
+ * @param h Source height in pixels
+ * @param dst First destination pixel, must not overlap src
+ * @param dst_stride Bytes between two rows of dst
+ * @param rotation Rotation to apply
+ */
+void esp_lcd_panel_st7262_rotate_rgb565(const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h,
+                                        uint16_t *dst, uint32_t dst_stride, esp_lcd_panel_st7262_rotation_t rotation);
+
+/**
+ * @brief Map a rotated (logical) area onto the panel.
+ *
+ * @param width Panel width in pixels, before rotation
+ * @param height Panel height in pixels, before rotation
+ * @param rotation Rotation applied to the area
+ * @param x_start In: logical starting X coordinate, out: panel starting X coordinate
+ * @param y_start In: logical starting Y coordinate, out: panel starting Y coordinate
+ * @param x_end In: logical ending X coordinate (exclusive), out: panel ending X coordinate
+ * @param y_end In: logical ending Y coordinate (exclusive), out: panel ending Y coordinate
+ */
+void esp_lcd_panel_st7262_rotate_area(uint32_t width, uint32_t height, esp_lcd_panel_st7262_rotation_t rotation,
+                                      int *x_start, int *y_start, int *x_end, int *y_end);
+
+#endif
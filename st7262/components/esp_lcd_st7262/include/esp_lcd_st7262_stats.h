@@ -0,0 +1,114 @@
+/**
+ * @file esp_lcd_st7262_stats.h
+ * @brief Frame-time and flush-latency histograms for the ST7262 LCD driver.
+ *
+ * Histograms use power-of-two buckets updated with relaxed atomics, so recording from
+ * the vsync interrupt and from any task costs a few instructions and never locks.
+ * The driver only records when ESP_LCD_PANEL_ST7262_STATS is 1, which CONFIG_ESP_LCD_ST7262_STATS
+ * sets for the component and its users; with the default of 0 the recording macros expand
+ * to nothing. This file has no ESP-IDF dependencies.
+ */
+
+#ifndef _ESP_LCD_ST7262_STATS_H_
+#define _ESP_LCD_ST7262_STATS_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef ESP_LCD_PANEL_ST7262_STATS
+#define ESP_LCD_PANEL_ST7262_STATS 0
+#endif
+
+/**
+ * @brief Buckets per histogram. Bucket 0 counts zeros, bucket i counts values in
+ * [2^(i-1), 2^i) and the last bucket also counts everything above.
+ */
+#define ESP_LCD_PANEL_ST7262_HIST_BUCKETS 24
+
+#if ESP_LCD_PANEL_ST7262_STATS
+#define ESP_LCD_PANEL_ST7262_STATS_RECORD(hist, value) esp_lcd_panel_st7262_histogram_record((hist), (value))
+#define ESP_LCD_PANEL_ST7262_STATS_ADD(counter, value) __atomic_fetch_add((counter), (value), __ATOMIC_RELAXED)
+#else
+#define ESP_LCD_PANEL_ST7262_STATS_RECORD(hist, value) ((void)0)
+#define ESP_LCD_PANEL_ST7262_STATS_ADD(counter, value) ((void)0)
+#endif
+
+/**
+ * @brief Log2 histogram.
+ */
+typedef struct
+{
+    uint32_t buckets[ESP_LCD_PANEL_ST7262_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max;
+} esp_lcd_panel_st7262_histogram_t;
+
+/**
+ * @brief Display path statistics.
+ */
+typedef struct
+{
+    esp_lcd_panel_st7262_histogram_t vsync_interval_us; // Time between two vsync interrupts
+    esp_lcd_panel_st7262_histogram_t draw_bytes;        // Bytes per draw_bitmap call
+    esp_lcd_panel_st7262_histogram_t draw_us;           // Duration of a draw_bitmap call
+    uint32_t missed_vsyncs;                             // Frames whose vsync came later than 1.5 frame periods
+} esp_lcd_panel_st7262_stats_t;
+
+/**
+ * @brief Add a value to a histogram, safe from interrupts and concurrent tasks.
+ *
+ * @param hist Histogram
+ * @param value Value to add
+ */
+void esp_lcd_panel_st7262_histogram_record(esp_lcd_panel_st7262_histogram_t *hist, uint32_t value);
+
+/**
+ * @brief Estimate a percentile from the buckets, returns the upper bound of the bucket.
+ *
+ * @param hist Histogram
+ * @param pct Percentile, 0 to 100
+ * @return Upper bound of the bucket holding the percentile, 0 for an empty histogram
+ */
+uint32_t esp_lcd_panel_st7262_histogram_percentile(const esp_lcd_panel_st7262_histogram_t *hist, uint32_t pct);
+
+/**
+ * @brief Copy the statistics and reset them.
+ *
+ * Values recorded while copying land either in the copy or in the cleared statistics.
+ *
+ * @param stats Statistics
+ * @param out Copy, may be NULL to only reset
+ */
+void esp_lcd_panel_st7262_stats_take(esp_lcd_panel_st7262_stats_t *stats, esp_lcd_panel_st7262_stats_t *out);
+
+/**
+ * @brief Format the statistics as CSV, one line per histogram.
+ *
+ * Each line is "name,count,max,bucket0,...,bucketN". A final line holds "missed_vsyncs,N".
+ *
+ * @param stats Statistics
+ * @param buf Output buffer
+ * @param len Size of buf
+ * @return Characters written without the terminating zero, or the size needed when buf is too small
+ */
+size_t esp_lcd_panel_st7262_stats_csv(const esp_lcd_panel_st7262_stats_t *stats, char *buf, size_t len);
+
+/**
+ * @brief Pack the statistics as little-endian 32-bit words.
+ *
+ * Layout: version, bucket count, then per histogram (vsync interval, draw bytes,
+ * draw time) count, max and buckets, then missed vsyncs.
+ *
+ * @param stats Statistics
+ * @param buf Output buffer
+ * @param len Size of buf
+ * @return Bytes written, 0 when buf is too small
+ */
+size_t esp_lcd_panel_st7262_stats_pack(const esp_lcd_panel_st7262_stats_t *stats, uint8_t *buf, size_t len);
+
+/**
+ * @brief Size of the buffer needed by esp_lcd_panel_st7262_stats_pack().
+ */
+#define ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE ((2 + 3 * (2 + ESP_LCD_PANEL_ST7262_HIST_BUCKETS) + 1) * sizeof(uint32_t))
+
+#endif
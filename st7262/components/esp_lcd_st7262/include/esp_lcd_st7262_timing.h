@@ -0,0 +1,133 @@
+/**
+ * @file esp_lcd_st7262_timing.h
+ * @brief Timing profiles and timing calculator for the ST7262 LCD driver.
+ *
+ * A profile names a PCLK and porch setting of a panel. The calculator derives the
+ * refresh rate, line time and PSRAM bandwidth of a profile for a scanout mode and
+ * the validator rejects profiles that mode cannot sustain. Like the bandwidth model
+ * this file only depends on the C standard library.
+ */
+
+#ifndef _ESP_LCD_ST7262_TIMING_H_
+#define _ESP_LCD_ST7262_TIMING_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_lcd_st7262_bandwidth.h"
+
+/**
+ * @brief Named PCLK and porch setting of a panel.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t pclk_hz;
+    uint32_t hsync_pulse_width;
+    uint32_t hsync_back_porch;
+    uint32_t hsync_front_porch;
+    uint32_t vsync_pulse_width;
+    uint32_t vsync_back_porch;
+    uint32_t vsync_front_porch;
+} esp_lcd_panel_st7262_timing_profile_t;
+
+/**
+ * @brief Scanout mode a profile is checked against.
+ */
+typedef struct
+{
+    uint32_t h_res;
+    uint32_t v_res;
+    uint32_t bytes_per_px;
+    uint32_t bounce_buffer_lines; // 0 = GDMA reads directly from PSRAM
+    uint32_t dma_burst_size;      // 0 = 64 bytes
+} esp_lcd_panel_st7262_timing_mode_t;
+
+/**
+ * @brief Figures derived from a profile.
+ */
+typedef struct
+{
+    uint32_t h_total;        // Pixel clocks per line, blanking included
+    uint32_t v_total;        // Lines per frame, blanking included
+    uint32_t line_time_ns;   // Duration of one line
+    uint32_t frame_time_us;  // Duration of one frame
+    uint32_t fps_x100;       // Refresh rate, in 1/100 Hz
+    uint32_t headroom_pct;   // PCLK still available before the bandwidth limit, 0 when over it
+    esp_lcd_panel_st7262_bandwidth_t bandwidth;
+} esp_lcd_panel_st7262_timing_result_t;
+
+/**
+ * @brief Outcome of esp_lcd_panel_st7262_timing_validate().
+ */
+typedef enum
+{
+    ESP_LCD_PANEL_ST7262_TIMING_OK = 0,
+    ESP_LCD_PANEL_ST7262_TIMING_INVALID,       // Zero PCLK, resolution or sync pulse
+    ESP_LCD_PANEL_ST7262_TIMING_UNSUSTAINABLE, // PCLK exceeds the PSRAM bandwidth of the mode
+} esp_lcd_panel_st7262_timing_status_t;
+
+/**
+ * @brief Timing profiles of the 8048S043 (800x480), slowest first.
+ *
+ * "16MHZ" is the default of ESP_LCD_PANEL_ST7262_8048S043. "21MHZ" needs bounce buffers.
+ */
+static const esp_lcd_panel_st7262_timing_profile_t ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[] =
+{
+    {
+        .name = "12MHZ",
+        .pclk_hz = 12 * 1000 * 1000,
+        .hsync_pulse_width = 4, .hsync_back_porch = 8, .hsync_front_porch = 8,
+        .vsync_pulse_width = 4, .vsync_back_porch = 8, .vsync_front_porch = 8,
+    },
+    {
+        .name = "16MHZ",
+        .pclk_hz = 16 * 1000 * 1000,
+        .hsync_pulse_width = 4, .hsync_back_porch = 8, .hsync_front_porch = 8,
+        .vsync_pulse_width = 4, .vsync_back_porch = 8, .vsync_front_porch = 8,
+    },
+    {
+        .name = "21MHZ",
+        .pclk_hz = 21 * 1000 * 1000,
+        .hsync_pulse_width = 4, .hsync_back_porch = 8, .hsync_front_porch = 8,
+        .vsync_pulse_width = 4, .vsync_back_porch = 8, .vsync_front_porch = 8,
+    },
+};
+
+#define ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT (sizeof(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS) / sizeof(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[0]))
+
+/**
+ * @brief Find a profile by name.
+ *
+ * @param profiles Profile table
+ * @param count Number of profiles in the table
+ * @param name Profile name
+ * @return Matching profile, or NULL
+ */
+const esp_lcd_panel_st7262_timing_profile_t *esp_lcd_panel_st7262_timing_find(const esp_lcd_panel_st7262_timing_profile_t *profiles, uint32_t count,
+                                                                            const char *name);
+
+/**
+ * @brief Calculate refresh rate, line time and PSRAM bandwidth of a profile.
+ *
+ * @param mode Scanout mode
+ * @param profile Timing profile
+ * @param out Derived figures
+ * @return
+ *      - true: Success
+ *      - false: Invalid arguments (NULL pointers, zero resolution, pixel size or PCLK)
+ */
+bool esp_lcd_panel_st7262_timing_calc(const esp_lcd_panel_st7262_timing_mode_t *mode, const esp_lcd_panel_st7262_timing_profile_t *profile,
+                                      esp_lcd_panel_st7262_timing_result_t *out);
+
+/**
+ * @brief Check that a profile can be used with a scanout mode.
+ *
+ * @param mode Scanout mode
+ * @param profile Timing profile
+ * @param out Derived figures, may be NULL
+ * @return ESP_LCD_PANEL_ST7262_TIMING_OK when the mode sustains the profile
+ */
+esp_lcd_panel_st7262_timing_status_t esp_lcd_panel_st7262_timing_validate(const esp_lcd_panel_st7262_timing_mode_t *mode,
+                                                                          const esp_lcd_panel_st7262_timing_profile_t *profile,
+                                                                          esp_lcd_panel_st7262_timing_result_t *out);
+
+#endif
@@ -1,9 +1,14 @@
 #include "gt911.h"
+#include <stdio.h>
+#include <string.h>
 #include <esp_log.h>
 #include <driver/gpio.h>
 #include <rom/gpio.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_timer.h>
+#include <nvs.h>
 
 #define TAG "GT911"
 
@@ -28,172 +33,276 @@ static void gt911_safe_set_pin_level(uint8_t pin, uint8_t level)
     }
 }
 
-// Helper functions for I2C communication
-static esp_err_t gt911_i2c_init(i2c_port_t i2c_port, uint8_t sda, uint8_t scl)
+// I2C transport on the i2c_master driver, the handles persist so no transaction allocates
+static esp_err_t gt911_i2c_read(void *ctx, uint16_t reg, uint8_t *buf, size_t len, uint32_t timeout_ms)
 {
-    i2c_config_t conf = {
-        .mode = I2C_MODE_MASTER,
+    gt911_handle_t *dev = (gt911_handle_t *)ctx;
+    uint8_t addr[2] = {(reg >> 8) & 0xFF, reg & 0xFF};
+
+    // Register address and data in one transaction with a repeated start
+    return i2c_master_transmit_receive(dev->i2c_dev, addr, sizeof(addr), buf, len, timeout_ms);
+}
+
+static esp_err_t gt911_i2c_write(void *ctx, uint16_t reg, const uint8_t *buf, size_t len, uint32_t timeout_ms)
+{
+    gt911_handle_t *dev = (gt911_handle_t *)ctx;
+    uint8_t buffer[2 + GT911_MAX_WRITE];
+
+    if (len > GT911_MAX_WRITE)
+    {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    buffer[0] = (reg >> 8) & 0xFF; // Register address high byte
+    buffer[1] = reg & 0xFF;        // Register address low byte
+    memcpy(buffer + 2, buf, len);
+
+    return i2c_master_transmit(dev->i2c_dev, buffer, 2 + len, timeout_ms);
+}
+
+static esp_err_t gt911_i2c_recover(void *ctx)
+{
+    gt911_handle_t *dev = (gt911_handle_t *)ctx;
+
+    // Clocks SCL until a slave holding SDA low lets go, then resets the I2C controller
+    return i2c_master_bus_reset(dev->i2c_bus);
+}
+
+static esp_err_t gt911_i2c_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl)
+{
+    i2c_master_bus_config_t bus_config = {
+        .i2c_port = dev->i2c_port,
         .sda_io_num = sda,
         .scl_io_num = scl,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .master.clk_speed = I2C_MASTER_FREQ_HZ};
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = true,
+    };
 
-    esp_err_t ret = i2c_param_config(i2c_port, &conf);
+    esp_err_t ret = i2c_new_master_bus(&bus_config, &dev->i2c_bus);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "I2C parameter configuration failed");
+        ESP_LOGE(TAG, "I2C bus creation failed");
         return ret;
     }
 
-    ret = i2c_driver_install(i2c_port, I2C_MODE_MASTER,
-                             I2C_MASTER_RX_BUF_DISABLE,
-                             I2C_MASTER_TX_BUF_DISABLE, 0);
+    i2c_device_config_t dev_config = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = dev->addr,
+        .scl_speed_hz = I2C_MASTER_FREQ_HZ,
+    };
+
+    ret = i2c_master_bus_add_device(dev->i2c_bus, &dev_config, &dev->i2c_dev);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "I2C driver installation failed");
+        ESP_LOGE(TAG, "I2C device creation failed");
+        i2c_del_master_bus(dev->i2c_bus);
+        dev->i2c_bus = NULL;
         return ret;
     }
 
+    dev->transport = (gt911_transport_t){
+        .read = gt911_i2c_read,
+        .write = gt911_i2c_write,
+        .recover = gt911_i2c_recover,
+        .ctx = dev,
+    };
+
     return ESP_OK;
 }
 
-static esp_err_t gt911_write_byte(gt911_handle_t *dev, uint16_t reg, uint8_t val)
+// Deadline of a transfer: the fixed budget plus 9 bit times per byte, address included
+static uint32_t gt911_io_timeout_ms(size_t len)
 {
-    esp_err_t ret;
-    uint8_t buffer[3];
+    return GT911_IO_TIMEOUT_MS + (uint32_t)(((2 + len) * 9 * 1000 + I2C_MASTER_FREQ_HZ - 1) / I2C_MASTER_FREQ_HZ);
+}
 
-    buffer[0] = (reg >> 8) & 0xFF; // Register address high byte
-    buffer[1] = reg & 0xFF;        // Register address low byte
-    buffer[2] = val;               // Value to write
+static esp_err_t gt911_io(gt911_handle_t *dev, uint16_t reg, uint8_t *read_buf, const uint8_t *write_buf, size_t len)
+{
+    esp_err_t ret = ESP_FAIL;
+    uint32_t timeout_ms = gt911_io_timeout_ms(len);
+
+    for (uint32_t attempt = 0; attempt <= GT911_IO_RETRIES; attempt++)
+    {
+        if (attempt > 0)
+        {
+            __atomic_fetch_add(&dev->io_stats.retries, 1, __ATOMIC_RELAXED);
+        }
 
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(cmd, buffer, 3, true);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+        __atomic_fetch_add(&dev->io_stats.transfers, 1, __ATOMIC_RELAXED);
+        ret = read_buf != NULL ? dev->transport.read(dev->transport.ctx, reg, read_buf, len, timeout_ms)
+                               : dev->transport.write(dev->transport.ctx, reg, write_buf, len, timeout_ms);
+        if (ret == ESP_OK || ret == ESP_ERR_INVALID_ARG || ret == ESP_ERR_INVALID_SIZE)
+        {
+            return ret;
+        }
+
+        if (ret == ESP_ERR_TIMEOUT)
+        {
+            __atomic_fetch_add(&dev->io_stats.timeouts, 1, __ATOMIC_RELAXED);
+        }
 
+        // A timeout or bus error can leave SDA held low, free the bus before retrying
+        if (dev->transport.recover != NULL && dev->transport.recover(dev->transport.ctx) == ESP_OK)
+        {
+            __atomic_fetch_add(&dev->io_stats.recoveries, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_fetch_add(&dev->io_stats.failures, 1, __ATOMIC_RELAXED);
+    ESP_LOGD(TAG, "Transfer at 0x%04x failed: %s", reg, esp_err_to_name(ret));
     return ret;
 }
 
-static esp_err_t gt911_read_byte(gt911_handle_t *dev, uint16_t reg, uint8_t *val)
+static esp_err_t gt911_write_byte(gt911_handle_t *dev, uint16_t reg, uint8_t val)
 {
-    esp_err_t ret;
-    uint8_t buffer[2];
+    return gt911_io(dev, reg, NULL, &val, 1);
+}
 
-    buffer[0] = (reg >> 8) & 0xFF; // Register address high byte
-    buffer[1] = reg & 0xFF;        // Register address low byte
+static esp_err_t gt911_write_block(gt911_handle_t *dev, uint16_t reg, uint8_t *val, uint8_t size)
+{
+    return gt911_io(dev, reg, NULL, val, size);
+}
 
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(cmd, buffer, 2, true);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+static esp_err_t gt911_read_block(gt911_handle_t *dev, uint16_t reg, uint8_t *buf, uint8_t size)
+{
+    return gt911_io(dev, reg, buf, NULL, size);
+}
 
-    if (ret != ESP_OK)
+// Transport with the retries, recovery and statistics of gt911_io(), which derives the
+// deadline from the length itself
+static esp_err_t gt911_io_read(void *ctx, uint16_t reg, uint8_t *buf, size_t len, uint32_t timeout_ms)
+{
+    return gt911_io((gt911_handle_t *)ctx, reg, buf, NULL, len);
+}
+
+static esp_err_t gt911_io_write(void *ctx, uint16_t reg, const uint8_t *buf, size_t len, uint32_t timeout_ms)
+{
+    return gt911_io((gt911_handle_t *)ctx, reg, NULL, buf, len);
+}
+
+// Function to calculate checksum for configuration, 0x8047..0x80FE
+static void gt911_calculate_checksum(uint8_t *config)
+{
+    uint8_t checksum = 0;
+
+    for (uint16_t i = 0; i < GT911_CONFIG_CHKSUM - GT911_CONFIG_START; i++)
     {
-        ESP_LOGE(TAG, "Failed to set read register address");
-        return ret;
+        checksum += config[i];
     }
 
-    cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_READ, true);
-    i2c_master_read_byte(cmd, val, I2C_MASTER_NACK);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
-
-    return ret;
+    checksum = (~checksum) + 1;
+    config[GT911_CONFIG_CHKSUM - GT911_CONFIG_START] = checksum;
 }
 
-static esp_err_t gt911_write_block(gt911_handle_t *dev, uint16_t reg, uint8_t *val, uint8_t size)
+// FNV-1a over the configuration block, detects a corrupt or stale cache entry
+static uint32_t gt911_config_hash(const uint8_t *config)
 {
-    esp_err_t ret;
-    uint8_t buffer[2];
+    uint32_t hash = 2166136261u;
 
-    buffer[0] = (reg >> 8) & 0xFF; // Register address high byte
-    buffer[1] = reg & 0xFF;        // Register address low byte
+    for (uint16_t i = 0; i < GT911_CONFIG_SIZE; i++)
+    {
+        hash = (hash ^ config[i]) * 16777619u;
+    }
 
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(cmd, buffer, 2, true);
-    i2c_master_write(cmd, val, size, true);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+    return hash;
+}
 
-    return ret;
+typedef struct
+{
+    uint32_t hash;
+    uint8_t config[GT911_CONFIG_SIZE];
+} gt911_config_cache_t;
+
+static void gt911_cache_key(gt911_handle_t *dev, char *key, size_t len)
+{
+    snprintf(key, len, "cfg_%02x", dev->addr);
 }
 
-static esp_err_t gt911_read_block(gt911_handle_t *dev, uint16_t reg, uint8_t *buf, uint8_t size)
+static bool gt911_cache_load(gt911_handle_t *dev, gt911_config_cache_t *cache)
 {
-    esp_err_t ret;
-    uint8_t buffer[2];
+    nvs_handle_t nvs;
+    if (nvs_open(GT911_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK)
+    {
+        return false;
+    }
 
-    buffer[0] = (reg >> 8) & 0xFF; // Register address high byte
-    buffer[1] = reg & 0xFF;        // Register address low byte
+    char key[8];
+    gt911_cache_key(dev, key, sizeof(key));
+    size_t len = sizeof(*cache);
+    esp_err_t ret = nvs_get_blob(nvs, key, cache, &len);
+    nvs_close(nvs);
 
-    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write(cmd, buffer, 2, true);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+    return ret == ESP_OK && len == sizeof(*cache) && cache->hash == gt911_config_hash(cache->config);
+}
 
+static void gt911_cache_store(gt911_handle_t *dev)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(GT911_NVS_NAMESPACE, NVS_READWRITE, &nvs);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to set read block register address");
-        return ret;
+        ESP_LOGD(TAG, "Configuration cache unavailable: %s", esp_err_to_name(ret));
+        return;
     }
 
-    cmd = i2c_cmd_link_create();
-    i2c_master_start(cmd);
-    i2c_master_write_byte(cmd, (dev->addr << 1) | I2C_MASTER_READ, true);
-    if (size > 1)
+    gt911_config_cache_t cache;
+    memcpy(cache.config, dev->config_buf, GT911_CONFIG_SIZE);
+    cache.hash = gt911_config_hash(cache.config);
+
+    char key[8];
+    gt911_cache_key(dev, key, sizeof(key));
+    ret = nvs_set_blob(nvs, key, &cache, sizeof(cache));
+    if (ret == ESP_OK)
     {
-        i2c_master_read(cmd, buf, size - 1, I2C_MASTER_ACK);
+        ret = nvs_commit(nvs);
     }
-    i2c_master_read_byte(cmd, buf + size - 1, I2C_MASTER_NACK);
-    i2c_master_stop(cmd);
-    ret = i2c_master_cmd_begin(dev->i2c_port, cmd, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    i2c_cmd_link_delete(cmd);
+    nvs_close(nvs);
 
-    return ret;
+    if (ret != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to cache configuration: %s", esp_err_to_name(ret));
+    }
 }
 
-// Function to calculate checksum for configuration
-static void gt911_calculate_checksum(gt911_handle_t *dev)
+// Load config_buf from the cache when it matches the chip, otherwise from the chip
+static esp_err_t gt911_load_config(gt911_handle_t *dev, bool *from_cache)
 {
-    uint8_t checksum = 0;
+    esp_err_t ret;
+    uint8_t header[GT911_Y_OUTPUT_MAX_HIGH - GT911_CONFIG_START + 1];
+    uint8_t checksum;
+
+    *from_cache = false;
 
-    for (uint8_t i = 0; i < GT911_CONFIG_SIZE; i++)
+    // Version, resolution and checksum identify the configuration on the chip
+    ret = gt911_read_block(dev, GT911_CONFIG_START, header, sizeof(header));
+    if (ret == ESP_OK)
     {
-        checksum += dev->config_buf[i];
+        ret = gt911_read_block(dev, GT911_CONFIG_CHKSUM, &checksum, 1);
     }
 
-    checksum = (~checksum) + 1;
-    dev->config_buf[GT911_CONFIG_CHKSUM - GT911_CONFIG_START] = checksum;
+    gt911_config_cache_t cache;
+    if (ret == ESP_OK && gt911_cache_load(dev, &cache) &&
+        memcmp(cache.config, header, sizeof(header)) == 0 &&
+        cache.config[GT911_CONFIG_CHKSUM - GT911_CONFIG_START] == checksum)
+    {
+        memcpy(dev->config_buf, cache.config, GT911_CONFIG_SIZE);
+        *from_cache = true;
+        return ESP_OK;
+    }
+
+    return gt911_read_block(dev, GT911_CONFIG_START, dev->config_buf, GT911_CONFIG_SIZE);
 }
 
-// Function to refresh the configuration
-static esp_err_t gt911_reflash_config(gt911_handle_t *dev)
+// Write the whole configuration block and let the controller apply it
+static esp_err_t gt911_write_config(gt911_handle_t *dev, bool cache)
 {
     esp_err_t ret;
 
-    gt911_calculate_checksum(dev);
-
-    ret = gt911_write_byte(dev, GT911_CONFIG_CHKSUM,
-                           dev->config_buf[GT911_CONFIG_CHKSUM - GT911_CONFIG_START]);
+    ret = gt911_write_block(dev, GT911_CONFIG_START, dev->config_buf, GT911_CONFIG_SIZE);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to write checksum");
+        ESP_LOGE(TAG, "Failed to write configuration");
         return ret;
     }
 
@@ -204,65 +313,168 @@ static esp_err_t gt911_reflash_config(gt911_handle_t *dev)
         return ret;
     }
 
+    if (cache)
+    {
+        gt911_cache_store(dev);
+    }
+
     return ESP_OK;
 }
 
-// Function to read a touch point from data buffer
-static gt911_point_t gt911_read_point(gt911_handle_t *dev, uint8_t *data)
+// Take over a patched copy of config_buf, returns true when the block changed
+static bool gt911_config_commit(gt911_handle_t *dev, uint8_t *config)
+{
+    gt911_calculate_checksum(config);
+
+    if (gt911_config_hash(config) == gt911_config_hash(dev->config_buf) &&
+        memcmp(config, dev->config_buf, GT911_CONFIG_SIZE) == 0)
+    {
+        return false;
+    }
+
+    memcpy(dev->config_buf, config, GT911_CONFIG_SIZE);
+    return true;
+}
+
+// Patch the resolution into config_buf, returns true when the block changed
+static bool gt911_config_set_resolution(gt911_handle_t *dev, uint16_t width, uint16_t height)
 {
-    gt911_point_t point;
-    uint16_t temp;
+    uint8_t config[GT911_CONFIG_SIZE];
+    memcpy(config, dev->config_buf, GT911_CONFIG_SIZE);
+
+    config[GT911_X_OUTPUT_MAX_LOW - GT911_CONFIG_START] = width & 0xFF;
+    config[GT911_X_OUTPUT_MAX_HIGH - GT911_CONFIG_START] = (width >> 8) & 0xFF;
+    config[GT911_Y_OUTPUT_MAX_LOW - GT911_CONFIG_START] = height & 0xFF;
+    config[GT911_Y_OUTPUT_MAX_HIGH - GT911_CONFIG_START] = (height >> 8) & 0xFF;
+
+    return gt911_config_commit(dev, config);
+}
 
-    point.id = data[0];
-    point.x = data[1] + (data[2] << 8);
-    point.y = data[3] + (data[4] << 8);
-    point.size = data[5] + (data[6] << 8);
+// Patch the fields of a scan profile that are not 0 into config_buf, returns true when the block changed
+static bool gt911_config_set_scan_profile(gt911_handle_t *dev, const gt911_scan_profile_t *profile)
+{
+    uint8_t config[GT911_CONFIG_SIZE];
+    memcpy(config, dev->config_buf, GT911_CONFIG_SIZE);
 
-    switch (dev->rotation)
+    if (profile->report_interval_ms != 0)
+    {
+        uint8_t *rate = &config[GT911_REFRESH_RATE - GT911_CONFIG_START];
+        *rate = (*rate & 0xF0) | ((profile->report_interval_ms - GT911_MIN_REPORT_INTERVAL_MS) & 0x0F);
+    }
+    if (profile->max_touches != 0)
     {
-    case ROTATION_NORMAL:
-        point.x = dev->width - point.x;
-        point.y = dev->height - point.y;
-        break;
-    case ROTATION_LEFT:
-        temp = point.x;
-        point.x = dev->width - point.y;
-        point.y = temp;
-        break;
-    case ROTATION_INVERTED:
-        // No change needed
-        break;
-    case ROTATION_RIGHT:
-        temp = point.x;
-        point.x = point.y;
-        point.y = dev->height - temp;
-        break;
+        uint8_t *touches = &config[GT911_TOUCH_NUMBER - GT911_CONFIG_START];
+        *touches = (*touches & 0xF0) | (profile->max_touches & 0x0F);
+    }
+    if (profile->touch_level != 0)
+    {
+        config[GT911_SCREEN_TOUCH_LEVEL - GT911_CONFIG_START] = profile->touch_level;
+    }
+    if (profile->leave_level != 0)
+    {
+        config[GT911_SCREEN_LEAVE_LEVEL - GT911_CONFIG_START] = profile->leave_level;
     }
 
-    return point;
+    return gt911_config_commit(dev, config);
 }
 
-// Public functions
-esp_err_t gt911_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl, uint8_t int_pin, uint8_t rst_pin,
-                     uint16_t width, uint16_t height, i2c_port_t i2c_port, uint8_t addr)
+// Apply a scan profile with a single configuration write, skipped when nothing changes
+static esp_err_t gt911_apply_scan_profile(gt911_handle_t *dev, const gt911_scan_profile_t *profile)
 {
-    esp_err_t ret;
+    if (!gt911_config_set_scan_profile(dev, profile))
+    {
+        return ESP_OK;
+    }
 
-    // Initialize structure members
+    // Profiles change at runtime, keep them out of the NVS cache to spare the flash
+    return gt911_write_config(dev, false);
+}
+
+static bool gt911_scan_profile_is_valid(const gt911_scan_profile_t *profile)
+{
+    return profile != NULL &&
+           (profile->report_interval_ms == 0 ||
+            (profile->report_interval_ms >= GT911_MIN_REPORT_INTERVAL_MS && profile->report_interval_ms <= GT911_MAX_REPORT_INTERVAL_MS)) &&
+           profile->max_touches <= GT911_MAX_POINTS &&
+           (profile->touch_level == 0 || profile->leave_level == 0 || profile->leave_level <= profile->touch_level);
+}
+
+static void gt911_update_transform(gt911_handle_t *dev)
+{
+    gt911_transform_t transform = dev->calibration;
+    gt911_transform_t step;
+
+    if (gt911_transform_rotation(&step, dev->rotation, dev->width, dev->height))
+    {
+        gt911_transform_compose(&transform, &transform, &step);
+    }
+
+    // Left and right rotations swap the axes of the reported points
+    bool swapped = dev->rotation == ROTATION_LEFT || dev->rotation == ROTATION_RIGHT;
+    if (dev->screen_width > 0 && dev->screen_height > 0 &&
+        gt911_transform_scale(&step, swapped ? dev->height : dev->width, swapped ? dev->width : dev->height,
+                              dev->screen_width, dev->screen_height))
+    {
+        gt911_transform_compose(&transform, &transform, &step);
+    }
+
+    portENTER_CRITICAL(&dev->transform_lock);
+    dev->transform = transform;
+    portEXIT_CRITICAL(&dev->transform_lock);
+}
+
+static void gt911_init_handle(gt911_handle_t *dev, uint8_t int_pin, uint8_t rst_pin, uint16_t width, uint16_t height, uint8_t addr)
+{
     dev->addr = addr;
-    dev->pin_sda = sda;
-    dev->pin_scl = scl;
     dev->pin_int = int_pin;
     dev->pin_rst = rst_pin;
     dev->width = width;
     dev->height = height;
     dev->rotation = ROTATION_NORMAL;
-    dev->i2c_port = i2c_port;
+    dev->screen_width = 0;
+    dev->screen_height = 0;
+    gt911_transform_identity(&dev->calibration);
+    portMUX_INITIALIZE(&dev->transform_lock);
+    gt911_update_transform(dev);
     dev->is_touched = false;
     dev->touches = 0;
+    dev->i2c_bus = NULL;
+    dev->i2c_dev = NULL;
+    dev->reader_task = NULL;
+    dev->reader_stop_waiter = NULL;
+    dev->io_stats = (gt911_io_stats_t){0};
+    dev->io_failures_in_row = 0;
+    dev->int_timestamp_us = 0;
+    dev->sequence = 0;
+    gt911_ring_init(&dev->ring);
+    dev->filter_enabled = false;
+    dev->scan_auto = false;
+    dev->scan_is_idle = false;
+    dev->scan_wake = false;
+    dev->report_cb = NULL;
+    dev->report_cb_ctx = NULL;
+}
+
+// Public functions
+esp_err_t gt911_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl, uint8_t int_pin, uint8_t rst_pin,
+                     uint16_t width, uint16_t height, i2c_port_t i2c_port, uint8_t addr)
+{
+    esp_err_t ret;
+
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Initialize structure members
+    gt911_init_handle(dev, int_pin, rst_pin, width, height, addr);
+    dev->pin_sda = sda;
+    dev->pin_scl = scl;
+    dev->i2c_port = i2c_port;
 
     // Initialize I2C
-    ret = gt911_i2c_init(i2c_port, sda, scl);
+    ret = gt911_i2c_init(dev, sda, scl);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to initialize I2C");
@@ -280,6 +492,56 @@ esp_err_t gt911_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl, uint8_t int_
     return ESP_OK;
 }
 
+esp_err_t gt911_init_with_transport(gt911_handle_t *dev, const gt911_transport_t *transport, uint8_t int_pin, uint8_t rst_pin,
+                                    uint16_t width, uint16_t height, uint8_t addr)
+{
+    if (dev == NULL || transport == NULL || transport->read == NULL || transport->write == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    gt911_init_handle(dev, int_pin, rst_pin, width, height, addr);
+    dev->transport = *transport;
+
+    esp_err_t ret = gt911_reset(dev);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to reset device");
+        return ret;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_deinit(gt911_handle_t *dev)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        gt911_stop_reader(dev);
+    }
+
+    if (dev->i2c_dev != NULL)
+    {
+        i2c_master_bus_rm_device(dev->i2c_dev);
+        dev->i2c_dev = NULL;
+    }
+
+    if (dev->i2c_bus != NULL)
+    {
+        i2c_del_master_bus(dev->i2c_bus);
+        dev->i2c_bus = NULL;
+    }
+
+    return ESP_OK;
+}
+
 esp_err_t gt911_reset(gt911_handle_t *dev)
 {
     esp_err_t ret;
@@ -309,22 +571,35 @@ esp_err_t gt911_reset(gt911_handle_t *dev)
     gt911_safe_set_pin_direction(dev->pin_int, GPIO_MODE_INPUT);
     vTaskDelay(50 / portTICK_PERIOD_MS);
 
-    // Read configuration from GT911
-    ret = gt911_read_block(dev, GT911_CONFIG_START, dev->config_buf, GT911_CONFIG_SIZE);
+    // Read configuration from the cache or from GT911
+    bool from_cache;
+    int64_t start_us = esp_timer_get_time();
+    ret = gt911_load_config(dev, &from_cache);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to read configuration data");
         return ret;
     }
 
-    // Set resolution
-    ret = gt911_set_resolution(dev, dev->width, dev->height);
-    if (ret != ESP_OK)
+    // Only reflash when the resolution differs, a reflash makes the controller recalibrate
+    bool changed = gt911_config_set_resolution(dev, dev->width, dev->height);
+    if (changed)
     {
-        ESP_LOGE(TAG, "Failed to set resolution");
-        return ret;
+        ret = gt911_write_config(dev, true);
+        if (ret != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to set resolution");
+            return ret;
+        }
+    }
+    else if (!from_cache)
+    {
+        gt911_cache_store(dev);
     }
 
+    ESP_LOGI(TAG, "Configuration version 0x%02x %s%s in %lld us", dev->config_buf[0], from_cache ? "from cache" : "read",
+             changed ? ", reflashed" : ", unchanged", esp_timer_get_time() - start_us);
+
     return ESP_OK;
 }
 
@@ -337,6 +612,7 @@ esp_err_t gt911_set_rotation(gt911_handle_t *dev, uint8_t rot)
     }
 
     dev->rotation = rot;
+    gt911_update_transform(dev);
     return ESP_OK;
 }
 
@@ -344,86 +620,576 @@ esp_err_t gt911_set_resolution(gt911_handle_t *dev, uint16_t width, uint16_t hei
 {
     dev->width = width;
     dev->height = height;
+    gt911_update_transform(dev);
 
-    // Update configuration buffer with new resolution
-    dev->config_buf[GT911_X_OUTPUT_MAX_LOW - GT911_CONFIG_START] = width & 0xFF;
-    dev->config_buf[GT911_X_OUTPUT_MAX_HIGH - GT911_CONFIG_START] = (width >> 8) & 0xFF;
-    dev->config_buf[GT911_Y_OUTPUT_MAX_LOW - GT911_CONFIG_START] = height & 0xFF;
-    dev->config_buf[GT911_Y_OUTPUT_MAX_HIGH - GT911_CONFIG_START] = (height >> 8) & 0xFF;
+    if (!gt911_config_set_resolution(dev, width, height))
+    {
+        return ESP_OK;
+    }
 
-    // Reflash configuration
-    return gt911_reflash_config(dev);
+    return gt911_write_config(dev, true);
 }
 
 esp_err_t gt911_read(gt911_handle_t *dev)
 {
-    esp_err_t ret;
-    uint8_t data[7];
-    uint8_t point_info;
+    const gt911_transport_t io = {.read = gt911_io_read, .write = gt911_io_write, .recover = NULL, .ctx = dev};
+    gt911_report_t report;
 
-    // Read the point info register
-    ret = gt911_read_byte(dev, GT911_POINT_INFO, &point_info);
+    esp_err_t ret = gt911_report_read(&io, GT911_IO_TIMEOUT_MS, &report);
+    if (ret == ESP_ERR_NOT_FOUND)
+    {
+        return ret;
+    }
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to read point info");
+        ESP_LOGE(TAG, "Failed to read point data: %s", esp_err_to_name(ret));
         return ret;
     }
 
+    uint8_t point_info = report.point_info;
     uint8_t buffer_status = (point_info >> 7) & 1;
     uint8_t proximity_valid = (point_info >> 5) & 1;
     uint8_t have_key = (point_info >> 4) & 1;
+
     dev->is_large_detect = (point_info >> 6) & 1;
-    dev->touches = point_info & 0xF;
+    dev->touches = report.touches;
     dev->is_touched = dev->touches > 0;
 
     ESP_LOGD(TAG, "Buffer status: %d, Large detect: %d, Proximity: %d, Key: %d, Touches: %d",
              buffer_status, dev->is_large_detect, proximity_valid, have_key, dev->touches);
 
-    // Read touch points if buffer has valid data and there are touches detected
-    if (buffer_status == 1 && dev->is_touched)
+    uint8_t touches = dev->touches < GT911_MAX_POINTS ? dev->touches : GT911_MAX_POINTS;
+    for (uint8_t i = 0; i < touches; i++)
+    {
+        dev->points[i] = report.points[i];
+    }
+
+    // Calibration, rotation and screen scale in one pass
+    gt911_transform_t transform;
+    portENTER_CRITICAL(&dev->transform_lock);
+    transform = dev->transform;
+    portEXIT_CRITICAL(&dev->transform_lock);
+    gt911_transform_apply(&transform, dev->points, touches);
+
+    for (uint8_t i = 0; i < touches; i++)
+    {
+        ESP_LOGD(TAG, "Touch %d: ID=%d, X=%d, Y=%d, Size=%d",
+                 i, dev->points[i].id, dev->points[i].x, dev->points[i].y, dev->points[i].size);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_scan_profile(gt911_handle_t *dev, const gt911_scan_profile_t *profile)
+{
+    if (dev == NULL || !gt911_scan_profile_is_valid(profile))
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        ESP_LOGE(TAG, "Stop the reader task before changing the scan profile");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dev->scan_auto = false;
+    return gt911_apply_scan_profile(dev, profile);
+}
+
+esp_err_t gt911_set_auto_scan(gt911_handle_t *dev, const gt911_scan_profile_t *interactive, const gt911_scan_profile_t *idle, uint32_t idle_after_ms)
+{
+    if (dev == NULL || (idle != NULL && (!gt911_scan_profile_is_valid(interactive) || !gt911_scan_profile_is_valid(idle))))
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        ESP_LOGE(TAG, "Stop the reader task before changing the scan profiles");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dev->scan_auto = false;
+    if (idle == NULL)
+    {
+        return ESP_OK;
+    }
+
+    esp_err_t ret = gt911_apply_scan_profile(dev, interactive);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    dev->scan_interactive = *interactive;
+    dev->scan_idle = *idle;
+    dev->scan_idle_after_ms = idle_after_ms;
+    dev->scan_is_idle = false;
+    dev->scan_wake = false;
+    dev->last_touch_us = esp_timer_get_time();
+    dev->scan_auto = true;
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_wake_scan(gt911_handle_t *dev)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!dev->scan_auto)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    __atomic_store_n(&dev->scan_wake, true, __ATOMIC_RELEASE);
+
+    // From the report callback the reader checks the request right after publishing
+    TaskHandle_t reader = dev->reader_task;
+    if (reader != NULL && reader != xTaskGetCurrentTaskHandle())
+    {
+        xTaskNotifyGive(reader);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_get_io_stats(gt911_handle_t *dev, gt911_io_stats_t *stats)
+{
+    if (dev == NULL || stats == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    stats->transfers = __atomic_load_n(&dev->io_stats.transfers, __ATOMIC_RELAXED);
+    stats->retries = __atomic_load_n(&dev->io_stats.retries, __ATOMIC_RELAXED);
+    stats->timeouts = __atomic_load_n(&dev->io_stats.timeouts, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&dev->io_stats.failures, __ATOMIC_RELAXED);
+    stats->recoveries = __atomic_load_n(&dev->io_stats.recoveries, __ATOMIC_RELAXED);
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_screen_size(gt911_handle_t *dev, uint16_t scr_width, uint16_t scr_height)
+{
+    if (dev == NULL || (scr_width == 0) != (scr_height == 0))
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dev->screen_width = scr_width;
+    dev->screen_height = scr_height;
+    gt911_update_transform(dev);
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_calibrate(gt911_handle_t *dev, const gt911_point_t reported[3], const gt911_point_t expected[3])
+{
+    if (dev == NULL || reported == NULL || expected == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Screen-space correction S moved into controller space: apply transform, S and the
+    // inverse transform, then the old calibration, so that new transform = S after old transform
+    gt911_transform_t correction;
+    gt911_transform_t inverse;
+    if (!gt911_transform_from_points(&correction, reported, expected) || !gt911_transform_invert(&inverse, &dev->transform))
+    {
+        ESP_LOGE(TAG, "Calibration points are on one line");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    gt911_transform_t calibration = dev->transform;
+    gt911_transform_compose(&calibration, &calibration, &correction);
+    gt911_transform_compose(&calibration, &calibration, &inverse);
+    gt911_transform_compose(&dev->calibration, &calibration, &dev->calibration);
+    gt911_update_transform(dev);
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_get_calibration(gt911_handle_t *dev, gt911_transform_t *calibration)
+{
+    if (dev == NULL || calibration == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *calibration = dev->calibration;
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_calibration(gt911_handle_t *dev, const gt911_transform_t *calibration)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (calibration != NULL)
+    {
+        dev->calibration = *calibration;
+    }
+    else
+    {
+        gt911_transform_identity(&dev->calibration);
+    }
+    gt911_update_transform(dev);
+
+    return ESP_OK;
+}
+
+static void IRAM_ATTR gt911_int_isr(void *arg)
+{
+    gt911_handle_t *dev = (gt911_handle_t *)arg;
+    BaseType_t task_woken = pdFALSE;
+
+    dev->int_timestamp_us = esp_timer_get_time();
+    vTaskNotifyGiveFromISR(dev->reader_task, &task_woken);
+    portYIELD_FROM_ISR(task_woken);
+}
+
+static void gt911_publish(gt911_handle_t *dev, int64_t timestamp_us)
+{
+    gt911_touch_t touch = {0};
+    touch.touches = dev->touches > GT911_MAX_POINTS ? GT911_MAX_POINTS : dev->touches;
+    touch.is_touched = dev->is_touched;
+    for (uint8_t i = 0; i < touch.touches; i++)
+    {
+        touch.points[i] = dev->points[i];
+    }
+    touch.sequence = ++dev->sequence;
+    touch.timestamp_us = timestamp_us;
+
+    if (dev->filter_enabled)
+    {
+        gt911_filter_apply(&dev->filter, &touch);
+    }
+
+    if (!gt911_ring_push(&dev->ring, &touch))
+    {
+        ESP_LOGD(TAG, "Touch buffer full, report %lu not buffered", (unsigned long)touch.sequence);
+    }
+
+    if (dev->report_cb != NULL)
+    {
+        dev->report_cb(&touch, dev->report_cb_ctx);
+    }
+}
+
+// Switch to the idle profile after idle_after_ms without touch, back to interactive after
+// gt911_wake_scan(). The controller recalibrates after every configuration write, so
+// neither switch happens while a finger is on the glass.
+static void gt911_update_scan(gt911_handle_t *dev, int64_t now_us)
+{
+    if (!dev->scan_auto)
+    {
+        return;
+    }
+
+    if (dev->is_touched)
     {
-        for (uint8_t i = 0; i < dev->touches && i < 5; i++)
+        dev->last_touch_us = now_us;
+        return;
+    }
+
+    const gt911_scan_profile_t *profile = NULL;
+    if (dev->scan_is_idle && __atomic_load_n(&dev->scan_wake, __ATOMIC_ACQUIRE))
+    {
+        profile = &dev->scan_interactive;
+    }
+    else if (!dev->scan_is_idle && now_us - dev->last_touch_us >= (int64_t)dev->scan_idle_after_ms * 1000)
+    {
+        profile = &dev->scan_idle;
+    }
+
+    if (profile != NULL && gt911_apply_scan_profile(dev, profile) == ESP_OK)
+    {
+        dev->scan_is_idle = profile == &dev->scan_idle;
+        dev->last_touch_us = now_us;
+        __atomic_store_n(&dev->scan_wake, false, __ATOMIC_RELEASE);
+        ESP_LOGD(TAG, "Scan profile %s", dev->scan_is_idle ? "idle" : "interactive");
+    }
+}
+
+static void gt911_reader_task(void *arg)
+{
+    gt911_handle_t *dev = (gt911_handle_t *)arg;
+    bool has_int = gt911_gpio_is_valid(dev->pin_int);
+
+    while (true)
+    {
+        TickType_t timeout = pdMS_TO_TICKS(GT911_POLL_INTERVAL_MS);
+        if (has_int)
+        {
+            timeout = dev->is_touched ? pdMS_TO_TICKS(GT911_RELEASE_TIMEOUT_MS) : portMAX_DELAY;
+        }
+        if (dev->scan_auto && !dev->scan_is_idle && !dev->is_touched)
+        {
+            // Wake up in time to switch to the idle profile
+            int64_t idle_in_us = dev->last_touch_us + (int64_t)dev->scan_idle_after_ms * 1000 - esp_timer_get_time();
+            TickType_t idle_in = idle_in_us > 0 ? pdMS_TO_TICKS(idle_in_us / 1000) + 1 : 0;
+            timeout = idle_in < timeout ? idle_in : timeout;
+        }
+        if (dev->io_failures_in_row >= GT911_IO_BACKOFF_FAILURES)
+        {
+            // Keep a dead or disconnected controller from occupying the bus, retry now and then
+            timeout = pdMS_TO_TICKS(GT911_IO_BACKOFF_MS);
+        }
+
+        bool notified = ulTaskNotifyTake(pdTRUE, timeout) > 0;
+        if (dev->reader_stop_waiter != NULL)
         {
-            ret = gt911_read_block(dev, GT911_POINT_1 + i * 8, data, 7);
-            if (ret != ESP_OK)
+            xTaskNotifyGive(dev->reader_stop_waiter);
+            vTaskDelete(NULL);
+        }
+
+        if (!notified && has_int && !dev->is_touched && dev->io_failures_in_row == 0)
+        {
+            gt911_update_scan(dev, esp_timer_get_time());
+            continue;
+        }
+
+        // Timestamp the report with its INT edge, not with the end of the I2C read
+        int64_t timestamp_us = notified && has_int ? dev->int_timestamp_us : esp_timer_get_time();
+        esp_err_t ret = gt911_read(dev);
+        if (ret == ESP_OK || ret == ESP_ERR_NOT_FOUND)
+        {
+            // Only new reports get a sequence number and a timestamp
+            dev->io_failures_in_row = 0;
+            if (ret == ESP_OK)
             {
-                ESP_LOGE(TAG, "Failed to read point %d data", i);
-                return ret;
+                gt911_publish(dev, timestamp_us);
             }
-
-            dev->points[i] = gt911_read_point(dev, data);
-            ESP_LOGD(TAG, "Touch %d: ID=%d, X=%d, Y=%d, Size=%d",
-                     i, dev->points[i].id, dev->points[i].x, dev->points[i].y, dev->points[i].size);
+            gt911_update_scan(dev, esp_timer_get_time());
+        }
+        else if (++dev->io_failures_in_row == GT911_IO_BACKOFF_FAILURES)
+        {
+            ESP_LOGW(TAG, "Controller not responding, retrying every %d ms", GT911_IO_BACKOFF_MS);
         }
     }
+}
+
+static gpio_int_type_t gt911_int_type(gt911_handle_t *dev)
+{
+    // Module_Switch1 bits 0-1 select the INT trigger: rising, falling, low or high level
+    switch (dev->config_buf[GT911_MODULE_SWITCH1 - GT911_CONFIG_START] & 0x03)
+    {
+    case 1:
+    case 2:
+        return GPIO_INTR_NEGEDGE;
+    default:
+        return GPIO_INTR_POSEDGE;
+    }
+}
+
+esp_err_t gt911_start_reader(gt911_handle_t *dev, UBaseType_t priority, BaseType_t core)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        ESP_LOGE(TAG, "Reader task is already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    gt911_ring_init(&dev->ring);
+    if (xTaskCreatePinnedToCore(gt911_reader_task, "gt911_reader", GT911_READER_STACK_SIZE, dev, priority, &dev->reader_task, core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Failed to create reader task");
+        dev->reader_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (!gt911_gpio_is_valid(dev->pin_int))
+    {
+        ESP_LOGI(TAG, "No INT pin, polling every %d ms", GT911_POLL_INTERVAL_MS);
+        return ESP_OK;
+    }
+
+    gpio_config_t int_config = {
+        .pin_bit_mask = 1ULL << dev->pin_int,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = gt911_int_type(dev),
+    };
+    esp_err_t ret = gpio_config(&int_config);
+
+    // The ISR service may already be installed by another driver
+    if (ret == ESP_OK)
+    {
+        ret = gpio_install_isr_service(0);
+        ret = ret == ESP_ERR_INVALID_STATE ? ESP_OK : ret;
+    }
+    if (ret == ESP_OK)
+    {
+        ret = gpio_isr_handler_add(dev->pin_int, gt911_int_isr, dev);
+    }
 
-    // Clear the point info register
-    ret = gt911_write_byte(dev, GT911_POINT_INFO, 0);
     if (ret != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to clear point info register");
-        return ret;
+        ESP_LOGE(TAG, "Failed to install INT interrupt: %s", esp_err_to_name(ret));
+        vTaskDelete(dev->reader_task);
+        dev->reader_task = NULL;
+        return ESP_FAIL;
+    }
+
+    // Pick up a report that may have arrived before the interrupt was armed
+    xTaskNotifyGive(dev->reader_task);
+    return ESP_OK;
+}
+
+esp_err_t gt911_stop_reader(gt911_handle_t *dev)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task == NULL)
+    {
+        ESP_LOGE(TAG, "Reader task is not running");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (gt911_gpio_is_valid(dev->pin_int))
+    {
+        gpio_isr_handler_remove(dev->pin_int);
+    }
+
+    // Let the task finish its current I2C transaction before it exits
+    dev->reader_stop_waiter = xTaskGetCurrentTaskHandle();
+    xTaskNotifyGive(dev->reader_task);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    dev->reader_stop_waiter = NULL;
+    dev->reader_task = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_filter(gt911_handle_t *dev, const gt911_filter_config_t *config)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        ESP_LOGE(TAG, "Stop the reader task before changing the filter");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dev->filter_enabled = config != NULL;
+    if (config != NULL)
+    {
+        gt911_filter_init(&dev->filter, config);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_filter_horizon(gt911_handle_t *dev, uint32_t horizon_us)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    gt911_filter_set_horizon(&dev->filter, horizon_us);
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_set_report_cb(gt911_handle_t *dev, gt911_report_cb_t cb, void *ctx)
+{
+    if (dev == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (dev->reader_task != NULL)
+    {
+        ESP_LOGE(TAG, "Stop the reader task before changing the report callback");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    dev->report_cb = cb;
+    dev->report_cb_ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t gt911_get_touch(gt911_handle_t *dev, gt911_touch_t *touch)
+{
+    if (dev == NULL || touch == NULL)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!gt911_ring_latest(&dev->ring, touch))
+    {
+        *touch = (gt911_touch_t){0};
     }
 
     return ESP_OK;
 }
 
-esp_err_t gt911_map_to_screen(gt911_handle_t *dev, int32_t scr_width, int32_t scr_height, int32_t x, int32_t y, int32_t *mapped_x, int32_t *mapped_y)
+esp_err_t gt911_pop_touch(gt911_handle_t *dev, gt911_touch_t *touch)
 {
-    if (dev == NULL || mapped_x == NULL || mapped_y == NULL)
+    if (dev == NULL || touch == NULL)
     {
         ESP_LOGE(TAG, "Invalid arguments");
         return ESP_ERR_INVALID_ARG;
     }
 
-    if (dev->width == 0 || dev->height == 0)
+    return gt911_ring_pop(&dev->ring, touch) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+uint32_t gt911_pending_touches(gt911_handle_t *dev)
+{
+    return dev == NULL ? 0 : gt911_ring_count(&dev->ring);
+}
+
+esp_err_t gt911_get_touch_stats(gt911_handle_t *dev, uint32_t *reports, uint32_t *dropped)
+{
+    if (dev == NULL)
     {
-        ESP_LOGE(TAG, "Invalid device dimensions: width or height is zero");
+        ESP_LOGE(TAG, "Invalid arguments");
         return ESP_ERR_INVALID_ARG;
     }
 
-    *mapped_x = x * scr_width / dev->width;
-    *mapped_y = y * scr_height / dev->height;
+    if (reports != NULL)
+    {
+        *reports = __atomic_load_n(&dev->ring.pushed, __ATOMIC_RELAXED);
+    }
+    if (dropped != NULL)
+    {
+        *dropped = __atomic_load_n(&dev->ring.dropped, __ATOMIC_RELAXED);
+    }
 
     return ESP_OK;
-}
\ No newline at end of file
+}
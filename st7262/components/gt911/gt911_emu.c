@@ -0,0 +1,265 @@
+#include "gt911_emu.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define REG(addr) ((addr) - GT911_EMU_REG_BASE)
+#define EMU_CONFIG_START 0x8047
+#define EMU_CONFIG_CHKSUM 0x80FF
+#define EMU_CONFIG_FRESH 0x8100
+#define EMU_X_OUTPUT_MAX 0x8048
+#define EMU_TOUCH_NUMBER 0x804C
+#define EMU_MODULE_SWITCH1 0x804D
+#define EMU_REFRESH_RATE 0x8056
+#define EMU_PRODUCT_ID 0x8140
+#define EMU_POINT_INFO 0x814E
+#define EMU_POINT_1 0x814F
+#define EMU_POINT_SIZE 8
+
+static uint8_t emu_checksum(const uint8_t *regs)
+{
+    uint8_t sum = 0;
+    for (uint16_t reg = EMU_CONFIG_START; reg < EMU_CONFIG_CHKSUM; reg++)
+    {
+        sum += regs[REG(reg)];
+    }
+    return (uint8_t)(~sum + 1);
+}
+
+void gt911_emu_init(gt911_emu_t *emu)
+{
+    memset(emu, 0, sizeof(*emu));
+    emu->bus_hz = GT911_EMU_BUS_HZ;
+
+    uint8_t *regs = emu->regs;
+    regs[REG(EMU_CONFIG_START)] = 0x41; // Config version
+    regs[REG(EMU_X_OUTPUT_MAX)] = 480 & 0xFF;
+    regs[REG(EMU_X_OUTPUT_MAX + 1)] = 480 >> 8;
+    regs[REG(EMU_X_OUTPUT_MAX + 2)] = 272 & 0xFF;
+    regs[REG(EMU_X_OUTPUT_MAX + 3)] = 272 >> 8;
+    regs[REG(EMU_TOUCH_NUMBER)] = GT911_MAX_POINTS;
+    regs[REG(EMU_MODULE_SWITCH1)] = 0x0D; // Falling edge INT
+    regs[REG(EMU_REFRESH_RATE)] = 0x05;   // 10 ms
+    regs[REG(EMU_CONFIG_CHKSUM)] = emu_checksum(regs);
+    memcpy(&regs[REG(EMU_PRODUCT_ID)], "911", 4);
+}
+
+static bool emu_in_range(uint16_t reg, size_t len)
+{
+    return reg >= GT911_EMU_REG_BASE && (size_t)(reg - GT911_EMU_REG_BASE) + len <= GT911_EMU_REG_COUNT;
+}
+
+// START, address, register address, optional repeated START and address, payload, STOP
+static void emu_count(gt911_emu_t *emu, size_t len, bool read)
+{
+    uint32_t bits = 9 * (1 + 2 + (read ? 1 : 0) + (uint32_t)len) + 2 + (read ? 1 : 0);
+
+    emu->stats.transactions++;
+    emu->stats.bus_time_us += ((uint64_t)bits * 1000000 + emu->bus_hz - 1) / emu->bus_hz;
+    if (read)
+    {
+        emu->stats.bytes_read += len;
+    }
+    else
+    {
+        emu->stats.bytes_written += len;
+    }
+}
+
+static void emu_load(gt911_emu_t *emu, const gt911_emu_event_t *event)
+{
+    uint8_t limit = emu->regs[REG(EMU_TOUCH_NUMBER)] & 0x0F;
+    uint8_t touches = event->touches < limit ? event->touches : limit;
+    touches = touches < GT911_MAX_POINTS ? touches : GT911_MAX_POINTS;
+
+    for (uint8_t i = 0; i < touches; i++)
+    {
+        const gt911_point_t *point = &event->points[i];
+        uint8_t *record = &emu->regs[REG(EMU_POINT_1 + i * EMU_POINT_SIZE)];
+        record[0] = point->id;
+        record[1] = point->x & 0xFF;
+        record[2] = point->x >> 8;
+        record[3] = point->y & 0xFF;
+        record[4] = point->y >> 8;
+        record[5] = point->size & 0xFF;
+        record[6] = point->size >> 8;
+        record[7] = 0;
+    }
+
+    emu->regs[REG(EMU_POINT_INFO)] = 0x80 | touches;
+}
+
+void gt911_emu_post(gt911_emu_t *emu, const gt911_emu_event_t *event)
+{
+    emu->stats.frames_posted++;
+
+    if ((emu->regs[REG(EMU_POINT_INFO)] & 0x80) == 0)
+    {
+        emu_load(emu, event);
+        return;
+    }
+
+    if (emu->pending)
+    {
+        emu->stats.frames_overrun++;
+    }
+    emu->pending = true;
+    emu->pending_event = *event;
+}
+
+void gt911_emu_play(gt911_emu_t *emu, const gt911_emu_event_t *trace, size_t len, int64_t start_us, bool loop)
+{
+    emu->trace = trace;
+    emu->trace_len = len;
+    emu->trace_pos = 0;
+    emu->trace_start_us = start_us;
+    emu->trace_loop = loop;
+}
+
+uint32_t gt911_emu_advance(gt911_emu_t *emu, int64_t now_us)
+{
+    uint32_t posted = 0;
+
+    while (emu->trace != NULL && emu->trace_pos < emu->trace_len &&
+           emu->trace_start_us + emu->trace[emu->trace_pos].time_us <= now_us)
+    {
+        gt911_emu_post(emu, &emu->trace[emu->trace_pos]);
+        posted++;
+
+        if (++emu->trace_pos == emu->trace_len && emu->trace_loop)
+        {
+            // Restart one interval after the last event
+            int64_t length = emu->trace[emu->trace_len - 1].time_us + 1;
+            emu->trace_start_us += length;
+            emu->trace_pos = 0;
+        }
+    }
+
+    return posted;
+}
+
+static esp_err_t emu_read(void *ctx, uint16_t reg, uint8_t *buf, size_t len, uint32_t timeout_ms)
+{
+    gt911_emu_t *emu = (gt911_emu_t *)ctx;
+
+    if (emu->fail_next > 0)
+    {
+        emu->fail_next--;
+        emu_count(emu, 0, true);
+        return ESP_ERR_TIMEOUT;
+    }
+    if (!emu_in_range(reg, len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (reg == EMU_POINT_INFO && emu->clock != NULL)
+    {
+        gt911_emu_advance(emu, emu->clock());
+    }
+
+    emu_count(emu, len, true);
+    memcpy(buf, &emu->regs[REG(reg)], len);
+    return ESP_OK;
+}
+
+static esp_err_t emu_write(void *ctx, uint16_t reg, const uint8_t *buf, size_t len, uint32_t timeout_ms)
+{
+    gt911_emu_t *emu = (gt911_emu_t *)ctx;
+
+    if (emu->fail_next > 0)
+    {
+        emu->fail_next--;
+        emu_count(emu, 0, false);
+        return ESP_ERR_TIMEOUT;
+    }
+    if (!emu_in_range(reg, len))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    emu_count(emu, len, false);
+    memcpy(&emu->regs[REG(reg)], buf, len);
+
+    // Clearing the buffer status acknowledges the report, a waiting one takes its place
+    if (reg == EMU_POINT_INFO && (buf[0] & 0x80) == 0)
+    {
+        emu->stats.frames_read++;
+        emu->regs[REG(EMU_POINT_INFO)] = 0;
+        if (emu->pending)
+        {
+            emu->pending = false;
+            emu_load(emu, &emu->pending_event);
+        }
+    }
+
+    if (reg <= EMU_CONFIG_FRESH && EMU_CONFIG_FRESH < reg + len && emu->regs[REG(EMU_CONFIG_FRESH)] == 1)
+    {
+        if (emu->regs[REG(EMU_CONFIG_CHKSUM)] == emu_checksum(emu->regs))
+        {
+            emu->stats.config_applied++;
+        }
+        else
+        {
+            emu->stats.config_rejected++;
+        }
+        emu->regs[REG(EMU_CONFIG_FRESH)] = 0;
+    }
+
+    return ESP_OK;
+}
+
+gt911_transport_t gt911_emu_transport(gt911_emu_t *emu)
+{
+    return (gt911_transport_t){
+        .read = emu_read,
+        .write = emu_write,
+        .recover = NULL,
+        .ctx = emu,
+    };
+}
+
+bool gt911_emu_parse_event(const char *line, gt911_emu_event_t *event)
+{
+    char *end;
+    memset(event, 0, sizeof(*event));
+
+    event->time_us = strtoll(line, &end, 10);
+    if (end == line || *end != ',')
+    {
+        return false;
+    }
+
+    line = end + 1;
+    long touches = strtol(line, &end, 10);
+    if (end == line || touches < 0 || touches > GT911_MAX_POINTS)
+    {
+        return false;
+    }
+    event->touches = (uint8_t)touches;
+
+    for (uint8_t i = 0; i < event->touches; i++)
+    {
+        long fields[4];
+        for (uint8_t f = 0; f < 4; f++)
+        {
+            if (*end != ',')
+            {
+                return false;
+            }
+            line = end + 1;
+            fields[f] = strtol(line, &end, 10);
+            if (end == line || fields[f] < 0 || fields[f] > UINT16_MAX)
+            {
+                return false;
+            }
+        }
+        event->points[i] = (gt911_point_t){.id = (uint8_t)fields[0], .x = (uint16_t)fields[1], .y = (uint16_t)fields[2], .size = (uint16_t)fields[3]};
+    }
+
+    return true;
+}
+
+uint32_t gt911_emu_bus_us_per_frame(const gt911_emu_t *emu)
+{
+    return emu->stats.frames_read == 0 ? 0 : (uint32_t)(emu->stats.bus_time_us / emu->stats.frames_read);
+}
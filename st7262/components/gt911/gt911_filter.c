@@ -0,0 +1,139 @@
+#include "gt911_filter.h"
+#include <stddef.h>
+
+#define Q8(v) ((int32_t)(v) << 8)
+#define US_PER_S 1000000LL
+
+void gt911_filter_init(gt911_filter_t *filter, const gt911_filter_config_t *config)
+{
+    filter->config = *config;
+    for (uint8_t i = 0; i < GT911_MAX_POINTS; i++)
+    {
+        filter->tracks[i].active = false;
+    }
+}
+
+void gt911_filter_set_horizon(gt911_filter_t *filter, uint32_t horizon_us)
+{
+    filter->config.horizon_us = horizon_us;
+}
+
+static int32_t abs32(int32_t value)
+{
+    return value < 0 ? -value : value;
+}
+
+static int32_t sat32(int64_t value)
+{
+    return value < INT32_MIN ? INT32_MIN : value > INT32_MAX ? INT32_MAX : (int32_t)value;
+}
+
+static uint16_t clamp_px(int64_t q8)
+{
+    int64_t px = (q8 + 128) >> 8;
+    return px < 0 ? 0 : px > UINT16_MAX ? UINT16_MAX : (uint16_t)px;
+}
+
+// Position after dt_us, Q8 pixels
+static int64_t extrapolate(int32_t pos, int32_t vel, int32_t acc, int64_t dt_us)
+{
+    return pos + (int64_t)vel * dt_us / US_PER_S + (int64_t)acc * dt_us * dt_us / (2 * US_PER_S * US_PER_S);
+}
+
+// One axis of the alpha-beta-gamma update, z is the measurement in Q8 pixels
+static void update_axis(const gt911_filter_config_t *config, int32_t *pos, int32_t *vel, int32_t *acc, int32_t z, int64_t dt_us)
+{
+    int64_t predicted = extrapolate(*pos, *vel, *acc, dt_us);
+    int64_t residual = z - predicted;
+    uint32_t alpha = config->alpha;
+    uint32_t beta = config->beta;
+    if (abs32((int32_t)residual) < Q8(config->rest_threshold))
+    {
+        // Small residuals are sensor noise, scale both gains so it neither moves nor accelerates the point
+        alpha = config->alpha_rest;
+        beta = config->alpha > 0 ? beta * config->alpha_rest / config->alpha : 0;
+    }
+
+    *pos = sat32(predicted + residual * alpha / GT911_FILTER_ONE);
+    *vel = sat32(*vel + (int64_t)*acc * dt_us / US_PER_S + residual * beta * US_PER_S / (GT911_FILTER_ONE * dt_us));
+    if (config->gamma > 0)
+    {
+        *acc = sat32(*acc + residual * config->gamma * 2 * US_PER_S / GT911_FILTER_ONE * US_PER_S / (dt_us * dt_us));
+    }
+}
+
+static gt911_filter_track_t *find_track(gt911_filter_t *filter, uint8_t id)
+{
+    gt911_filter_track_t *free_track = NULL;
+    for (uint8_t i = 0; i < GT911_MAX_POINTS; i++)
+    {
+        gt911_filter_track_t *track = &filter->tracks[i];
+        if (track->active && track->id == id)
+        {
+            return track;
+        }
+        if (!track->active && free_track == NULL)
+        {
+            free_track = track;
+        }
+    }
+    return free_track;
+}
+
+static void start_track(gt911_filter_track_t *track, const gt911_point_t *point, int64_t timestamp_us)
+{
+    track->active = true;
+    track->id = point->id;
+    track->timestamp_us = timestamp_us;
+    track->x = Q8(point->x);
+    track->y = Q8(point->y);
+    track->vx = track->vy = 0;
+    track->ax = track->ay = 0;
+}
+
+void gt911_filter_apply(gt911_filter_t *filter, gt911_touch_t *touch)
+{
+    const gt911_filter_config_t *config = &filter->config;
+    uint8_t touches = touch->is_touched ? touch->touches : 0;
+    if (touches > GT911_MAX_POINTS)
+    {
+        touches = GT911_MAX_POINTS;
+    }
+
+    // End tracks whose id is no longer reported
+    for (uint8_t i = 0; i < GT911_MAX_POINTS; i++)
+    {
+        gt911_filter_track_t *track = &filter->tracks[i];
+        bool reported = false;
+        for (uint8_t p = 0; p < touches && !reported; p++)
+        {
+            reported = track->active && touch->points[p].id == track->id;
+        }
+        track->active = reported;
+    }
+
+    for (uint8_t p = 0; p < touches; p++)
+    {
+        gt911_point_t *point = &touch->points[p];
+        gt911_filter_track_t *track = find_track(filter, point->id);
+        if (track == NULL)
+        {
+            continue;
+        }
+
+        int64_t dt_us = touch->timestamp_us - track->timestamp_us;
+        if (!track->active || dt_us <= 0 || dt_us > config->max_dt_us)
+        {
+            // A new finger is reported as is, it has no history to smooth or predict from
+            start_track(track, point, touch->timestamp_us);
+            continue;
+        }
+
+        update_axis(config, &track->x, &track->vx, &track->ax, Q8(point->x), dt_us);
+        update_axis(config, &track->y, &track->vy, &track->ay, Q8(point->y), dt_us);
+        track->timestamp_us = touch->timestamp_us;
+
+        point->x = clamp_px(extrapolate(track->x, track->vx, track->ax, config->horizon_us));
+        point->y = clamp_px(extrapolate(track->y, track->vy, track->ay, config->horizon_us));
+    }
+}
@@ -0,0 +1,55 @@
+#include "gt911_report.h"
+#include <stddef.h>
+
+void gt911_report_decode(const uint8_t *data, gt911_report_t *report)
+{
+    report->point_info = data[0];
+    report->touches = data[0] & 0x0F;
+
+    uint8_t touches = report->touches < GT911_MAX_POINTS ? report->touches : GT911_MAX_POINTS;
+    for (uint8_t i = 0; i < touches; i++)
+    {
+        const uint8_t *record = data + 1 + i * GT911_REPORT_POINT_SIZE;
+        report->points[i] = (gt911_point_t){
+            .id = record[0],
+            .x = record[1] | (record[2] << 8),
+            .y = record[3] | (record[4] << 8),
+            .size = record[5] | (record[6] << 8),
+        };
+    }
+}
+
+esp_err_t gt911_report_read(const gt911_transport_t *transport, uint32_t timeout_ms, gt911_report_t *report)
+{
+    uint8_t data[1 + GT911_MAX_POINTS * GT911_REPORT_POINT_SIZE];
+
+    // Status and the first point record are contiguous, one burst covers a single touch
+    esp_err_t ret = transport->read(transport->ctx, GT911_REPORT_REG, data, 1 + GT911_REPORT_POINT_SIZE, timeout_ms);
+    if (ret != ESP_OK)
+    {
+        return ret;
+    }
+
+    // No new report, the touch count is only valid together with the buffer status
+    if ((data[0] & 0x80) == 0)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    uint8_t touches = (data[0] & 0x0F) < GT911_MAX_POINTS ? (data[0] & 0x0F) : GT911_MAX_POINTS;
+    if (touches > 1)
+    {
+        ret = transport->read(transport->ctx, GT911_REPORT_REG + 1 + GT911_REPORT_POINT_SIZE, data + 1 + GT911_REPORT_POINT_SIZE,
+                              (touches - 1) * GT911_REPORT_POINT_SIZE, timeout_ms);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+    }
+
+    gt911_report_decode(data, report);
+
+    // Clear the point info register so the controller reports the next frame
+    uint8_t clear = 0;
+    return transport->write(transport->ctx, GT911_REPORT_REG, &clear, 1, timeout_ms);
+}
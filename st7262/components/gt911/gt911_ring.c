@@ -0,0 +1,76 @@
+#include "gt911_ring.h"
+#include <stddef.h>
+
+#define GT911_RING_MASK (GT911_RING_SIZE - 1)
+
+_Static_assert((GT911_RING_SIZE & GT911_RING_MASK) == 0, "GT911_RING_SIZE must be a power of two");
+
+void gt911_ring_init(gt911_ring_t *ring)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->latest = (gt911_touch_t){0};
+    ring->latest_seq = 0;
+    ring->pushed = 0;
+    ring->dropped = 0;
+}
+
+bool gt911_ring_push(gt911_ring_t *ring, const gt911_touch_t *touch)
+{
+    // Latest slot first, readers retry while the sequence is odd or changed
+    uint32_t seq = __atomic_load_n(&ring->latest_seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->latest_seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    ring->latest = *touch;
+    __atomic_store_n(&ring->latest_seq, seq + 2, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&ring->pushed, 1, __ATOMIC_RELAXED);
+
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= GT911_RING_SIZE)
+    {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+
+    ring->frames[head & GT911_RING_MASK] = *touch;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool gt911_ring_pop(gt911_ring_t *ring, gt911_touch_t *touch)
+{
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (head == tail)
+    {
+        return false;
+    }
+
+    *touch = ring->frames[tail & GT911_RING_MASK];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+uint32_t gt911_ring_count(const gt911_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail;
+}
+
+bool gt911_ring_latest(gt911_ring_t *ring, gt911_touch_t *touch)
+{
+    uint32_t before;
+    uint32_t after;
+    do
+    {
+        before = __atomic_load_n(&ring->latest_seq, __ATOMIC_ACQUIRE);
+        *touch = ring->latest;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        after = __atomic_load_n(&ring->latest_seq, __ATOMIC_RELAXED);
+    } while ((before & 1) != 0 || before != after);
+
+    return before != 0;
+}
@@ -0,0 +1,143 @@
+#include "gt911_transform.h"
+#include <stddef.h>
+
+#define Q16(v) ((int64_t)(v) << 16)
+
+static int32_t round_div(int64_t num, int64_t den)
+{
+    if (den < 0)
+    {
+        num = -num;
+        den = -den;
+    }
+    return (int32_t)(num >= 0 ? (num + den / 2) / den : (num - den / 2) / den);
+}
+
+static int32_t round_q16(int64_t value)
+{
+    return (int32_t)((value + (1 << 15)) >> 16);
+}
+
+void gt911_transform_identity(gt911_transform_t *t)
+{
+    *t = (gt911_transform_t){
+        .a = GT911_TRANSFORM_ONE, .b = 0, .c = 0,
+        .d = 0, .e = GT911_TRANSFORM_ONE, .f = 0,
+    };
+}
+
+bool gt911_transform_rotation(gt911_transform_t *t, uint8_t rotation, uint16_t width, uint16_t height)
+{
+    const int32_t one = GT911_TRANSFORM_ONE;
+    switch (rotation)
+    {
+    case ROTATION_NORMAL: // (W - x, H - y)
+        *t = (gt911_transform_t){.a = -one, .b = 0, .c = (int32_t)Q16(width), .d = 0, .e = -one, .f = (int32_t)Q16(height)};
+        return true;
+    case ROTATION_LEFT: // (H - y, x)
+        *t = (gt911_transform_t){.a = 0, .b = -one, .c = (int32_t)Q16(height), .d = one, .e = 0, .f = 0};
+        return true;
+    case ROTATION_INVERTED: // Controller coordinates as reported
+        gt911_transform_identity(t);
+        return true;
+    case ROTATION_RIGHT: // (y, W - x)
+        *t = (gt911_transform_t){.a = 0, .b = one, .c = 0, .d = -one, .e = 0, .f = (int32_t)Q16(width)};
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool gt911_transform_scale(gt911_transform_t *t, uint16_t from_width, uint16_t from_height, uint16_t to_width, uint16_t to_height)
+{
+    if (from_width == 0 || from_height == 0)
+    {
+        return false;
+    }
+
+    *t = (gt911_transform_t){
+        .a = round_div(Q16(to_width), from_width), .b = 0, .c = 0,
+        .d = 0, .e = round_div(Q16(to_height), from_height), .f = 0,
+    };
+    return true;
+}
+
+void gt911_transform_compose(gt911_transform_t *out, const gt911_transform_t *first, const gt911_transform_t *second)
+{
+    const gt911_transform_t p = *first;
+    const gt911_transform_t q = *second;
+
+    out->a = round_q16((int64_t)q.a * p.a + (int64_t)q.b * p.d);
+    out->b = round_q16((int64_t)q.a * p.b + (int64_t)q.b * p.e);
+    out->c = round_q16((int64_t)q.a * p.c + (int64_t)q.b * p.f) + q.c;
+    out->d = round_q16((int64_t)q.d * p.a + (int64_t)q.e * p.d);
+    out->e = round_q16((int64_t)q.d * p.b + (int64_t)q.e * p.e);
+    out->f = round_q16((int64_t)q.d * p.c + (int64_t)q.e * p.f) + q.f;
+}
+
+bool gt911_transform_invert(gt911_transform_t *out, const gt911_transform_t *t)
+{
+    const gt911_transform_t m = *t;
+
+    // Determinant in Q32, coefficients of the inverse in Q16
+    int64_t det = (int64_t)m.a * m.e - (int64_t)m.b * m.d;
+    if (det == 0)
+    {
+        return false;
+    }
+
+    out->a = round_div(Q16((int64_t)m.e) << 16, det);
+    out->b = round_div(-Q16((int64_t)m.b) << 16, det);
+    out->d = round_div(-Q16((int64_t)m.d) << 16, det);
+    out->e = round_div(Q16((int64_t)m.a) << 16, det);
+    out->c = -round_q16((int64_t)out->a * m.c + (int64_t)out->b * m.f);
+    out->f = -round_q16((int64_t)out->d * m.c + (int64_t)out->e * m.f);
+
+    return true;
+}
+
+// Solve r = k0 * x + k1 * y + k2 for the three point pairs with Cramer's rule
+static void solve_row(const gt911_point_t from[3], const int64_t r[3], int64_t det, int32_t *k0, int32_t *k1, int32_t *k2)
+{
+    const int64_t x0 = from[0].x, y0 = from[0].y;
+    const int64_t x1 = from[1].x, y1 = from[1].y;
+    const int64_t x2 = from[2].x, y2 = from[2].y;
+
+    *k0 = round_div(Q16(r[0] * (y1 - y2) + r[1] * (y2 - y0) + r[2] * (y0 - y1)), det);
+    *k1 = round_div(Q16(r[0] * (x2 - x1) + r[1] * (x0 - x2) + r[2] * (x1 - x0)), det);
+    *k2 = round_div(Q16(r[0] * (x1 * y2 - x2 * y1) + r[1] * (x2 * y0 - x0 * y2) + r[2] * (x0 * y1 - x1 * y0)), det);
+}
+
+bool gt911_transform_from_points(gt911_transform_t *t, const gt911_point_t from[3], const gt911_point_t to[3])
+{
+    const int64_t det = (int64_t)from[0].x * (from[1].y - from[2].y) +
+                        (int64_t)from[1].x * (from[2].y - from[0].y) +
+                        (int64_t)from[2].x * (from[0].y - from[1].y);
+    if (det == 0)
+    {
+        return false;
+    }
+
+    const int64_t xs[3] = {to[0].x, to[1].x, to[2].x};
+    const int64_t ys[3] = {to[0].y, to[1].y, to[2].y};
+    solve_row(from, xs, det, &t->a, &t->b, &t->c);
+    solve_row(from, ys, det, &t->d, &t->e, &t->f);
+
+    return true;
+}
+
+static uint16_t clamp_u16(int64_t value)
+{
+    return value < 0 ? 0 : value > UINT16_MAX ? UINT16_MAX : (uint16_t)value;
+}
+
+void gt911_transform_apply(const gt911_transform_t *t, gt911_point_t *points, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const int64_t x = points[i].x;
+        const int64_t y = points[i].y;
+        points[i].x = clamp_u16((t->a * x + t->b * y + t->c + (1 << 15)) >> 16);
+        points[i].y = clamp_u16((t->d * x + t->e * y + t->f + (1 << 15)) >> 16);
+    }
+}
@@ -1,17 +1,20 @@
 #ifndef GT911_H
 #define GT911_H
 
-#include <driver/i2c.h>
+#include <driver/i2c_master.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "gt911_transport.h"
+#include "gt911_report.h"
+#include "gt911_types.h"
+#include "gt911_ring.h"
+#include "gt911_filter.h"
+#include "gt911_transform.h"
 
 #define GT911_ADDR1 (uint8_t)0x5D
 #define GT911_ADDR2 (uint8_t)0x14
 
-#define ROTATION_LEFT (uint8_t)0
-#define ROTATION_INVERTED (uint8_t)1
-#define ROTATION_RIGHT (uint8_t)2
-#define ROTATION_NORMAL (uint8_t)3
-
 // Real-time command (Write only)
 #define GT911_COMMAND (uint16_t)0x8040
 #define GT911_ESD_CHECK (uint16_t)0x8041
@@ -25,9 +28,16 @@
 #define GT911_Y_OUTPUT_MAX_LOW (uint16_t)0x804A
 #define GT911_Y_OUTPUT_MAX_HIGH (uint16_t)0x804B
 #define GT911_TOUCH_NUMBER (uint16_t)0x804C
+#define GT911_MODULE_SWITCH1 (uint16_t)0x804D
+#define GT911_SCREEN_TOUCH_LEVEL (uint16_t)0x8053
+#define GT911_SCREEN_LEAVE_LEVEL (uint16_t)0x8054
+#define GT911_REFRESH_RATE (uint16_t)0x8056 // Bits 0-3: report interval - 5 ms
 #define GT911_CONFIG_CHKSUM (uint16_t)0X80FF
 #define GT911_CONFIG_FRESH (uint16_t)0X8100
-#define GT911_CONFIG_SIZE (uint16_t)0xFF - 0x46
+#define GT911_CONFIG_SIZE ((uint16_t)0xFF - 0x46) // 0x8047..0x80FF, checksum included
+
+// Configuration cache in NVS, used when nvs_flash_init() was called
+#define GT911_NVS_NAMESPACE "gt911"
 
 // Coordinate information
 #define GT911_PRODUCT_ID (uint16_t)0X8140
@@ -41,24 +51,72 @@
 #define GT911_POINT_3 (uint16_t)0X815F
 #define GT911_POINT_4 (uint16_t)0X8167
 #define GT911_POINT_5 (uint16_t)0X816F
+#define GT911_POINT_SIZE 8 // Track id, X, Y, size and a reserved byte
 
 // I2C configuration
 #define I2C_MASTER_SCL_IO CONFIG_I2C_MASTER_SCL
 #define I2C_MASTER_SDA_IO CONFIG_I2C_MASTER_SDA
 #define I2C_MASTER_NUM I2C_NUM_0    // I2C port number
 #define I2C_MASTER_FREQ_HZ 400000   // I2C master clock frequency
-#define I2C_MASTER_TX_BUF_DISABLE 0 // I2C master doesn't need buffer
-#define I2C_MASTER_RX_BUF_DISABLE 0 // I2C master doesn't need buffer
-#define I2C_MASTER_TIMEOUT_MS 1000
+#define GT911_IO_TIMEOUT_MS 5          // Deadline of a register transfer, plus the time its bytes take on the bus
+#define GT911_IO_RETRIES 2             // Attempts after the first before a transfer fails
+#define GT911_IO_BACKOFF_FAILURES 3    // Consecutive failed reads before the reader task backs off
+#define GT911_IO_BACKOFF_MS 200        // Reader task pause while the controller keeps failing
+#define GT911_MAX_WRITE (GT911_CONFIG_SIZE + 1) // Largest register write: configuration plus checksum
+
+// Reader task
+#define GT911_READER_STACK_SIZE 4096
+#define GT911_POLL_INTERVAL_MS 10     // Read interval when no INT pin is connected
+#define GT911_RELEASE_TIMEOUT_MS 50   // Re-read while touched in case the release report was missed
+
+// Scan profiles
+#define GT911_MIN_REPORT_INTERVAL_MS 5
+#define GT911_MAX_REPORT_INTERVAL_MS 20
+#define GT911_IDLE_AFTER_MS 5000
+
+// Controller settings written together with one checksum and refresh, 0 keeps a field unchanged
+typedef struct
+{
+    uint8_t report_interval_ms; // GT911_MIN_REPORT_INTERVAL_MS..GT911_MAX_REPORT_INTERVAL_MS
+    uint8_t max_touches;        // 1..GT911_MAX_POINTS
+    uint8_t touch_level;        // Signal threshold for a touch
+    uint8_t leave_level;        // Signal threshold for a release, not above touch_level
+} gt911_scan_profile_t;
+
+// Highest report rate, all fingers
+#define GT911_SCAN_PROFILE_INTERACTIVE()                      \
+    {                                                         \
+        .report_interval_ms = GT911_MIN_REPORT_INTERVAL_MS,   \
+        .max_touches = GT911_MAX_POINTS,                      \
+        .touch_level = 0,                                     \
+        .leave_level = 0,                                     \
+    }
+
+// Lowest report rate, one finger is enough to wake up
+#define GT911_SCAN_PROFILE_IDLE()                             \
+    {                                                         \
+        .report_interval_ms = GT911_MAX_REPORT_INTERVAL_MS,   \
+        .max_touches = 1,                                     \
+        .touch_level = 0,                                     \
+        .leave_level = 0,                                     \
+    }
 
-// Touch point structure
+// Register transfer counters
 typedef struct
 {
-    uint8_t id;
-    uint16_t x;
-    uint16_t y;
-    uint16_t size;
-} gt911_point_t;
+    uint32_t transfers;  // Attempts, retries included
+    uint32_t retries;
+    uint32_t timeouts;   // Attempts that ran into their deadline
+    uint32_t failures;   // Transfers that failed after all retries
+    uint32_t recoveries; // Bus recoveries
+} gt911_io_stats_t;
+
+/**
+ * @brief Callback run by the reader task after a report was buffered.
+ *
+ * Runs in the reader task, keep it short, e.g. notify the task that consumes reports.
+ */
+typedef void (*gt911_report_cb_t)(const gt911_touch_t *touch, void *ctx);
 
 // GT911 handle structure
 typedef struct
@@ -71,12 +129,38 @@ typedef struct
     uint16_t width;
     uint16_t height;
     uint8_t rotation;
+    uint16_t screen_width;          // 0 = report controller coordinates after rotation
+    uint16_t screen_height;
+    gt911_transform_t calibration;  // Correction applied to the raw controller coordinates
+    gt911_transform_t transform;    // Raw coordinates to screen: calibration, rotation and scale
+    portMUX_TYPE transform_lock;
     uint8_t config_buf[GT911_CONFIG_SIZE];
     uint8_t is_large_detect;
     uint8_t touches;
     bool is_touched;
-    gt911_point_t points[5];
+    gt911_point_t points[GT911_MAX_POINTS];
     i2c_port_t i2c_port;
+    i2c_master_bus_handle_t i2c_bus;
+    i2c_master_dev_handle_t i2c_dev;
+    gt911_transport_t transport;
+    gt911_io_stats_t io_stats;
+    uint32_t io_failures_in_row; // Consecutive failed reads in the reader task
+    bool scan_auto;
+    bool scan_is_idle;
+    bool scan_wake; // Set by gt911_wake_scan(), applied once no finger is on the glass
+    gt911_scan_profile_t scan_interactive;
+    gt911_scan_profile_t scan_idle;
+    uint32_t scan_idle_after_ms;
+    int64_t last_touch_us;
+    TaskHandle_t reader_task;
+    TaskHandle_t reader_stop_waiter; // Set by gt911_stop_reader()
+    volatile int64_t int_timestamp_us; // Time of the last INT edge, set by the ISR
+    uint32_t sequence;
+    gt911_ring_t ring; // Reports published by the reader task
+    bool filter_enabled;
+    gt911_filter_t filter; // Applied by the reader task before publishing
+    gt911_report_cb_t report_cb;
+    void *report_cb_ctx;
 } gt911_handle_t;
 
 // Function declarations
@@ -103,6 +187,40 @@ typedef struct
  */
 esp_err_t gt911_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl, uint8_t int_pin, uint8_t rst_pin, uint16_t width, uint16_t height, i2c_port_t i2c_port, uint8_t addr);
 
+/**
+ * @brief Initialize the GT911 touch controller on a custom register transport.
+ *
+ * Same as gt911_init(), but the registers are accessed through the given transport
+ * instead of an I2C bus created by the driver.
+ *
+ * @param[out] dev       Pointer to the GT911 device handle to be initialized.
+ * @param[in]  transport Register transport, copied into the handle.
+ * @param[in]  int_pin   GPIO number for the interrupt pin.
+ * @param[in]  rst_pin   GPIO number for the reset pin.
+ * @param[in]  width     Width of the touch screen in pixels.
+ * @param[in]  height    Height of the touch screen in pixels.
+ * @param[in]  addr      I2C address of the GT911 device, selected during reset.
+ *
+ * @return
+ *     - ESP_OK: Initialization successful.
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments provided.
+ *     - ESP_FAIL: Initialization failed due to other reasons.
+ */
+esp_err_t gt911_init_with_transport(gt911_handle_t *dev, const gt911_transport_t *transport, uint8_t int_pin, uint8_t rst_pin, uint16_t width, uint16_t height, uint8_t addr);
+
+/**
+ * @brief Release the I2C bus and device created by gt911_init().
+ *
+ * Stops the reader task if it is running.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_deinit(gt911_handle_t *dev);
+
 /**
  * @brief Reset the GT911 touch controller.
  *
@@ -110,6 +228,11 @@ esp_err_t gt911_init(gt911_handle_t *dev, uint8_t sda, uint8_t scl, uint8_t int_
  * by toggling the reset pin. It ensures the device is properly initialized
  * and ready for operation.
  *
+ * When NVS is initialized, the configuration is cached under GT911_NVS_NAMESPACE. If
+ * the version, resolution and checksum on the chip match the cache, the 185-byte
+ * configuration block is not read, and the block is only written when the resolution
+ * differs, so a normal boot avoids the recalibration that follows a reflash.
+ *
  * @param[in] dev Pointer to the GT911 device handle.
  *
  * @return
@@ -141,7 +264,8 @@ esp_err_t gt911_set_rotation(gt911_handle_t *dev, uint8_t rot);
  *
  * This function configures the resolution of the GT911 touch panel by setting
  * the width and height parameters. It updates the device's internal settings
- * to match the specified resolution.
+ * to match the specified resolution. The configuration is only written, and the
+ * controller only recalibrates, when the resolution changes.
  *
  * @param[in] dev Pointer to the GT911 device handle.
  * @param[in] width The desired width of the touch panel in pixels.
@@ -157,35 +281,281 @@ esp_err_t gt911_set_resolution(gt911_handle_t *dev, uint16_t width, uint16_t hei
 /**
  * @brief Reads data from the GT911 touch controller.
  *
+ * The handle's touch state is only updated when the controller has a new report.
+ *
  * @param[in] dev Pointer to the GT911 device handle.
  *
  * @return
- *     - ESP_OK: Success
+ *     - ESP_OK: Success, a new report was read
+ *     - ESP_ERR_NOT_FOUND: No new report since the last read
  *     - ESP_ERR_INVALID_ARG: Invalid arguments
  *     - ESP_FAIL: Communication or other failure
  */
 esp_err_t gt911_read(gt911_handle_t *dev);
 
 /**
- * @brief Maps the touch coordinates from the GT911 touch controller to the screen coordinates.
+ * @brief Start a task that reads the GT911 whenever it reports new data.
  *
- * This function takes the raw touch coordinates reported by the GT911 touch controller
- * and maps them to the corresponding screen coordinates based on the screen's width
- * and height.
+ * With a valid INT pin the task sleeps until the GPIO interrupt fires, so an untouched
+ * screen causes no I2C traffic. Without one it falls back to polling every
+ * GT911_POLL_INTERVAL_MS. Results are published for gt911_get_touch() and buffered for
+ * gt911_pop_touch(); while the task runs, gt911_read() must not be called by anyone else.
  *
  * @param[in] dev Pointer to the GT911 device handle.
- * @param[in] scr_width Width of the screen in pixels.
- * @param[in] scr_height Height of the screen in pixels.
- * @param[in] x Raw X coordinate from the touch controller.
- * @param[in] y Raw Y coordinate from the touch controller.
- * @param[out] mapped_x Pointer to store the mapped X coordinate on the screen.
- * @param[out] mapped_y Pointer to store the mapped Y coordinate on the screen.
+ * @param[in] priority Reader task priority.
+ * @param[in] core Core the task is pinned to, or tskNO_AFFINITY.
  *
  * @return
- *     - ESP_OK: Mapping was successful.
- *     - ESP_ERR_INVALID_ARG: Invalid arguments were provided.
- *     - Other error codes depending on the implementation.
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_INVALID_STATE: The reader task is already running
+ *     - ESP_ERR_NO_MEM: Could not create the task
+ *     - ESP_FAIL: Failed to install the GPIO interrupt
+ */
+esp_err_t gt911_start_reader(gt911_handle_t *dev, UBaseType_t priority, BaseType_t core);
+
+/**
+ * @brief Stop the reader task started by gt911_start_reader().
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_INVALID_STATE: The reader task is not running
+ */
+esp_err_t gt911_stop_reader(gt911_handle_t *dev);
+
+/**
+ * @brief Smooth and predict the reports published by the reader task.
+ *
+ * Each finger is tracked by an alpha-beta filter and reported horizon_us ahead of its
+ * INT edge, so a drag does not trail the finger by the touch-to-photon latency.
+ * Raw reports from gt911_read() are not filtered.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] config Filter settings, NULL to publish raw reports.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_INVALID_STATE: The reader task is running
+ */
+esp_err_t gt911_set_filter(gt911_handle_t *dev, const gt911_filter_config_t *config);
+
+/**
+ * @brief Change the prediction horizon of the filter, also while the reader task runs.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] horizon_us Prediction horizon, typically the measured touch-to-photon latency.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_set_filter_horizon(gt911_handle_t *dev, uint32_t horizon_us);
+
+/**
+ * @brief Run a callback for every report the reader task buffers.
+ *
+ * Lets the consumer sleep until input arrives instead of polling gt911_pop_touch().
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] cb Callback, NULL to remove it.
+ * @param[in] ctx Passed to cb.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_INVALID_STATE: The reader task is running
+ */
+esp_err_t gt911_set_report_cb(gt911_handle_t *dev, gt911_report_cb_t cb, void *ctx);
+
+/**
+ * @brief Get the latest touch state published by the reader task.
+ *
+ * Never touches the I2C bus or consumes buffered reports, so it is cheap enough for
+ * every LVGL indev poll.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[out] touch Latest touch state.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_get_touch(gt911_handle_t *dev, gt911_touch_t *touch);
+
+/**
+ * @brief Take the oldest report buffered by the reader task.
+ *
+ * Reports are kept in arrival order with the time of their INT edge, so a consumer
+ * that polls slower than the controller reports still sees every press, move and
+ * release. Only one task may call this function.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[out] touch Oldest buffered report.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_NOT_FOUND: No report is buffered
+ */
+esp_err_t gt911_pop_touch(gt911_handle_t *dev, gt911_touch_t *touch);
+
+/**
+ * @brief Number of reports waiting for gt911_pop_touch().
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ *
+ * @return Buffered reports, 0 for an invalid handle
+ */
+uint32_t gt911_pending_touches(gt911_handle_t *dev);
+
+/**
+ * @brief Get the report counters of the reader task.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[out] reports Reports published since gt911_start_reader(), may be NULL.
+ * @param[out] dropped Reports that did not fit in the buffer, may be NULL.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_get_touch_stats(gt911_handle_t *dev, uint32_t *reports, uint32_t *dropped);
+
+/**
+ * @brief Set report rate, touch limit and thresholds.
+ *
+ * All fields go into one configuration write with one checksum and one refresh, and
+ * nothing is written when the controller already uses the profile. Turns off
+ * automatic switching.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] profile Settings, fields set to 0 stay unchanged.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments or profile
+ *     - ESP_ERR_INVALID_STATE: The reader task is running
+ *     - Other: Configuration write failed
+ */
+esp_err_t gt911_set_scan_profile(gt911_handle_t *dev, const gt911_scan_profile_t *profile);
+
+/**
+ * @brief Let the reader task switch between an interactive and an idle profile.
+ *
+ * Off unless called. The idle profile is applied after idle_after_ms without touch,
+ * the interactive one after gt911_wake_scan(). Each switch writes the 185-byte
+ * configuration block and a refresh, about 5 ms of bus time at 400 kHz, after which
+ * the controller recalibrates and ignores touches for a moment. A finger on the glass
+ * during the recalibration becomes part of the baseline, so neither switch happens
+ * while touched; a wake waits for the release. Keep idle_after_ms in the order of
+ * seconds. Not measured on hardware yet.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] interactive Profile while in use, applied immediately.
+ * @param[in] idle Profile while idle, NULL to turn automatic switching off.
+ * @param[in] idle_after_ms Time without touch before switching to idle, e.g. GT911_IDLE_AFTER_MS.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments or profile
+ *     - ESP_ERR_INVALID_STATE: The reader task is running
+ *     - Other: Configuration write failed
+ */
+esp_err_t gt911_set_auto_scan(gt911_handle_t *dev, const gt911_scan_profile_t *interactive, const gt911_scan_profile_t *idle, uint32_t idle_after_ms);
+
+/**
+ * @brief Ask the reader task to return to the interactive profile.
+ *
+ * For an application-level wake, e.g. the first touch seen in the idle profile or a
+ * button. The switch is applied once no finger is on the glass and restarts the idle
+ * timer. Safe to call from the report callback.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_INVALID_STATE: Automatic switching is off
+ */
+esp_err_t gt911_wake_scan(gt911_handle_t *dev);
+
+/**
+ * @brief Get the register transfer counters.
+ *
+ * Every transfer has a deadline of GT911_IO_TIMEOUT_MS plus its time on the bus and is
+ * retried GT911_IO_RETRIES times. A timeout or bus error first recovers the bus (SCL
+ * clock-out and controller reset on the i2c_master transport).
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[out] stats Counters since gt911_init().
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_get_io_stats(gt911_handle_t *dev, gt911_io_stats_t *stats);
+
+/**
+ * @brief Scale reported points to the screen resolution.
+ *
+ * Rotation, scale and calibration are folded into one Q16 affine transform that
+ * gt911_read() applies to all points of a report, so the published points are
+ * already in screen coordinates.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] scr_width Screen width in pixels, after rotation. 0 reports controller coordinates.
+ * @param[in] scr_height Screen height in pixels, after rotation.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_set_screen_size(gt911_handle_t *dev, uint16_t scr_width, uint16_t scr_height);
+
+/**
+ * @brief Refine the calibration from three touches.
+ *
+ * Ask the user to touch three targets that are not on one line, then pass the points
+ * reported for them (as returned by gt911_get_touch() with the filter disabled, or by
+ * gt911_read()) together with the target positions. The correction is stored in
+ * controller coordinates, so it stays valid when the rotation or screen size changes.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] reported Points reported for the three targets, in screen coordinates.
+ * @param[in] expected Target positions, in screen coordinates.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments or the points are on one line
+ */
+esp_err_t gt911_calibrate(gt911_handle_t *dev, const gt911_point_t reported[3], const gt911_point_t expected[3]);
+
+/**
+ * @brief Get the calibration, for example to store it.
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[out] calibration Correction in controller coordinates.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ */
+esp_err_t gt911_get_calibration(gt911_handle_t *dev, gt911_transform_t *calibration);
+
+/**
+ * @brief Restore a calibration returned by gt911_get_calibration().
+ *
+ * @param[in] dev Pointer to the GT911 device handle.
+ * @param[in] calibration Correction in controller coordinates, NULL to remove the calibration.
+ *
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
  */
-esp_err_t gt911_map_to_screen(gt911_handle_t *dev, int32_t scr_width, int32_t scr_height, int32_t x, int32_t y, int32_t *mapped_x, int32_t *mapped_y);
+esp_err_t gt911_set_calibration(gt911_handle_t *dev, const gt911_transform_t *calibration);
 
 #endif // GT911_H
\ No newline at end of file
@@ -0,0 +1,135 @@
+#ifndef GT911_EMU_H
+#define GT911_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "gt911_types.h"
+#include "gt911_transport.h"
+
+#define GT911_EMU_REG_BASE (uint16_t)0x8040
+#define GT911_EMU_REG_COUNT 0x140 // 0x8040..0x817F: commands, configuration, product info and points
+#define GT911_EMU_BUS_HZ 400000
+
+/**
+ * @brief One touch report of a trace, in raw controller coordinates.
+ */
+typedef struct
+{
+    int64_t time_us; // Since the start of the trace
+    uint8_t touches;
+    gt911_point_t points[GT911_MAX_POINTS];
+} gt911_emu_event_t;
+
+/**
+ * @brief Emulator and bus counters.
+ */
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t bytes_read;    // Payload bytes, register addresses excluded
+    uint32_t bytes_written;
+    uint64_t bus_time_us;   // Simulated time on the bus at bus_hz
+    uint32_t frames_posted;
+    uint32_t frames_read;   // Reports the host acknowledged by clearing the point info register
+    uint32_t frames_overrun; // Reports replaced before the host acknowledged the previous one
+    uint32_t config_applied;
+    uint32_t config_rejected; // Refreshes with a bad checksum
+} gt911_emu_stats_t;
+
+/**
+ * @brief Emulated GT911 register map.
+ *
+ * Behaves like the controller as far as the driver can tell:
+ * - 0x8047..0x80FF is the configuration block. Writing 1 to 0x8100 applies it when the
+ *   checksum at 0x80FF is valid and counts a rejection otherwise.
+ * - A report sets the buffer status bit of 0x814E and the point records from 0x814F,
+ *   limited by the touch number at 0x804C. Until the host writes 0 to 0x814E, the next
+ *   report waits and a newer one replaces it (an overrun).
+ *
+ * Plain C without ESP-IDF dependencies beyond esp_err_t, so it builds on a host.
+ */
+typedef struct
+{
+    uint8_t regs[GT911_EMU_REG_COUNT];
+    uint32_t bus_hz;
+    /* Pending report, waits for the host to clear the buffer status */
+    bool pending;
+    gt911_emu_event_t pending_event;
+    /* Trace playback */
+    const gt911_emu_event_t *trace;
+    size_t trace_len;
+    size_t trace_pos;
+    int64_t trace_start_us;
+    bool trace_loop;
+    int64_t (*clock)(void); // Optional, advances the trace on every point info read
+    /* Fault injection */
+    uint32_t fail_next; // Number of upcoming transactions that time out
+    gt911_emu_stats_t stats;
+} gt911_emu_t;
+
+/**
+ * @brief Power on the emulator with a valid 480x272 configuration.
+ *
+ * @param emu Emulator
+ */
+void gt911_emu_init(gt911_emu_t *emu);
+
+/**
+ * @brief Transport that reads and writes the emulated registers.
+ *
+ * @param emu Emulator
+ * @return Transport for gt911_init_with_transport()
+ */
+gt911_transport_t gt911_emu_transport(gt911_emu_t *emu);
+
+/**
+ * @brief Post a report, as if the controller finished a scan.
+ *
+ * @param emu Emulator
+ * @param event Report, time_us is ignored
+ */
+void gt911_emu_post(gt911_emu_t *emu, const gt911_emu_event_t *event);
+
+/**
+ * @brief Play a trace, events are posted by gt911_emu_advance().
+ *
+ * @param emu Emulator
+ * @param trace Events sorted by time, must stay valid while playing
+ * @param len Number of events
+ * @param start_us Time of the trace start on the advance() clock
+ * @param loop Restart the trace after its last event
+ */
+void gt911_emu_play(gt911_emu_t *emu, const gt911_emu_event_t *trace, size_t len, int64_t start_us, bool loop);
+
+/**
+ * @brief Post the trace events due at now_us.
+ *
+ * @param emu Emulator
+ * @param now_us Current time
+ * @return Number of events posted
+ */
+uint32_t gt911_emu_advance(gt911_emu_t *emu, int64_t now_us);
+
+/**
+ * @brief Parse one line of a recorded trace.
+ *
+ * Format: "time_us,touches,id,x,y,size,..." with one id,x,y,size group per touch.
+ *
+ * @param line Text line
+ * @param event Parsed event
+ * @return
+ *     - true: Success
+ *     - false: Malformed line
+ */
+bool gt911_emu_parse_event(const char *line, gt911_emu_event_t *event);
+
+/**
+ * @brief Simulated bus time per acknowledged report, the bus cost of a touch frame.
+ *
+ * @param emu Emulator
+ * @return Microseconds per frame, 0 before the first frame
+ */
+uint32_t gt911_emu_bus_us_per_frame(const gt911_emu_t *emu);
+
+#endif // GT911_EMU_H
@@ -0,0 +1,94 @@
+#ifndef GT911_FILTER_H
+#define GT911_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gt911_types.h"
+
+/**
+ * @brief Gain of 1.0 for the Q8 filter gains.
+ */
+#define GT911_FILTER_ONE 256
+
+/**
+ * @brief Filter settings.
+ *
+ * Gains are Q8, GT911_FILTER_ONE is 1.0. A gamma of 0 tracks position and velocity
+ * only (alpha-beta, linear prediction), a gamma above 0 also tracks acceleration
+ * (alpha-beta-gamma, quadratic prediction).
+ */
+typedef struct
+{
+    uint16_t alpha;          // Position gain while moving
+    uint16_t alpha_rest;     // Position gain for residuals below rest_threshold, removes jitter of a resting finger
+    uint16_t beta;           // Velocity gain
+    uint16_t gamma;          // Acceleration gain, 0 to disable
+    uint16_t rest_threshold; // Residual in pixels below which alpha_rest applies
+    uint32_t horizon_us;     // How far ahead of the report the output is predicted, 0 to only smooth
+    uint32_t max_dt_us;      // Reports further apart restart the track
+} gt911_filter_config_t;
+
+#define GT911_FILTER_DEFAULT_CONFIG()  \
+    {                                  \
+        .alpha = 192,                  \
+        .alpha_rest = 48,              \
+        .beta = 64,                    \
+        .gamma = 0,                    \
+        .rest_threshold = 2,           \
+        .horizon_us = 16000,           \
+        .max_dt_us = 100000,           \
+    }
+
+/**
+ * @brief State of one finger, matched by its GT911 track id.
+ */
+typedef struct
+{
+    bool active;
+    uint8_t id;
+    int64_t timestamp_us;
+    int32_t x, y;   // Position, Q8 pixels
+    int32_t vx, vy; // Velocity, Q8 pixels per second
+    int32_t ax, ay; // Acceleration, Q8 pixels per second squared
+} gt911_filter_track_t;
+
+/**
+ * @brief Touch filter and predictor.
+ *
+ * Fixed-point only, no ESP-IDF dependencies, so recorded reports can be replayed
+ * through it on a host.
+ */
+typedef struct
+{
+    gt911_filter_config_t config;
+    gt911_filter_track_t tracks[GT911_MAX_POINTS];
+} gt911_filter_t;
+
+/**
+ * @brief Initialize a filter with no active tracks.
+ *
+ * @param filter Filter
+ * @param config Settings, copied
+ */
+void gt911_filter_init(gt911_filter_t *filter, const gt911_filter_config_t *config);
+
+/**
+ * @brief Change the prediction horizon, for example to the measured touch-to-photon latency.
+ *
+ * @param filter Filter
+ * @param horizon_us Prediction horizon
+ */
+void gt911_filter_set_horizon(gt911_filter_t *filter, uint32_t horizon_us);
+
+/**
+ * @brief Filter a report in place.
+ *
+ * Points are matched to tracks by id. New ids start a track at the reported position,
+ * ids missing from the report and a release end their track.
+ *
+ * @param filter Filter
+ * @param touch Report, timestamp_us must be set
+ */
+void gt911_filter_apply(gt911_filter_t *filter, gt911_touch_t *touch);
+
+#endif // GT911_FILTER_H
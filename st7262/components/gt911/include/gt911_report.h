@@ -0,0 +1,49 @@
+#ifndef GT911_REPORT_H
+#define GT911_REPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gt911_types.h"
+#include "gt911_transport.h"
+
+#define GT911_REPORT_REG (uint16_t)0x814E // Point info, the point records follow it
+#define GT911_REPORT_POINT_SIZE 8         // Track id, X, Y, size and a reserved byte
+
+/**
+ * @brief Touch report as read from the point registers, raw controller coordinates.
+ */
+typedef struct
+{
+    uint8_t point_info; // Buffer status, large detect, proximity, key and touch count bits
+    uint8_t touches;    // Touch count of point_info, may exceed GT911_MAX_POINTS
+    gt911_point_t points[GT911_MAX_POINTS];
+} gt911_report_t;
+
+/**
+ * @brief Decode the point info byte and the point records that follow it.
+ *
+ * @param data Register bytes from GT911_REPORT_REG, 1 + GT911_REPORT_POINT_SIZE for each
+ *             record up to GT911_MAX_POINTS
+ * @param report Decoded report
+ */
+void gt911_report_decode(const uint8_t *data, gt911_report_t *report);
+
+/**
+ * @brief Read and acknowledge one report.
+ *
+ * Point info and the first record are contiguous, so a single touch is one read burst
+ * and one write that clears the buffer status. More touches add one read for the
+ * remaining records. Used by gt911_read(); only needs a transport, so the register
+ * emulator can check the decode and count the transfers on a host.
+ *
+ * @param transport Register access
+ * @param timeout_ms Deadline passed to the transport for each transfer
+ * @param report Decoded report, unchanged without a new report
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_NOT_FOUND: The buffer status shows no new report, nothing was acknowledged
+ *     - Otherwise: Error of the failed transfer
+ */
+esp_err_t gt911_report_read(const gt911_transport_t *transport, uint32_t timeout_ms, gt911_report_t *report);
+
+#endif // GT911_REPORT_H
@@ -0,0 +1,84 @@
+#ifndef GT911_RING_H
+#define GT911_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gt911_types.h"
+
+/**
+ * @brief Touch reports the ring can buffer, must be a power of two.
+ */
+#define GT911_RING_SIZE 32
+
+/**
+ * @brief Single-producer single-consumer ring of touch reports.
+ *
+ * The reader task pushes, one consumer (the LVGL task) pops. Neither side locks: the
+ * indices are published with acquire/release atomics and the latest report is kept
+ * in a sequence-locked slot, so it can be read even while the ring is full or empty.
+ * Only depends on the C standard library and GCC atomics.
+ */
+typedef struct
+{
+    gt911_touch_t frames[GT911_RING_SIZE];
+    uint32_t head; // Next slot the producer writes
+    uint32_t tail; // Next slot the consumer reads
+    gt911_touch_t latest;
+    uint32_t latest_seq; // Odd while the producer updates latest
+    /* Statistics */
+    uint32_t pushed;
+    uint32_t dropped; // Reports not buffered because the ring was full
+} gt911_ring_t;
+
+/**
+ * @brief Reset the ring.
+ *
+ * @param ring Ring
+ */
+void gt911_ring_init(gt911_ring_t *ring);
+
+/**
+ * @brief Add a report, producer side.
+ *
+ * The latest slot is always updated; when the ring is full the report is not buffered
+ * and counted in dropped.
+ *
+ * @param ring Ring
+ * @param touch Report
+ * @return
+ *     - true: Report buffered
+ *     - false: Ring full
+ */
+bool gt911_ring_push(gt911_ring_t *ring, const gt911_touch_t *touch);
+
+/**
+ * @brief Take the oldest buffered report, consumer side.
+ *
+ * @param ring Ring
+ * @param touch Output report
+ * @return
+ *     - true: A report was taken
+ *     - false: Ring empty
+ */
+bool gt911_ring_pop(gt911_ring_t *ring, gt911_touch_t *touch);
+
+/**
+ * @brief Number of buffered reports, consumer side.
+ *
+ * @param ring Ring
+ * @return Buffered reports
+ */
+uint32_t gt911_ring_count(const gt911_ring_t *ring);
+
+/**
+ * @brief Copy the most recent report without consuming anything.
+ *
+ * @param ring Ring
+ * @param touch Output report
+ * @return
+ *     - true: Success
+ *     - false: Nothing has been pushed yet
+ */
+bool gt911_ring_latest(gt911_ring_t *ring, gt911_touch_t *touch);
+
+#endif // GT911_RING_H
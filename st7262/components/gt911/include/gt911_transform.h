@@ -0,0 +1,100 @@
+#ifndef GT911_TRANSFORM_H
+#define GT911_TRANSFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "gt911_types.h"
+
+/**
+ * @brief 1.0 in the Q16 transform coefficients.
+ */
+#define GT911_TRANSFORM_ONE 65536
+
+/**
+ * @brief Q16 2x3 affine transform.
+ *
+ * x' = (a * x + b * y + c) / 65536
+ * y' = (d * x + e * y + f) / 65536
+ */
+typedef struct
+{
+    int32_t a, b, c;
+    int32_t d, e, f;
+} gt911_transform_t;
+
+/**
+ * @brief Transform that leaves points unchanged.
+ *
+ * @param t Output transform
+ */
+void gt911_transform_identity(gt911_transform_t *t);
+
+/**
+ * @brief Rotation of the controller coordinates, matching the ROTATION_* values.
+ *
+ * @param t Output transform
+ * @param rotation ROTATION_LEFT, ROTATION_INVERTED, ROTATION_RIGHT or ROTATION_NORMAL
+ * @param width Controller X resolution
+ * @param height Controller Y resolution
+ * @return
+ *     - true: Success
+ *     - false: Unknown rotation
+ */
+bool gt911_transform_rotation(gt911_transform_t *t, uint8_t rotation, uint16_t width, uint16_t height);
+
+/**
+ * @brief Scale from one resolution to another.
+ *
+ * @param t Output transform
+ * @param from_width, from_height Source resolution, not zero
+ * @param to_width, to_height Target resolution
+ * @return
+ *     - true: Success
+ *     - false: Zero source resolution
+ */
+bool gt911_transform_scale(gt911_transform_t *t, uint16_t from_width, uint16_t from_height, uint16_t to_width, uint16_t to_height);
+
+/**
+ * @brief Compose two transforms, out applies first and then second.
+ *
+ * out may alias either input.
+ *
+ * @param out Output transform
+ * @param first Transform applied first
+ * @param second Transform applied second
+ */
+void gt911_transform_compose(gt911_transform_t *out, const gt911_transform_t *first, const gt911_transform_t *second);
+
+/**
+ * @brief Invert a transform.
+ *
+ * @param out Output transform, may alias t
+ * @param t Transform
+ * @return
+ *     - true: Success
+ *     - false: t is singular
+ */
+bool gt911_transform_invert(gt911_transform_t *out, const gt911_transform_t *t);
+
+/**
+ * @brief Solve the transform that maps three points onto three others (3-point calibration).
+ *
+ * @param t Output transform
+ * @param from Measured points
+ * @param to Expected points
+ * @return
+ *     - true: Success
+ *     - false: The measured points are collinear
+ */
+bool gt911_transform_from_points(gt911_transform_t *t, const gt911_point_t from[3], const gt911_point_t to[3]);
+
+/**
+ * @brief Transform points in place, results are rounded and clamped to 0..65535.
+ *
+ * @param t Transform
+ * @param points Points
+ * @param count Number of points
+ */
+void gt911_transform_apply(const gt911_transform_t *t, gt911_point_t *points, uint8_t count);
+
+#endif // GT911_TRANSFORM_H
@@ -0,0 +1,48 @@
+#ifndef GT911_TRANSPORT_H
+#define GT911_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#if __has_include(<esp_err.h>)
+#include <esp_err.h>
+#else
+// Host builds without ESP-IDF: the codes the transport, the emulator and the report reader use
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_INVALID_SIZE 0x104
+#define ESP_ERR_NOT_FOUND 0x105
+#define ESP_ERR_TIMEOUT 0x107
+#endif
+
+/**
+ * @brief Register access used by the GT911 driver.
+ *
+ * gt911_init() installs an implementation on the i2c_master driver. Anything else that
+ * can read and write 16-bit addressed registers (a register emulator on the host, a
+ * shared bus wrapper) can be passed to gt911_init_with_transport() instead.
+ */
+typedef struct
+{
+    /**
+     * @brief Read len bytes starting at register reg, give up after timeout_ms.
+     */
+    esp_err_t (*read)(void *ctx, uint16_t reg, uint8_t *buf, size_t len, uint32_t timeout_ms);
+
+    /**
+     * @brief Write len bytes starting at register reg, give up after timeout_ms.
+     */
+    esp_err_t (*write)(void *ctx, uint16_t reg, const uint8_t *buf, size_t len, uint32_t timeout_ms);
+
+    /**
+     * @brief Bring a stuck bus back to idle (clock out SCL, reset the controller), may be NULL.
+     */
+    esp_err_t (*recover)(void *ctx);
+
+    void *ctx;
+} gt911_transport_t;
+
+#endif // GT911_TRANSPORT_H
@@ -0,0 +1,33 @@
+#ifndef GT911_TYPES_H
+#define GT911_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GT911_MAX_POINTS 5
+
+#define ROTATION_LEFT (uint8_t)0
+#define ROTATION_INVERTED (uint8_t)1
+#define ROTATION_RIGHT (uint8_t)2
+#define ROTATION_NORMAL (uint8_t)3
+
+// Touch point structure
+typedef struct
+{
+    uint8_t id;
+    uint16_t x;
+    uint16_t y;
+    uint16_t size;
+} gt911_point_t;
+
+// Touch report read from the controller
+typedef struct
+{
+    uint8_t touches;
+    bool is_touched;
+    gt911_point_t points[GT911_MAX_POINTS];
+    uint32_t sequence;    // Incremented for every report read from the controller
+    int64_t timestamp_us; // When the controller signalled the report (INT edge, or the read when polling)
+} gt911_touch_t;
+
+#endif // GT911_TYPES_H
@@ -0,0 +1,116 @@
+#include "boot_sched.h"
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "BOOT"
+
+static void boot_step_task(void *arg)
+{
+    boot_step_state_t *state = (boot_step_state_t *)arg;
+    boot_sched_t *sched = state->sched;
+    uint32_t index = state - sched->state;
+    const boot_step_t *step = &sched->steps[index];
+
+    if (step->deps != 0)
+    {
+        xEventGroupWaitBits(sched->done, step->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    state->start_us = esp_timer_get_time();
+    if ((__atomic_load_n(&sched->failed, __ATOMIC_ACQUIRE) & step->deps) != 0)
+    {
+        ESP_LOGW(TAG, "Skipping %s, a dependency failed", step->name);
+        state->result = ESP_ERR_INVALID_STATE;
+    }
+    else
+    {
+        state->result = step->fn(sched->ctx);
+    }
+    state->end_us = esp_timer_get_time();
+
+    if (state->result != ESP_OK)
+    {
+        __atomic_fetch_or(&sched->failed, BOOT_SCHED_BIT(index), __ATOMIC_RELEASE);
+    }
+    xEventGroupSetBits(sched->done, BOOT_SCHED_BIT(index));
+
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_sched_start(boot_sched_t *sched, const boot_step_t *steps, uint32_t count, void *ctx, UBaseType_t priority)
+{
+    if (sched == NULL || steps == NULL || count == 0 || count > BOOT_SCHED_MAX_STEPS)
+    {
+        ESP_LOGE(TAG, "Invalid arguments");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    sched->steps = steps;
+    sched->count = count;
+    sched->ctx = ctx;
+    sched->priority = priority;
+    sched->failed = 0;
+    sched->done = xEventGroupCreate();
+    if (sched->done == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sched->state[i] = (boot_step_state_t){.sched = sched, .result = ESP_ERR_TIMEOUT};
+        if (xTaskCreatePinnedToCore(boot_step_task, steps[i].name, BOOT_SCHED_STACK_SIZE, &sched->state[i], priority, NULL, steps[i].core) != pdPASS)
+        {
+            // Let the steps that depend on this one give up instead of waiting forever
+            ESP_LOGE(TAG, "Failed to create task for %s", steps[i].name);
+            sched->state[i].result = ESP_ERR_NO_MEM;
+            __atomic_fetch_or(&sched->failed, BOOT_SCHED_BIT(i), __ATOMIC_RELEASE);
+            xEventGroupSetBits(sched->done, BOOT_SCHED_BIT(i));
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+
+    return ret;
+}
+
+esp_err_t boot_sched_wait(boot_sched_t *sched, EventBits_t steps, TickType_t timeout)
+{
+    EventBits_t done = xEventGroupWaitBits(sched->done, steps, pdFALSE, pdTRUE, timeout);
+    if ((done & steps) != steps)
+    {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    return (__atomic_load_n(&sched->failed, __ATOMIC_ACQUIRE) & steps) != 0 ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t boot_sched_report(boot_sched_t *sched)
+{
+    esp_err_t ret = ESP_OK;
+    EventBits_t done = xEventGroupGetBits(sched->done);
+
+    for (uint32_t i = 0; i < sched->count; i++)
+    {
+        if ((done & BOOT_SCHED_BIT(i)) == 0)
+        {
+            ESP_LOGI(TAG, "%-8s still running", sched->steps[i].name);
+            continue;
+        }
+
+        const boot_step_state_t *state = &sched->state[i];
+        uint32_t duration_ms = (uint32_t)((state->end_us - state->start_us) / 1000);
+        bool over = sched->steps[i].budget_ms > 0 && duration_ms > sched->steps[i].budget_ms;
+        if (over)
+        {
+            ret = ESP_ERR_TIMEOUT;
+        }
+
+        ESP_LOG_LEVEL(over ? ESP_LOG_WARN : ESP_LOG_INFO, TAG, "%-8s core %d  start %4lld ms  took %4lu ms  budget %4lu ms  %s",
+                      sched->steps[i].name, (int)sched->steps[i].core, state->start_us / 1000, (unsigned long)duration_ms,
+                      (unsigned long)sched->steps[i].budget_ms, esp_err_to_name(state->result));
+    }
+
+    return ret;
+}
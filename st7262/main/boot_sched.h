@@ -0,0 +1,89 @@
+#ifndef BOOT_SCHED_H
+#define BOOT_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#define BOOT_SCHED_MAX_STEPS 8
+#define BOOT_SCHED_STACK_SIZE 4096
+#define BOOT_SCHED_BIT(step) ((EventBits_t)1 << (step))
+
+typedef esp_err_t (*boot_step_fn_t)(void *ctx);
+
+/**
+ * @brief One bring-up step, run in its own task once all steps in deps are done.
+ */
+typedef struct
+{
+    const char *name;
+    boot_step_fn_t fn;
+    EventBits_t deps;   // BOOT_SCHED_BIT() of the steps that must succeed first
+    BaseType_t core;    // Core of the step task, or tskNO_AFFINITY
+    uint32_t budget_ms; // Longest acceptable duration, 0 for no budget
+} boot_step_t;
+
+typedef struct boot_sched boot_sched_t;
+
+typedef struct
+{
+    boot_sched_t *sched;
+    int64_t start_us; // Since boot
+    int64_t end_us;
+    esp_err_t result;
+} boot_step_state_t;
+
+struct boot_sched
+{
+    const boot_step_t *steps;
+    uint32_t count;
+    void *ctx;
+    UBaseType_t priority;
+    EventGroupHandle_t done;
+    EventBits_t failed;
+    boot_step_state_t state[BOOT_SCHED_MAX_STEPS];
+};
+
+/**
+ * @brief Start a task for every step. A step waits for its dependencies and is skipped
+ * with ESP_ERR_INVALID_STATE when one of them failed.
+ *
+ * @param sched Scheduler, must stay valid until all steps are done
+ * @param steps Steps, indexed by their BOOT_SCHED_BIT()
+ * @param count Number of steps
+ * @param ctx Passed to every step
+ * @param priority Priority of the step tasks
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid arguments
+ *     - ESP_ERR_NO_MEM: Could not create the event group or a task. The steps that did
+ *       get a task still run, the others count as failed for their dependents.
+ */
+esp_err_t boot_sched_start(boot_sched_t *sched, const boot_step_t *steps, uint32_t count, void *ctx, UBaseType_t priority);
+
+/**
+ * @brief Wait until the given steps are done.
+ *
+ * @param sched Scheduler
+ * @param steps BOOT_SCHED_BIT() of the steps to wait for
+ * @param timeout Ticks to wait
+ * @return
+ *     - ESP_OK: All steps succeeded
+ *     - ESP_FAIL: A step failed or was skipped
+ *     - ESP_ERR_TIMEOUT: Not all steps are done
+ */
+esp_err_t boot_sched_wait(boot_sched_t *sched, EventBits_t steps, TickType_t timeout);
+
+/**
+ * @brief Log the start and duration of every finished step.
+ *
+ * @param sched Scheduler
+ * @return
+ *     - ESP_OK: All finished steps met their budget
+ *     - ESP_ERR_TIMEOUT: A step exceeded its budget
+ */
+esp_err_t boot_sched_report(boot_sched_t *sched);
+
+#endif // BOOT_SCHED_H
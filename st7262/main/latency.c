@@ -0,0 +1,175 @@
+#include "latency.h"
+#include <stdio.h>
+#include <string.h>
+
+enum
+{
+    STAGE_IDLE,
+    STAGE_READ,
+    STAGE_INVALIDATED,
+    STAGE_RENDERED,
+    STAGE_FLUSHED,
+};
+
+static const char *const span_names[LATENCY_SPANS] = {"input", "render", "scanout", "total"};
+
+static bool stage_advance(latency_t *lat, uint32_t from, uint32_t to)
+{
+    return __atomic_compare_exchange_n(&lat->stage, &from, to, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static void hist_record(latency_hist_t *hist, int64_t us)
+{
+    uint32_t value = us < 0 ? 0 : us > UINT32_MAX ? UINT32_MAX : (uint32_t)us;
+    uint32_t bin = value / LATENCY_BIN_US;
+
+    __atomic_fetch_add(&hist->bins[bin < LATENCY_BINS ? bin : LATENCY_BINS - 1], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELAXED);
+
+    uint32_t max = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    while (value > max && !__atomic_compare_exchange_n(&hist->max_us, &max, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static uint32_t hist_percentile(const latency_hist_t *hist, uint32_t pct)
+{
+    uint32_t count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED);
+    uint32_t max = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = ((uint64_t)count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t bin = 0; bin < LATENCY_BINS; bin++)
+    {
+        seen += __atomic_load_n(&hist->bins[bin], __ATOMIC_RELAXED);
+        if (seen >= rank)
+        {
+            uint32_t bound = (bin + 1) * LATENCY_BIN_US;
+            return bound < max ? bound : max;
+        }
+    }
+
+    return max;
+}
+
+void latency_init(latency_t *lat)
+{
+    memset(lat, 0, sizeof(*lat));
+}
+
+void latency_sample(latency_t *lat, uint32_t id, int64_t acquired_us, int64_t now_us)
+{
+    uint32_t stage = __atomic_load_n(&lat->stage, __ATOMIC_ACQUIRE);
+    if (stage > STAGE_READ)
+    {
+        __atomic_fetch_add(&lat->skipped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (stage == STAGE_READ)
+    {
+        __atomic_fetch_add(&lat->unchanged, 1, __ATOMIC_RELAXED);
+    }
+
+    lat->id = id;
+    lat->acquired_us = acquired_us != 0 ? acquired_us : now_us;
+    lat->read_us = now_us;
+    __atomic_store_n(&lat->stage, STAGE_READ, __ATOMIC_RELEASE);
+}
+
+uint32_t latency_sample_id(const latency_t *lat)
+{
+    return __atomic_load_n(&lat->stage, __ATOMIC_ACQUIRE) == STAGE_READ ? lat->id : 0;
+}
+
+void latency_invalidate(latency_t *lat, uint32_t id)
+{
+    if (id != 0 && latency_sample_id(lat) == id)
+    {
+        stage_advance(lat, STAGE_READ, STAGE_INVALIDATED);
+    }
+}
+
+void latency_frame_rendered(latency_t *lat)
+{
+    stage_advance(lat, STAGE_INVALIDATED, STAGE_RENDERED);
+}
+
+void latency_frame_flushed(latency_t *lat, int64_t now_us)
+{
+    if (__atomic_load_n(&lat->stage, __ATOMIC_ACQUIRE) == STAGE_RENDERED)
+    {
+        lat->flushed_us = now_us;
+        __atomic_store_n(&lat->stage, STAGE_FLUSHED, __ATOMIC_RELEASE);
+    }
+}
+
+bool latency_vsync(latency_t *lat, int64_t now_us)
+{
+    if (__atomic_load_n(&lat->stage, __ATOMIC_ACQUIRE) != STAGE_FLUSHED)
+    {
+        return false;
+    }
+
+    hist_record(&lat->spans[LATENCY_INPUT], lat->read_us - lat->acquired_us);
+    hist_record(&lat->spans[LATENCY_RENDER], lat->flushed_us - lat->read_us);
+    hist_record(&lat->spans[LATENCY_SCANOUT], now_us - lat->flushed_us);
+    hist_record(&lat->spans[LATENCY_TOTAL], now_us - lat->acquired_us);
+    __atomic_store_n(&lat->last_id, lat->id, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&lat->stage, STAGE_IDLE, __ATOMIC_RELEASE);
+    return true;
+}
+
+void latency_summary(const latency_t *lat, latency_span_t span, latency_summary_t *out)
+{
+    const latency_hist_t *hist = &lat->spans[span];
+
+    *out = (latency_summary_t){
+        .count = __atomic_load_n(&hist->count, __ATOMIC_RELAXED),
+        .p50_us = hist_percentile(hist, 50),
+        .p90_us = hist_percentile(hist, 90),
+        .p99_us = hist_percentile(hist, 99),
+        .max_us = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED),
+    };
+}
+
+void latency_reset(latency_t *lat)
+{
+    for (uint32_t span = 0; span < LATENCY_SPANS; span++)
+    {
+        latency_hist_t *hist = &lat->spans[span];
+        for (uint32_t bin = 0; bin < LATENCY_BINS; bin++)
+        {
+            __atomic_store_n(&hist->bins[bin], 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&hist->count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&hist->max_us, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&lat->unchanged, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&lat->skipped, 0, __ATOMIC_RELAXED);
+}
+
+size_t latency_format(const latency_t *lat, char *buf, size_t len)
+{
+    size_t pos = 0;
+
+    for (uint32_t span = 0; span < LATENCY_SPANS; span++)
+    {
+        latency_summary_t summary;
+        latency_summary(lat, (latency_span_t)span, &summary);
+        pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, "%s,%lu,%lu,%lu,%lu,%lu\n", span_names[span],
+                        (unsigned long)summary.count, (unsigned long)summary.p50_us, (unsigned long)summary.p90_us,
+                        (unsigned long)summary.p99_us, (unsigned long)summary.max_us);
+    }
+
+    pos += snprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, "samples,%lu,%lu,%lu\n",
+                    (unsigned long)__atomic_load_n(&lat->spans[LATENCY_TOTAL].count, __ATOMIC_RELAXED),
+                    (unsigned long)__atomic_load_n(&lat->unchanged, __ATOMIC_RELAXED),
+                    (unsigned long)__atomic_load_n(&lat->skipped, __ATOMIC_RELAXED));
+
+    return pos;
+}
@@ -0,0 +1,131 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define LATENCY_BIN_US 500
+#define LATENCY_BINS 128 // 0..64 ms, the last bin also counts everything above
+
+/**
+ * @brief Spans of the touch-to-photon path of one sample.
+ */
+typedef enum
+{
+    LATENCY_INPUT,   // Controller sample to indev read
+    LATENCY_RENDER,  // Indev read to the last area of the frame copied to the frame buffer
+    LATENCY_SCANOUT, // Frame buffer to the vsync that starts showing it
+    LATENCY_TOTAL,   // Controller sample to vsync
+    LATENCY_SPANS,
+} latency_span_t;
+
+/**
+ * @brief Linear histogram, LATENCY_BIN_US wide bins.
+ */
+typedef struct
+{
+    uint32_t bins[LATENCY_BINS];
+    uint32_t count;
+    uint32_t max_us;
+} latency_hist_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_summary_t;
+
+/**
+ * @brief Touch-to-photon latency tracker.
+ *
+ * Follows one sample at a time through the display path: tagged when the indev reads
+ * it, then the invalidation it causes, the frame that renders it, the copy of the last
+ * area of that frame and finally the vsync. Only an invalidation passed the id of the
+ * sample in flight advances it, so redraws from animations or timers do not complete a
+ * sample early. Samples that change nothing are counted as unchanged, samples arriving
+ * while one is in flight as skipped.
+ *
+ * Every stage takes its timestamp as an argument and there are no ESP-IDF dependencies,
+ * so a host can drive it with emulated touch and a simulated vsync. latency_vsync() is
+ * safe from an interrupt, the other stages may run in different tasks.
+ */
+typedef struct
+{
+    uint32_t stage;
+    uint32_t id;
+    int64_t acquired_us;
+    int64_t read_us;
+    int64_t flushed_us;
+    latency_hist_t spans[LATENCY_SPANS];
+    uint32_t last_id;   // Sample id of the last measurement
+    uint32_t unchanged; // Samples that caused no redraw
+    uint32_t skipped;   // Samples read while another one was in flight
+} latency_t;
+
+void latency_init(latency_t *lat);
+
+/**
+ * @brief Tag a sample read by the input device.
+ *
+ * @param lat Tracker
+ * @param id Sample id, e.g. the GT911 report sequence
+ * @param acquired_us Time the controller produced the sample, 0 when unknown
+ * @param now_us Current time
+ */
+void latency_sample(latency_t *lat, uint32_t id, int64_t acquired_us, int64_t now_us);
+
+/**
+ * @brief Id of the sample waiting for its invalidation.
+ *
+ * @return The id passed to latency_sample(), 0 when no sample waits
+ */
+uint32_t latency_sample_id(const latency_t *lat);
+
+/**
+ * @brief The UI invalidated an area while handling the input sample id.
+ *
+ * Call only for invalidations caused by the input device, e.g. from the indev read
+ * pass. Ignored unless id is the sample in flight.
+ */
+void latency_invalidate(latency_t *lat, uint32_t id);
+
+/**
+ * @brief The last area of a frame was handed to the panel.
+ */
+void latency_frame_rendered(latency_t *lat);
+
+/**
+ * @brief The last area of the frame reached the frame buffer.
+ */
+void latency_frame_flushed(latency_t *lat, int64_t now_us);
+
+/**
+ * @brief Vsync, resolves a flushed sample.
+ *
+ * @return Whether a sample was measured
+ */
+bool latency_vsync(latency_t *lat, int64_t now_us);
+
+/**
+ * @brief Percentiles of one span, bounded by the bin width.
+ */
+void latency_summary(const latency_t *lat, latency_span_t span, latency_summary_t *out);
+
+/**
+ * @brief Clear the histograms and counters, a sample in flight is kept.
+ */
+void latency_reset(latency_t *lat);
+
+/**
+ * @brief Format the report, one line "span,count,p50_us,p90_us,p99_us,max_us" per span
+ * and a final "samples,measured,unchanged,skipped" line.
+ *
+ * @return Characters written without the terminating zero, or the size needed when buf is too small
+ */
+size_t latency_format(const latency_t *lat, char *buf, size_t len);
+
+#endif // LATENCY_H
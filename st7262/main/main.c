@@ -7,129 +7,708 @@
 #include <esp_psram.h>
 #include <esp_system.h>
 #include <esp_heap_caps.h>
+#include <nvs_flash.h>
 #include <esp_lcd_st7262.h>
+#include "boot_sched.h"
+#include "latency.h"
 
 #define USE_TOUCH 1
+// #define USE_TOUCH_AUTO_SCAN 1 // Drop the GT911 to an idle scan profile, not measured on hardware yet
 #define USE_LVGL 1
 // #define USE_LVGL_PORT 1
+// #define USE_DIRECT_RENDER 1
+// #define USE_ON_DEMAND_REFRESH 1
 //  #define TEST_FULL_SCREEN 1
+#define USE_CORE_PIPELINE 1
+// #define USE_LV_BENCHMARK 1 // Run the LVGL benchmark instead of the widgets demo
+// #define TRACE_INVALIDATIONS 1 // Log every invalidated area, replay the log with the host dirty suite
+
+#define DIRECT_RENDER_FBS 2
+#define DISPLAY_ROTATION LV_DISPLAY_ROTATION_0
+#define DISPLAY_TIMING_PROFILE "16MHZ"
+
+// Partial rendering: the budget of internal RAM is split into DRAW_BUF_COUNT buffers of whole
+// rows, 1 or 2 as LVGL takes. With two, LVGL renders into one while the other is copied to the
+// frame buffer.
+#define DRAW_BUF_COUNT 2
+#define DRAW_BUF_BUDGET_BYTES (800 * 480 * 2 / 4)
+// #define DRAW_BUF_SWEEP 1 // Time full-screen redraws with every draw_buf_settings entry at startup
+#define DRAW_BUF_SWEEP_FRAMES 60
+
+#define STATS_LOG_INTERVAL_MS 10000
+#define LATENCY_MIN_SAMPLES 32 // Measurements per interval before the touch filter horizon follows them
+#define UI_MAX_SLEEP_MS 500     // Longest sleep of the UI loop without LVGL timers due
+#define UI_FLUSH_WAIT_MS 20     // Re-check interval while LVGL waits for a flush
+
+// pdMS_TO_TICKS() rounds down, which at the default 100 Hz tick turns anything below 10 ms
+// into no sleep at all. Round up instead, a timer runs at most a tick late.
+#define UI_MS_TO_TICKS(ms) (((ms) + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS)
+
+// Boot budgets, checked and logged once bring-up is done
+#define BOOT_FIRST_FRAME_BUDGET_MS 600
+#define BOOT_NVS_BUDGET_MS 50
+#define BOOT_PANEL_BUDGET_MS 150
+#define BOOT_LVGL_BUDGET_MS 50
+#define BOOT_TOUCH_BUDGET_MS 250
 
 #define STACK_SIZE 8192
 #define TASK_PRIORITY 9
 
+#ifdef USE_CORE_PIPELINE
+// UI logic and rendering on one core, panel copies and touch I/O on the other. LVGL's
+// draw unit threads are not pinned and take whichever core is free.
+#define UI_CORE 1
+#define IO_CORE 0
+#else
+#define UI_CORE tskNO_AFFINITY
+#define IO_CORE tskNO_AFFINITY
+#endif
+
 #define TAG "ESP32-MAIN"
 
 #ifdef USE_LVGL
 #include <lvgl.h>
 #include <lv_demos.h>
 
+// Touch-to-photon latency, from the GT911 sample to the vsync that shows its effect
+static latency_t touch_latency;
+static uint32_t input_sample; // Sample read in the current indev pass, 0 outside of it
+
+// The UI loop sleeps until the next LVGL timer, touch input, a vsync with pending changes or a flush
+typedef struct
+{
+    uint32_t wakeups;
+    uint32_t notified;      // Wake-ups by a notification rather than the timer deadline
+    uint32_t vsync_renders; // Refreshes started at a vsync
+    uint64_t handler_us;    // Time spent in lv_timer_handler()
+    uint32_t handler_max_us;
+} ui_loop_stats_t;
+
+static TaskHandle_t ui_task;
+static uint32_t ui_invalidated;  // Areas wait to be rendered
+static uint32_t ui_vsync_render; // Set by the vsync that woke the loop for them
+static ui_loop_stats_t ui_stats;
+
+static void ui_wake(void)
+{
+    TaskHandle_t task = __atomic_load_n(&ui_task, __ATOMIC_ACQUIRE);
+    if (task != NULL)
+    {
+        xTaskNotifyGive(task);
+    }
+}
+
 #if USE_TOUCH
 #include <gt911.h>
 
 #define TOUCH_GT911_SCL 20
 #define TOUCH_GT911_SDA 19
-#define TOUCH_GT911_INT -1
+#define TOUCH_GT911_INT 18
 #define TOUCH_GT911_RST 38
 #define TOUCH_GT911_ROTATION ROTATION_NORMAL
-#define TOUCH_MAP_X1 480
-#define TOUCH_MAP_X2 0
-#define TOUCH_MAP_Y1 272
-#define TOUCH_MAP_Y2 0
+#define TOUCH_GT911_WIDTH 480  // Controller resolution, scaled to the display by the driver
+#define TOUCH_GT911_HEIGHT 272
 
 static gt911_handle_t gt911_dev;
+static bool touch_ready = false; // Set once the reader task runs, touch comes up after the first frame
+
+// GT911 rotation matching each lv_display_rotation_t, ROTATION_INVERTED reports panel coordinates on this board
+static const uint8_t touch_rotation[] = {ROTATION_INVERTED, ROTATION_LEFT, ROTATION_NORMAL, ROTATION_RIGHT};
+
+static void touch_report(const gt911_touch_t *touch, void *ctx)
+{
+#ifdef USE_TOUCH_AUTO_SCAN
+    // Back to the interactive profile after this touch is released
+    if (touch->is_touched)
+    {
+        gt911_wake_scan(&gt911_dev);
+    }
+#endif
+    ui_wake();
+}
 
-void init_touch(void)
+esp_err_t init_touch(uint16_t scr_width, uint16_t scr_height)
 {
     ESP_LOGI(TAG, "Initializing GT911 touchscreen");
 
     // Initialize the GT911 touchscreen controller
     esp_err_t ret = gt911_init(&gt911_dev, TOUCH_GT911_SDA, TOUCH_GT911_SCL, TOUCH_GT911_INT, TOUCH_GT911_RST,
-                               TOUCH_MAP_X1, TOUCH_MAP_Y1, I2C_NUM_0, GT911_ADDR1);
+                               TOUCH_GT911_WIDTH, TOUCH_GT911_HEIGHT, I2C_NUM_0, GT911_ADDR1);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to initialize GT911: %s", esp_err_to_name(ret));
-        return;
+        return ret;
     }
 
-    // Set rotation if needed
-    ret = gt911_set_rotation(&gt911_dev, ROTATION_INVERTED);
+    // Keep touch in sync with the display rotation
+    ret = gt911_set_rotation(&gt911_dev, touch_rotation[DISPLAY_ROTATION]);
     if (ret != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to set rotation: %s", esp_err_to_name(ret));
     }
 
+    // Points are reported in display coordinates, LVGL uses them as is
+    ret = gt911_set_screen_size(&gt911_dev, scr_width, scr_height);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to set screen size: %s", esp_err_to_name(ret));
+    }
+
+    // Smooth resting jitter and predict drags one frame ahead to hide the display latency
+    const gt911_filter_config_t filter_config = GT911_FILTER_DEFAULT_CONFIG();
+    ret = gt911_set_filter(&gt911_dev, &filter_config);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to set touch filter: %s", esp_err_to_name(ret));
+    }
+
+#ifdef USE_TOUCH_AUTO_SCAN
+    // Report at 200 Hz while in use, drop to 50 Hz and a single finger when idle
+    const gt911_scan_profile_t scan_interactive = GT911_SCAN_PROFILE_INTERACTIVE();
+    const gt911_scan_profile_t scan_idle = GT911_SCAN_PROFILE_IDLE();
+    ret = gt911_set_auto_scan(&gt911_dev, &scan_interactive, &scan_idle, GT911_IDLE_AFTER_MS);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to set scan profiles: %s", esp_err_to_name(ret));
+    }
+#endif
+
+    // Every buffered report wakes the UI loop, which then reads it right away
+    ret = gt911_set_report_cb(&gt911_dev, touch_report, NULL);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to set report callback: %s", esp_err_to_name(ret));
+    }
+
+    // I2C only happens in the reader task, and only when the GT911 raises INT
+    ret = gt911_start_reader(&gt911_dev, TASK_PRIORITY, IO_CORE);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to start touch reader: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    __atomic_store_n(&touch_ready, true, __ATOMIC_RELEASE);
     ESP_LOGI(TAG, "GT911 initialized successfully");
+    return ESP_OK;
 }
 
 void input_read(lv_indev_t *indev, lv_indev_data_t *data)
 {
-    static bool input_initalized = false;
-    if (!input_initalized)
+    if (!__atomic_load_n(&touch_ready, __ATOMIC_ACQUIRE))
     {
-        init_touch();
-        input_initalized = true;
+        data->state = LV_INDEV_STATE_REL;
+        return;
     }
 
-    if (gt911_read(&gt911_dev) == ESP_OK)
+    // Replay buffered reports in order so short taps between two polls are not lost,
+    // fall back to the latest state when nothing new arrived
+    gt911_touch_t touch;
+    esp_err_t ret = gt911_pop_touch(&gt911_dev, &touch);
+    if (ret == ESP_OK)
     {
-        data->state = gt911_dev.is_touched ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        data->continue_reading = gt911_pending_touches(&gt911_dev) > 0;
+        latency_sample(&touch_latency, touch.sequence, touch.timestamp_us, esp_timer_get_time());
+        input_sample = touch.sequence;
+    }
+    else
+    {
+        ret = gt911_get_touch(&gt911_dev, &touch);
+    }
+
+    // Release reports carry no points, LVGL takes the release position from the point,
+    // so it has to stay where the finger was lifted
+    static lv_point_t last_point;
+    if (ret == ESP_OK && touch.is_touched)
+    {
+        last_point.x = touch.points[0].x;
+        last_point.y = touch.points[0].y;
+    }
 
-        int32_t touch_last_x = 0;
-        int32_t touch_last_y = 0;
+    data->state = ret == ESP_OK && touch.is_touched ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    data->point = last_point;
+}
+
+// LVGL handles the read within the indev timer, so the widgets invalidate what a sample
+// changed before it returns; invalidations outside of it are not caused by touch
+static void input_read_timer(lv_timer_t *timer)
+{
+    input_sample = 0;
+    lv_indev_read_timer_cb(timer);
+    input_sample = 0;
+}
 
-        gt911_map_to_screen(&gt911_dev, 800, 480, gt911_dev.points[0].x, gt911_dev.points[0].y, &touch_last_x, &touch_last_y);
+#endif
 
-        data->point.x = touch_last_x;
-        data->point.y = touch_last_y;
+#ifdef TRACE_INVALIDATIONS
+static uint32_t trace_frame;
+#endif
+
+static void render_invalidated(lv_event_t *event)
+{
+#ifdef TRACE_INVALIDATIONS
+    const lv_area_t *area = (const lv_area_t *)lv_event_get_param(event);
+    ESP_LOGI(TAG, "inv %lu %ld %ld %ld %ld", trace_frame, area->x1, area->y1, area->x2, area->y2);
+#endif
+    if (input_sample != 0)
+    {
+        latency_invalidate(&touch_latency, input_sample);
     }
-    else
+    __atomic_store_n(&ui_invalidated, 1, __ATOMIC_RELEASE);
+}
+
+static void render_started(lv_event_t *event)
+{
+#ifdef TRACE_INVALIDATIONS
+    trace_frame++;
+#endif
+    __atomic_store_n(&ui_invalidated, 0, __ATOMIC_RELEASE);
+}
+
+static bool render_vsync(int64_t timestamp_us, void *user_ctx)
+{
+    latency_vsync(&touch_latency, timestamp_us);
+
+    // Start rendering pending changes at the vsync, a full frame before the next scanout
+    if (!__atomic_exchange_n(&ui_invalidated, 0, __ATOMIC_ACQ_REL) || ui_task == NULL)
     {
-        data->state = LV_INDEV_STATE_REL;
+        return false;
     }
+
+    BaseType_t task_woken = pdFALSE;
+    __atomic_store_n(&ui_vsync_render, 1, __ATOMIC_RELEASE);
+    vTaskNotifyGiveFromISR(ui_task, &task_woken);
+    return task_woken == pdTRUE;
 }
 
+#ifndef USE_DIRECT_RENDER
+// The flush callback queues the copy of an area on the draw worker, whose completion
+// reports the flush done to LVGL. LVGL renders the next area into its other buffer in
+// the meantime. Only LVGL's own one or two buffers are used: a pool of more would have to
+// be swapped into the display behind LVGL's back.
+typedef struct
+{
+    lv_display_t *display;
+    bool last; // Last area of a frame
+} draw_flush_t;
+
+typedef struct
+{
+    uint32_t count;
+    size_t budget;
+} draw_buf_setting_t;
+
+#ifdef DRAW_BUF_SWEEP
+// One and two buffers in a tenth, a sixth and a quarter of the screen, then a third split in two
+static const draw_buf_setting_t draw_buf_settings[] = {
+    {1, 800 * 480 * 2 / 10},
+    {2, 800 * 480 * 2 / 10},
+    {1, 800 * 480 * 2 / 6},
+    {2, 800 * 480 * 2 / 6},
+    {1, 800 * 480 * 2 / 4},
+    {2, 800 * 480 * 2 / 4},
+    {2, 800 * 480 * 2 / 3},
+};
 #endif
 
+static uint8_t *draw_mem[2];
+static draw_flush_t draw_flushes[2]; // One per buffer, LVGL flushes a buffer once before reusing it
+static uint32_t draw_buf_count;
+static uint32_t draw_buf_rows;
+static size_t draw_buf_size;
+static size_t draw_heap_used;
+static uint32_t draw_frames;
+static uint32_t draw_stalls;   // Areas LVGL had to wait for
+static uint32_t draw_flushing; // Copies not yet reported to LVGL
+static uint32_t draw_flush_waiting;
+
+static void render_flush_done(esp_lcd_panel_st7262_panel_handle_t panel, esp_err_t result, void *user_ctx)
+{
+    draw_flush_t *flush = (draw_flush_t *)user_ctx;
+
+    if (flush->last)
+    {
+        latency_frame_flushed(&touch_latency, esp_timer_get_time());
+    }
+
+    lv_display_flush_ready(flush->display);
+    __atomic_fetch_sub(&draw_flushing, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&draw_flush_waiting, 0, __ATOMIC_SEQ_CST))
+    {
+        ui_wake();
+    }
+}
+
 static void render_flush_display(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
 {
     esp_lcd_panel_st7262_panel_handle_t panel = (esp_lcd_panel_st7262_panel_handle_t)lv_display_get_user_data(display);
-    esp_lcd_panel_st7262_draw_bitmap(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, (uint16_t *)px_map);
+
+    draw_flush_t *flush = px_map == draw_mem[0] ? &draw_flushes[0] : px_map == draw_mem[1] ? &draw_flushes[1] : NULL;
+    if (flush == NULL)
+    {
+        esp_lcd_panel_st7262_draw_bitmap(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+        lv_display_flush_ready(display);
+        return;
+    }
+
+    flush->display = display;
+    flush->last = lv_display_flush_is_last(display);
+    if (flush->last)
+    {
+        latency_frame_rendered(&touch_latency);
+        __atomic_fetch_add(&draw_frames, 1, __ATOMIC_RELAXED);
+    }
+
+    __atomic_fetch_add(&draw_flushing, 1, __ATOMIC_SEQ_CST);
+    esp_err_t error = esp_lcd_panel_st7262_draw_bitmap_async(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map,
+                                                             render_flush_done, flush, portMAX_DELAY);
+    if (error != ESP_OK)
+    {
+        error = esp_lcd_panel_st7262_draw_bitmap(panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, px_map);
+        render_flush_done(panel, error, flush);
+    }
+}
+
+// Sleep while LVGL waits for a flush instead of letting it spin
+static void render_flush_wait(lv_display_t *display)
+{
+    bool slept = false;
+
+    __atomic_store_n(&draw_flush_waiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&draw_flushing, __ATOMIC_SEQ_CST) > 0)
+    {
+        if (!slept)
+        {
+            __atomic_fetch_add(&draw_stalls, 1, __ATOMIC_RELAXED);
+        }
+        ulTaskNotifyTake(pdTRUE, UI_MS_TO_TICKS(UI_FLUSH_WAIT_MS));
+        slept = true;
+    }
+    __atomic_store_n(&draw_flush_waiting, 0, __ATOMIC_SEQ_CST);
+
+    // The notification may have been a touch or vsync wake-up for the loop, keep it pending
+    if (slept)
+    {
+        xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    }
+}
+
+static void free_draw_bufs(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        heap_caps_free(draw_mem[i]);
+        draw_mem[i] = NULL;
+    }
+}
+
+// Also replaces the buffers of a running display, between frames of the UI task. On failure the
+// display must not render before buffers are set again.
+static esp_err_t setup_draw_bufs(lv_display_t *display, uint32_t count, size_t budget)
+{
+    count = count < 1 ? 1 : count > 2 ? 2 : count;
+
+    // The worker may still copy out of the current buffers
+    if (__atomic_load_n(&draw_flushing, __ATOMIC_SEQ_CST) > 0)
+    {
+        render_flush_wait(display);
+    }
+    free_draw_bufs();
+
+    // Split the budget into whole rows of the rendered (rotated) width
+    uint32_t width = lv_display_get_horizontal_resolution(display);
+    uint32_t stride = lv_draw_buf_width_to_stride(width, LV_COLOR_FORMAT_RGB565);
+    uint32_t rows = budget / count / stride;
+    if (rows == 0)
+    {
+        ESP_LOGE(TAG, "Draw buffer budget of %u bytes is below %lu rows", budget, count);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t size = rows * stride;
+
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        draw_mem[i] = (uint8_t *)heap_caps_aligned_alloc(LV_DRAW_BUF_ALIGN, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (draw_mem[i] == NULL)
+        {
+            ESP_LOGE(TAG, "Could not allocate %lu draw buffers of %u bytes", count, size);
+            free_draw_bufs();
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    draw_heap_used = free_before - heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    draw_buf_count = count;
+    draw_buf_rows = rows;
+    draw_buf_size = size;
+
+    lv_display_set_buffers(display, draw_mem[0], draw_mem[1], size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+
+    ESP_LOGI(TAG, "Draw buffers: %lu x %u bytes (%lu rows), %u bytes of internal heap, %u bytes left", count, size, rows,
+             draw_heap_used, heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    return ESP_OK;
+}
+
+static void report_draw(uint32_t interval_ms)
+{
+    uint32_t frames = __atomic_exchange_n(&draw_frames, 0, __ATOMIC_RELAXED);
+    uint32_t stalls = __atomic_exchange_n(&draw_stalls, 0, __ATOMIC_RELAXED);
+
+    ESP_LOGI(TAG, "Draw buffers %lu x %u bytes, %u bytes heap: %lu.%lu fps, %lu stalled areas", draw_buf_count, draw_buf_size,
+             draw_heap_used, frames * 1000 / interval_ms, frames * 10000 / interval_ms % 10, stalls);
+}
+
+#ifdef DRAW_BUF_SWEEP
+// Redraw the whole screen DRAW_BUF_SWEEP_FRAMES times with every setting and log the frame rate,
+// the stalled areas and the internal heap, then go back to DRAW_BUF_COUNT and DRAW_BUF_BUDGET_BYTES.
+// The screen content stays the same as no LVGL timer runs in between.
+static esp_err_t sweep_draw_bufs(lv_display_t *display)
+{
+    for (size_t i = 0; i < sizeof(draw_buf_settings) / sizeof(draw_buf_settings[0]); i++)
+    {
+        const draw_buf_setting_t *setting = &draw_buf_settings[i];
+        if (setup_draw_bufs(display, setting->count, setting->budget) != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Draw buffer sweep: %lu buffers in %u bytes skipped", setting->count, setting->budget);
+            continue;
+        }
+        size_t heap_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+
+        __atomic_store_n(&draw_stalls, 0, __ATOMIC_RELAXED);
+        int64_t start_us = esp_timer_get_time();
+        for (uint32_t frame = 0; frame < DRAW_BUF_SWEEP_FRAMES; frame++)
+        {
+            lv_obj_invalidate(lv_screen_active());
+            lv_refr_now(display);
+        }
+        uint32_t stalls = __atomic_load_n(&draw_stalls, __ATOMIC_RELAXED);
+        render_flush_wait(display);
+        uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+        uint32_t fps_x10 = (uint32_t)((uint64_t)DRAW_BUF_SWEEP_FRAMES * 10000000 / elapsed_us);
+
+        ESP_LOGI(TAG, "Draw buffer sweep: %lu x %u bytes (%lu rows): %lu.%lu fps, %lu stalled areas, %u bytes heap, %u bytes internal free",
+                 draw_buf_count, draw_buf_size, draw_buf_rows, fps_x10 / 10, fps_x10 % 10, stalls, draw_heap_used, heap_free);
+    }
+
+    esp_err_t error = setup_draw_bufs(display, DRAW_BUF_COUNT, DRAW_BUF_BUDGET_BYTES);
+    __atomic_store_n(&draw_frames, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&draw_stalls, 0, __ATOMIC_RELAXED);
+    lv_obj_invalidate(lv_screen_active());
+    return error;
+}
+#endif
+#else
+#define DIRECT_RENDER_CACHE_LINE_PX 16
+#define DIRECT_RENDER_FLIP_TIMEOUT_MS 100
+
+// LVGL renders straight into the panel's frame buffers, the panel cannot rotate them
+_Static_assert(DISPLAY_ROTATION == LV_DISPLAY_ROTATION_0, "USE_DIRECT_RENDER does not support DISPLAY_ROTATION");
+
+static esp_lcd_panel_st7262_dirty_t direct_dirty[2];
+static esp_lcd_panel_st7262_dirty_t *current_dirty = &direct_dirty[0];
+static esp_lcd_panel_st7262_dirty_t *previous_dirty = &direct_dirty[1];
+static esp_lcd_panel_st7262_dirty_t direct_writeback;
+
+static void render_flush_direct(lv_display_t *display, const lv_area_t *area, uint8_t *px_map)
+{
+    esp_lcd_panel_st7262_panel_handle_t panel = (esp_lcd_panel_st7262_panel_handle_t)lv_display_get_user_data(display);
+
+    esp_lcd_panel_st7262_dirty_add(current_dirty, area->x1, area->y1, area->x2 + 1, area->y2 + 1);
+    if (!lv_display_flush_is_last(display))
+    {
+        lv_display_flush_ready(display);
+        return;
+    }
+
+    // LVGL copied the areas of the previous frame into this buffer before rendering,
+    // they have to reach PSRAM together with the areas rendered in this frame
+    esp_lcd_panel_st7262_dirty_coalesce(current_dirty);
+    esp_lcd_panel_st7262_dirty_reset(&direct_writeback);
+    for (uint32_t i = 0; i < current_dirty->count; i++)
+    {
+        const esp_lcd_panel_st7262_rect_t *rect = &current_dirty->rects[i];
+        esp_lcd_panel_st7262_dirty_add(&direct_writeback, rect->x_start, rect->y_start, rect->x_end, rect->y_end);
+    }
+    for (uint32_t i = 0; i < previous_dirty->count; i++)
+    {
+        const esp_lcd_panel_st7262_rect_t *rect = &previous_dirty->rects[i];
+        esp_lcd_panel_st7262_dirty_add(&direct_writeback, rect->x_start, rect->y_start, rect->x_end, rect->y_end);
+    }
+    esp_lcd_panel_st7262_writeback_dirty(panel, px_map, &direct_writeback);
+    latency_frame_rendered(&touch_latency);
+    latency_frame_flushed(&touch_latency, esp_timer_get_time());
+
+    esp_lcd_panel_st7262_dirty_t *swap = previous_dirty;
+    previous_dirty = current_dirty;
+    current_dirty = swap;
+    esp_lcd_panel_st7262_dirty_reset(current_dirty);
+
+    // Passing the frame buffer itself queues the swap, the single row it writes back is already clean
+    esp_err_t error = esp_lcd_panel_st7262_draw_bitmap(panel, 0, 0, 1, 1, px_map);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not queue the frame buffer swap: %s", esp_err_to_name(error));
+        lv_display_flush_ready(display);
+        return;
+    }
+
+    // LVGL renders the next frame into the buffer on screen now, it must not start before the swap
+    while ((error = esp_lcd_panel_st7262_wait_flip(panel, DIRECT_RENDER_FLIP_TIMEOUT_MS)) == ESP_ERR_TIMEOUT)
+    {
+        ESP_LOGW(TAG, "No vsync for %d ms, still waiting for the frame buffer swap", DIRECT_RENDER_FLIP_TIMEOUT_MS);
+    }
+
     lv_display_flush_ready(display);
 }
+#endif
+
+static void report_ui_loop(uint32_t interval_ms)
+{
+    ui_loop_stats_t stats = ui_stats;
+    ui_stats = (ui_loop_stats_t){0};
+
+    ESP_LOGI(TAG, "UI loop: %lu wake-ups/s (%lu notified, %lu vsync renders), handler busy %llu.%llu%%, max %lu us",
+             stats.wakeups * 1000 / interval_ms, stats.notified, stats.vsync_renders, stats.handler_us / 10 / interval_ms,
+             stats.handler_us / interval_ms % 10, stats.handler_max_us);
+}
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+static uint32_t core_idle_us[portNUM_PROCESSORS];
+
+// Share of the interval each core spent outside its idle task. LVGL's draw units are unpinned,
+// compare the logs of builds with different CONFIG_LV_DRAW_SW_DRAW_UNIT_CNT to see where they run.
+static void report_cores(uint32_t interval_ms, bool log)
+{
+    char report[64];
+    size_t pos = 0;
+
+    for (BaseType_t core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        uint32_t idle_us = ulTaskGetRunTimeCounter(xTaskGetIdleTaskHandleForCore(core));
+        uint64_t idle_delta_us = idle_us - core_idle_us[core];
+        core_idle_us[core] = idle_us;
+
+        uint64_t interval_us = (uint64_t)interval_ms * 1000;
+        uint32_t busy_pct = interval_us > idle_delta_us ? (uint32_t)((interval_us - idle_delta_us) * 100 / interval_us) : 0;
+        pos += snprintf(report + pos, sizeof(report) - pos, " core%d %lu%%", core, busy_pct);
+    }
+
+    if (log)
+    {
+        ESP_LOGI(TAG, "CPU load, %d draw units:%s", LV_DRAW_SW_DRAW_UNIT_CNT, report);
+    }
+}
+#endif
+
+static void report_latency(void)
+{
+    char report[256];
+    latency_format(&touch_latency, report, sizeof(report));
+    ESP_LOGI(TAG, "Touch-to-photon latency (span,count,p50,p90,p99,max us):\n%s", report);
+
+#if USE_TOUCH
+    // Predict touches as far ahead as a typical sample takes to reach the screen
+    latency_summary_t total;
+    latency_summary(&touch_latency, LATENCY_TOTAL, &total);
+    if (total.count >= LATENCY_MIN_SAMPLES)
+    {
+        gt911_set_filter_horizon(&gt911_dev, total.p50_us);
+    }
+#endif
+
+    latency_reset(&touch_latency);
+}
 
 static uint32_t esp_tick(void)
 {
     return esp_timer_get_time() / 1000;
 }
 
-static void setup_lvgl(uint32_t width, uint32_t height, esp_lcd_panel_st7262_panel_handle_t panel)
+static esp_err_t init_lvgl(void)
 {
-    ESP_LOGI(TAG, "Setting up LVGL...");
-
     lv_init();
     lv_tick_set_cb(esp_tick);
 
+    return ESP_OK;
+}
+
+static void setup_lvgl(uint32_t width, uint32_t height, esp_lcd_panel_st7262_panel_handle_t panel)
+{
+    ESP_LOGI(TAG, "Setting up LVGL...");
+
     lv_display_t *disp_handle = lv_display_create(width, height);
-    lv_display_set_flush_cb(disp_handle, render_flush_display);
     lv_display_set_user_data(disp_handle, panel);
 
     lv_display_set_color_format(disp_handle, LV_COLOR_FORMAT_RGB565);
 
-    size_t size = width * height * sizeof(lv_color16_t) / 4;
-    lv_color16_t *draw_buf = (lv_color16_t *)heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-    if (draw_buf == NULL)
+    // Follow touch samples through invalidation, flush and vsync
+    latency_init(&touch_latency);
+    lv_display_add_event_cb(disp_handle, render_invalidated, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp_handle, render_started, LV_EVENT_REFR_START, NULL);
+    esp_err_t vsync_error = esp_lcd_panel_st7262_register_vsync_cb(panel, render_vsync, NULL);
+    if (vsync_error != ESP_OK)
     {
-        ESP_LOGE(TAG, "Could not allocate draw buffer memory");
+        ESP_LOGW(TAG, "Could not register the vsync callback: %s", esp_err_to_name(vsync_error));
+    }
+
+#ifdef USE_DIRECT_RENDER
+    void *fbs[ESP_LCD_PANEL_ST7262_MAX_FBS];
+    uint32_t num_fbs = 0;
+    esp_err_t error = esp_lcd_panel_st7262_get_frame_buffers(panel, fbs, &num_fbs);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not get panel frame buffers: %s", esp_err_to_name(error));
         return;
     }
 
-    lv_display_set_buffers(disp_handle, draw_buf, NULL, size, LV_DISP_RENDER_MODE_PARTIAL);
+    // LVGL renders into its first buffer first, which must not be the one on screen
+    size_t size = width * height * sizeof(lv_color16_t);
+    esp_lcd_panel_st7262_dirty_init(&direct_dirty[0], width, height, sizeof(lv_color16_t), DIRECT_RENDER_CACHE_LINE_PX, 0);
+    esp_lcd_panel_st7262_dirty_init(&direct_dirty[1], width, height, sizeof(lv_color16_t), DIRECT_RENDER_CACHE_LINE_PX, 0);
+    esp_lcd_panel_st7262_dirty_init(&direct_writeback, width, height, sizeof(lv_color16_t), DIRECT_RENDER_CACHE_LINE_PX, 0);
+    lv_display_set_flush_cb(disp_handle, render_flush_direct);
+    lv_display_set_buffers(disp_handle, num_fbs > 1 ? fbs[1] : fbs[0], num_fbs > 1 ? fbs[0] : NULL, size, LV_DISPLAY_RENDER_MODE_DIRECT);
+#else
+    lv_display_set_flush_cb(disp_handle, render_flush_display);
+    lv_display_set_flush_wait_cb(disp_handle, render_flush_wait);
+
+    // The panel rotates every flushed area, LVGL only renders in the rotated space
+    esp_err_t error = esp_lcd_panel_st7262_set_rotation(panel, (esp_lcd_panel_st7262_rotation_t)DISPLAY_ROTATION);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not set display rotation: %s", esp_err_to_name(error));
+        return;
+    }
+    lv_display_set_rotation(disp_handle, DISPLAY_ROTATION);
+
+    esp_lcd_panel_st7262_async_config_t async_config = ESP_LCD_PANEL_ST7262_ASYNC_DEFAULT_CONFIG();
+    async_config.queue_depth = 2;
+    async_config.task_core = IO_CORE;
+    error = esp_lcd_panel_st7262_async_start(panel, &async_config);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not start the draw worker: %s", esp_err_to_name(error));
+        return;
+    }
+
+    error = setup_draw_bufs(disp_handle, DRAW_BUF_COUNT, DRAW_BUF_BUDGET_BYTES);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not set up draw buffers: %s", esp_err_to_name(error));
+        return;
+    }
+#endif
 
     lv_indev_t *indev = lv_indev_create();
     lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev, input_read);
+    lv_timer_set_cb(lv_indev_get_read_timer(indev), input_read_timer);
 
+#ifdef USE_LV_BENCHMARK
+    lv_demo_benchmark();
+#else
     lv_demo_widgets();
+#endif
 
 #ifndef USE_TOUCH
     lv_demo_widgets_start_slideshow();
@@ -199,72 +778,277 @@ static void setup_lvgl_port(uint32_t width, uint32_t height, esp_lcd_panel_st726
 
 #endif
 
-void main_task(void *parg)
+typedef struct
 {
-    ESP_LOGI(TAG, "Main task started.");
-
+    esp_lcd_panel_st7262_conf_t panel_config;
     esp_lcd_panel_st7262_panel_t panel;
-    esp_lcd_panel_st7262_conf_t panel_config = ESP_LCD_PANEL_ST7262_8048S043;
+} board_t;
+
+static board_t board;
 
-    esp_err_t error = esp_lcd_panel_st7262_new(&panel_config, &panel);
+static esp_err_t boot_nvs(void *ctx)
+{
+    // NVS holds the GT911 configuration cache, which lets the touch controller skip a reflash at boot
+    esp_err_t error = nvs_flash_init();
+    if (error == ESP_ERR_NVS_NO_FREE_PAGES || error == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        nvs_flash_erase();
+        error = nvs_flash_init();
+    }
+    if (error != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to initialize NVS: %s", esp_err_to_name(error));
+    }
+
+    return error;
+}
+
+static esp_err_t boot_panel(void *ctx)
+{
+    board_t *b = (board_t *)ctx;
+
+    esp_err_t error = esp_lcd_panel_st7262_new(&b->panel_config, &b->panel);
     if (error != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to create ST7262 LCD panel: %s", esp_err_to_name(error));
-        return;
+        return error;
     }
 
-    error = esp_lcd_panel_st7262_reset(&panel);
+    error = esp_lcd_panel_st7262_reset(&b->panel);
     if (error != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to reset ST7262 LCD panel: %s", esp_err_to_name(error));
-        return;
+        return error;
     }
 
-    error = esp_lcd_panel_st7262_init(&panel);
+    error = esp_lcd_panel_st7262_init(&b->panel);
     if (error != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to initialize ST7262 LCD panel: %s", esp_err_to_name(error));
-        return;
+        return error;
     }
 
-    error = esp_lcd_panel_st7262_backlight_on_ff(&panel_config, true);
+    error = esp_lcd_panel_st7262_backlight_on_ff(&b->panel_config, true);
     if (error != ESP_OK)
     {
         ESP_LOGE(TAG, "Failed to turn on backlight: %s", esp_err_to_name(error));
-        return;
+        return error;
     }
 
 #if TEST_FULL_SCREEN
-    uint16_t *test_pixels = heap_caps_malloc(panel_config.width * panel_config.height * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    uint16_t *test_pixels = heap_caps_malloc(b->panel_config.width * b->panel_config.height * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     if (test_pixels != NULL)
     {
-        for (int i = 0; i < panel_config.width * panel_config.height; i++)
+        for (int i = 0; i < b->panel_config.width * b->panel_config.height; i++)
         {
             test_pixels[i] = 0xF800; // Bright red in RGB565 format
         }
-        esp_lcd_panel_st7262_draw_bitmap(&panel, 0, 0, panel_config.width - 1, panel_config.height - 1, test_pixels);
+        esp_lcd_panel_st7262_draw_bitmap(&b->panel, 0, 0, b->panel_config.width - 1, b->panel_config.height - 1, test_pixels);
         ESP_LOGI(TAG, "Drew test pattern");
         free(test_pixels);
     }
 #endif
 
+    return ESP_OK;
+}
+
 #ifdef USE_LVGL
-    setup_lvgl(panel_config.width, panel_config.height, &panel);
+static esp_err_t boot_lvgl(void *ctx)
+{
+    return init_lvgl();
+}
+
+#if USE_TOUCH
+static esp_err_t boot_touch(void *ctx)
+{
+    board_t *b = (board_t *)ctx;
+
+    // LVGL rotates by 90 or 270 degrees for odd rotations
+    bool swapped = (DISPLAY_ROTATION & 1) != 0;
+    return init_touch(swapped ? b->panel_config.height : b->panel_config.width, swapped ? b->panel_config.width : b->panel_config.height);
+}
+#endif
+#endif
+
+// Bring-up steps, the panel on core 0 and LVGL and touch on core 1 run concurrently
+enum
+{
+    BOOT_NVS,
+    BOOT_PANEL,
+#ifdef USE_LVGL
+    BOOT_LVGL,
+#if USE_TOUCH
+    BOOT_TOUCH,
+#endif
+#endif
+    BOOT_STEPS,
+};
+
+static const boot_step_t boot_steps[BOOT_STEPS] = {
+    [BOOT_NVS] = {.name = "nvs", .fn = boot_nvs, .core = 0, .budget_ms = BOOT_NVS_BUDGET_MS},
+    [BOOT_PANEL] = {.name = "panel", .fn = boot_panel, .core = 0, .budget_ms = BOOT_PANEL_BUDGET_MS},
+#ifdef USE_LVGL
+    [BOOT_LVGL] = {.name = "lvgl", .fn = boot_lvgl, .core = 1, .budget_ms = BOOT_LVGL_BUDGET_MS},
+#if USE_TOUCH
+    // The GT911 reset waits ~110 ms, the first frame does not wait for it
+    [BOOT_TOUCH] = {.name = "touch", .fn = boot_touch, .deps = BOOT_SCHED_BIT(BOOT_NVS), .core = 1, .budget_ms = BOOT_TOUCH_BUDGET_MS},
+#endif
+#endif
+};
+
+static boot_sched_t boot;
+
+static void boot_report_when_done(bool *reported)
+{
+    if (!*reported && boot_sched_wait(&boot, BOOT_SCHED_BIT(BOOT_STEPS) - 1, 0) != ESP_ERR_TIMEOUT)
+    {
+        if (boot_sched_report(&boot) != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Boot steps exceeded their budget");
+        }
+        *reported = true;
+    }
+}
+
+void main_task(void *parg)
+{
+    ESP_LOGI(TAG, "Main task started.");
+
+#ifdef USE_LVGL
+    // Touch, vsync and flush completion wake this task from here on
+    __atomic_store_n(&ui_task, xTaskGetCurrentTaskHandle(), __ATOMIC_RELEASE);
+#endif
+
+    board.panel_config = ESP_LCD_PANEL_ST7262_8048S043;
+
+    const esp_lcd_panel_st7262_timing_profile_t *timing = esp_lcd_panel_st7262_timing_find(
+        ESP_LCD_PANEL_ST7262_8048S043_TIMINGS, ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT, DISPLAY_TIMING_PROFILE);
+    if (timing != NULL)
+    {
+        esp_lcd_panel_st7262_set_timing_profile(&board.panel_config, timing);
+    }
+    else
+    {
+        ESP_LOGW(TAG, "Unknown timing profile %s, keeping the default timing", DISPLAY_TIMING_PROFILE);
+    }
+#ifdef USE_DIRECT_RENDER
+    board.panel_config.scanout.num_fbs = DIRECT_RENDER_FBS;
+#endif
+#ifdef USE_ON_DEMAND_REFRESH
+    // Stop streaming the frame buffer from PSRAM while the UI is static, needs direct GDMA reads
+    board.panel_config.scanout.bounce_buffer_lines = 0;
+    board.panel_config.scanout.refresh_on_demand = true;
+#endif
+
+    esp_err_t error = boot_sched_start(&boot, boot_steps, BOOT_STEPS, &board, TASK_PRIORITY);
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to start bring-up: %s", esp_err_to_name(error));
+        return;
+    }
+    bool boot_reported = false;
+
+#ifdef USE_LVGL
+    error = boot_sched_wait(&boot, BOOT_SCHED_BIT(BOOT_PANEL) | BOOT_SCHED_BIT(BOOT_LVGL), portMAX_DELAY);
+    if (error != ESP_OK)
+    {
+        boot_sched_report(&boot);
+        return;
+    }
+
+    setup_lvgl(board.panel_config.width, board.panel_config.height, &board.panel);
+
+    lv_refr_now(NULL);
+    int64_t first_frame_ms = esp_timer_get_time() / 1000;
+    if (first_frame_ms > BOOT_FIRST_FRAME_BUDGET_MS)
+    {
+        ESP_LOGW(TAG, "First frame after %lld ms, budget %d ms", first_frame_ms, BOOT_FIRST_FRAME_BUDGET_MS);
+    }
+    else
+    {
+        ESP_LOGI(TAG, "First frame after %lld ms, budget %d ms", first_frame_ms, BOOT_FIRST_FRAME_BUDGET_MS);
+    }
+#if defined(DRAW_BUF_SWEEP) && !defined(USE_DIRECT_RENDER)
+    error = sweep_draw_bufs(lv_display_get_default());
+    if (error != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not restore the draw buffers after the sweep: %s", esp_err_to_name(error));
+        return;
+    }
+#endif
+
+    int64_t stats_logged_us = esp_timer_get_time();
+    lv_timer_t *refr_timer = lv_display_get_refr_timer(lv_display_get_default());
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    report_cores(0, false);
+#endif
 
     while (true)
     {
-        lv_timer_handler();
-        vTaskDelay(pdMS_TO_TICKS(5));
+        if (__atomic_exchange_n(&ui_vsync_render, 0, __ATOMIC_ACQ_REL))
+        {
+            lv_timer_ready(refr_timer);
+            ui_stats.vsync_renders++;
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        uint32_t next_ms = lv_timer_handler();
+        uint32_t handler_us = (uint32_t)(esp_timer_get_time() - start_us);
+        ui_stats.handler_us += handler_us;
+        ui_stats.handler_max_us = handler_us > ui_stats.handler_max_us ? handler_us : ui_stats.handler_max_us;
+
+        boot_report_when_done(&boot_reported);
+
+        int64_t now_us = esp_timer_get_time();
+        if (now_us - stats_logged_us >= STATS_LOG_INTERVAL_MS * 1000)
+        {
+            uint32_t interval_ms = (now_us - stats_logged_us) / 1000;
+#if ESP_LCD_PANEL_ST7262_STATS
+            esp_lcd_panel_st7262_log_stats(&board.panel, ESP_LCD_PANEL_ST7262_STATS_CSV, true);
+#endif
+            report_latency();
+            report_ui_loop(interval_ms);
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+            report_cores(interval_ms, true);
+#endif
+#ifndef USE_DIRECT_RENDER
+            report_draw(interval_ms);
+#endif
+            stats_logged_us = now_us;
+        }
+
+        // Sleep until the next LVGL timer is due (LV_NO_TIMER_READY without timers), or until
+        // touch input, a vsync with pending changes or a flush wakes the loop. At least one
+        // tick, so lower priority tasks on this core still run.
+        next_ms = next_ms < UI_MAX_SLEEP_MS ? next_ms : UI_MAX_SLEEP_MS;
+        TickType_t ticks = UI_MS_TO_TICKS(next_ms);
+        if (ulTaskNotifyTake(pdTRUE, ticks > 0 ? ticks : 1) > 0)
+        {
+            ui_stats.notified++;
+        }
+        ui_stats.wakeups++;
+    }
+#else
+    error = boot_sched_wait(&boot, BOOT_SCHED_BIT(BOOT_PANEL), portMAX_DELAY);
+    if (error != ESP_OK)
+    {
+        boot_sched_report(&boot);
+        return;
     }
-#elif USE_LVGL_PORT
-    setup_lvgl_port(panel_config.width, panel_config.height, &panel);
+
+#ifdef USE_LVGL_PORT
+    setup_lvgl_port(board.panel_config.width, board.panel_config.height, &board.panel);
+    boot_sched_wait(&boot, BOOT_SCHED_BIT(BOOT_STEPS) - 1, portMAX_DELAY);
+    boot_report_when_done(&boot_reported);
 #else
     while (true)
     {
         vTaskDelay(pdMS_TO_TICKS(1000));
+        boot_report_when_done(&boot_reported);
         ESP_LOGI(TAG, "Main task running...");
     }
 #endif
+#endif
 }
 
 void app_main(void)
@@ -287,7 +1071,7 @@ void app_main(void)
 
 #ifndef USE_LVGL_PORT
     TaskHandle_t main_task_handle = NULL;
-    xTaskCreate(main_task, "main_task", STACK_SIZE, NULL, TASK_PRIORITY, &main_task_handle);
+    xTaskCreatePinnedToCore(main_task, "main_task", STACK_SIZE, NULL, TASK_PRIORITY, &main_task_handle, UI_CORE);
 #else
     main_task(NULL);
 #endif
@@ -0,0 +1,62 @@
+/**
+ * @file host_test.h
+ * @brief Minimal check macros and suite registration for the host tests.
+ */
+
+#ifndef _HOST_TEST_H_
+#define _HOST_TEST_H_
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+extern int host_test_failures;
+// Optional suite argument, e.g. a trace file to replay
+extern const char *host_test_arg;
+
+#define CHECK(cond)                                                               \
+    do                                                                            \
+    {                                                                             \
+        if (!(cond))                                                              \
+        {                                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            host_test_failures++;                                                 \
+        }                                                                         \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                                            \
+    do                                                                                            \
+    {                                                                                             \
+        long long _a = (long long)(a), _b = (long long)(b);                                       \
+        if (_a != _b)                                                                             \
+        {                                                                                         \
+            fprintf(stderr, "%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+            host_test_failures++;                                                                 \
+        }                                                                                         \
+    } while (0)
+
+static inline int64_t host_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Suites, one per module
+void test_flip(void);
+void test_dirty(void);
+void test_pixel(void);
+void test_rotate(void);
+void test_queue(void);
+void test_refresh(void);
+void test_emu(void);
+void test_report(void);
+void test_filter(void);
+void test_transform(void);
+void test_ring(void);
+void test_latency(void);
+void test_bandwidth(void);
+void test_timing(void);
+void test_stats(void);
+
+#endif
@@ -0,0 +1,55 @@
+#include <string.h>
+#include "host_test.h"
+
+int host_test_failures;
+const char *host_test_arg;
+
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} host_suite_t;
+
+static const host_suite_t suites[] = {
+    {"flip", test_flip},
+    {"dirty", test_dirty},
+    {"pixel", test_pixel},
+    {"rotate", test_rotate},
+    {"queue", test_queue},
+    {"refresh", test_refresh},
+    {"emu", test_emu},
+    {"report", test_report},
+    {"filter", test_filter},
+    {"transform", test_transform},
+    {"ring", test_ring},
+    {"latency", test_latency},
+    {"bandwidth", test_bandwidth},
+    {"timing", test_timing},
+    {"stats", test_stats},
+};
+
+int main(int argc, char **argv)
+{
+    int ran = 0;
+    host_test_arg = argc > 2 ? argv[2] : NULL;
+    for (size_t i = 0; i < sizeof(suites) / sizeof(suites[0]); i++)
+    {
+        if (argc > 1 && strcmp(argv[1], suites[i].name) != 0)
+        {
+            continue;
+        }
+
+        int before = host_test_failures;
+        suites[i].run();
+        printf("%-10s %s\n", suites[i].name, host_test_failures == before ? "ok" : "FAILED");
+        ran++;
+    }
+
+    if (ran == 0)
+    {
+        fprintf(stderr, "Unknown suite %s\n", argv[1]);
+        return 2;
+    }
+
+    return host_test_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "host_test.h"
+#include "esp_lcd_st7262_bandwidth.h"
+
+// 8048S043 with the porches of ESP_LCD_PANEL_ST7262_8048S043: 820 x 500 clocks per frame
+static esp_lcd_panel_st7262_bandwidth_params_t panel_params(uint32_t pclk_hz, uint32_t bounce_lines, uint32_t burst)
+{
+    return (esp_lcd_panel_st7262_bandwidth_params_t){
+        .h_res = 800,
+        .v_res = 480,
+        .h_blank = 4 + 8 + 8,
+        .v_blank = 4 + 8 + 8,
+        .pclk_hz = pclk_hz,
+        .bytes_per_px = 2,
+        .bounce_buffer_lines = bounce_lines,
+        .dma_burst_size = burst,
+    };
+}
+
+static void test_bandwidth_points(void)
+{
+    esp_lcd_panel_st7262_bandwidth_t out;
+
+    // Direct GDMA: 160 MB/s, half for the CPU, 64 / (64 + 32) burst efficiency, 62 % stream
+    // efficiency leaves 33.07 MB/s, 16.53 MHz of RGB565
+    esp_lcd_panel_st7262_bandwidth_params_t params = panel_params(16 * 1000 * 1000, 0, 0);
+    CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    CHECK_EQ(out.available_bytes_per_s, 33066666);
+    CHECK_EQ(out.required_bytes_per_s, 32000000);
+    CHECK_EQ(out.max_pclk_hz, 16533333);
+    CHECK_EQ(out.fps_x100, 3902);
+    CHECK_EQ(out.max_fps_x100, 4032);
+    CHECK(out.sustainable);
+
+    params.pclk_hz = 21 * 1000 * 1000;
+    CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    CHECK(!out.sustainable);
+
+    // Bounce buffers: the CPU copy at 90 % spreads a line over the whole line time, blanking included
+    params = panel_params(16 * 1000 * 1000, 20, 0);
+    CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    CHECK_EQ(out.available_bytes_per_s, 47999999);
+    CHECK_EQ(out.required_bytes_per_s, 31219512);
+    CHECK_EQ(out.max_pclk_hz, 24599999);
+    CHECK(out.sustainable);
+
+    params.pclk_hz = 21 * 1000 * 1000;
+    CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    CHECK(out.sustainable);
+
+    // Smaller bursts pay the fixed overhead more often
+    esp_lcd_panel_st7262_bandwidth_t small;
+    params = panel_params(16 * 1000 * 1000, 0, 32);
+    CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &small));
+    CHECK(small.max_pclk_hz < 16533333);
+
+    // Invalid input
+    params = panel_params(16 * 1000 * 1000, 0, 0);
+    params.h_res = 0;
+    CHECK(!esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    params = panel_params(16 * 1000 * 1000, 0, 0);
+    params.bytes_per_px = 0;
+    CHECK(!esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+    CHECK(!esp_lcd_panel_st7262_bandwidth_estimate(NULL, &out));
+    CHECK(!esp_lcd_panel_st7262_bandwidth_estimate(&params, NULL));
+}
+
+// The settings report, the same figures esp_lcd_panel_st7262_new() logs on the target
+static void test_bandwidth_report(void)
+{
+    const uint32_t bounce_lines[] = {0, 10, 20, 40};
+    const uint32_t bursts[] = {32, 64};
+
+    printf("bandwidth: %-6s %-6s %12s %10s %8s %8s %8s\n", "bounce", "burst", "avail B/s", "max PCLK", "max fps", "16 MHz", "21 MHz");
+    for (size_t b = 0; b < sizeof(bounce_lines) / sizeof(bounce_lines[0]); b++)
+    {
+        for (size_t s = 0; s < sizeof(bursts) / sizeof(bursts[0]); s++)
+        {
+            esp_lcd_panel_st7262_bandwidth_t out, at16, at21;
+            esp_lcd_panel_st7262_bandwidth_params_t params = panel_params(16 * 1000 * 1000, bounce_lines[b], bursts[s]);
+            CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &out));
+            at16 = out;
+            params.pclk_hz = 21 * 1000 * 1000;
+            CHECK(esp_lcd_panel_st7262_bandwidth_estimate(&params, &at21));
+
+            // The limits agree with the check at the requested PCLK
+            CHECK_EQ(at16.sustainable, out.max_pclk_hz >= 16 * 1000 * 1000);
+            CHECK_EQ(at21.sustainable, out.max_pclk_hz >= 21 * 1000 * 1000);
+
+            printf("bandwidth: %-6u %-6u %12u %10u %5u.%02u %8s %8s\n", bounce_lines[b], bursts[s], out.available_bytes_per_s,
+                   out.max_pclk_hz, out.max_fps_x100 / 100, out.max_fps_x100 % 100, at16.sustainable ? "ok" : "over",
+                   at21.sustainable ? "ok" : "over");
+        }
+    }
+}
+
+void test_bandwidth(void)
+{
+    test_bandwidth_points();
+    test_bandwidth_report();
+}
@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_lcd_st7262_dirty.h"
+
+#define DIRTY_W 800
+#define DIRTY_H 480
+#define DIRTY_BPP 2
+#define DIRTY_CACHE_LINE_PX 16 // 32-byte PSRAM cache line of RGB565
+#define DIRTY_MAX_AREAS 256
+
+typedef struct
+{
+    int x1, y1, x2, y2; // Inclusive, like lv_area_t
+} trace_area_t;
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t calls_before;
+    uint64_t bytes_before;
+    uint64_t lines_before; // Bytes of the cache lines the separate copies write back
+    uint64_t bytes_union;
+    uint64_t calls_after;
+    uint64_t bytes_after;
+} replay_totals_t;
+
+static uint8_t covered[DIRTY_H][DIRTY_W];
+
+static void replay_frame(esp_lcd_panel_st7262_dirty_t *dirty, const trace_area_t *areas, uint32_t count, replay_totals_t *totals)
+{
+    esp_lcd_panel_st7262_dirty_reset(dirty);
+    memset(covered, 0, sizeof(covered));
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const trace_area_t *a = &areas[i];
+        esp_lcd_panel_st7262_dirty_add(dirty, a->x1, a->y1, a->x2 + 1, a->y2 + 1);
+        // Without the tracker every area is one draw_bitmap call of its own
+        totals->calls_before++;
+        totals->bytes_before += (uint64_t)(a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1) * DIRTY_BPP;
+        int line_start = a->x1 - a->x1 % DIRTY_CACHE_LINE_PX;
+        int line_end = a->x2 + 1 + (DIRTY_CACHE_LINE_PX - (a->x2 + 1) % DIRTY_CACHE_LINE_PX) % DIRTY_CACHE_LINE_PX;
+        line_end = line_end > DIRTY_W ? DIRTY_W : line_end;
+        totals->lines_before += (uint64_t)(line_end - line_start) * (a->y2 - a->y1 + 1) * DIRTY_BPP;
+        for (int y = a->y1; y <= a->y2; y++)
+        {
+            memset(&covered[y][a->x1], 1, a->x2 - a->x1 + 1);
+        }
+    }
+
+    uint32_t rects = esp_lcd_panel_st7262_dirty_coalesce(dirty);
+    totals->calls_after += rects;
+    for (uint32_t i = 0; i < rects; i++)
+    {
+        const esp_lcd_panel_st7262_rect_t *r = &dirty->rects[i];
+        CHECK(r->x_start >= 0 && r->y_start >= 0 && r->x_end <= DIRTY_W && r->y_end <= DIRTY_H);
+        CHECK(r->x_start % DIRTY_CACHE_LINE_PX == 0);
+        CHECK(r->x_end % DIRTY_CACHE_LINE_PX == 0 || r->x_end == DIRTY_W);
+        totals->bytes_after += (uint64_t)(r->x_end - r->x_start) * (r->y_end - r->y_start) * DIRTY_BPP;
+        for (int y = r->y_start; y < r->y_end; y++)
+        {
+            memset(&covered[y][r->x_start], 2, r->x_end - r->x_start);
+        }
+    }
+
+    // Every invalidated pixel must be written back, count the union for reference
+    uint32_t missed = 0;
+    for (int y = 0; y < DIRTY_H; y++)
+    {
+        for (int x = 0; x < DIRTY_W; x++)
+        {
+            missed += covered[y][x] == 1;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const trace_area_t *a = &areas[i];
+        for (int y = a->y1; y <= a->y2; y++)
+        {
+            for (int x = a->x1; x <= a->x2; x++)
+            {
+                if (covered[y][x] == 2)
+                {
+                    covered[y][x] = 3;
+                    totals->bytes_union += DIRTY_BPP;
+                }
+            }
+        }
+    }
+    CHECK_EQ(missed, 0);
+    totals->frames++;
+}
+
+// Lines hold "inv <frame> <x1> <y1> <x2> <y2>" anywhere, so raw serial logs replay as well
+static bool replay_trace(const char *path, replay_totals_t *totals)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open trace %s\n", path);
+        return false;
+    }
+
+    esp_lcd_panel_st7262_dirty_t dirty;
+    CHECK(esp_lcd_panel_st7262_dirty_init(&dirty, DIRTY_W, DIRTY_H, DIRTY_BPP, DIRTY_CACHE_LINE_PX, 0));
+
+    static trace_area_t areas[DIRTY_MAX_AREAS];
+    uint32_t count = 0;
+    long frame = -1;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        const char *inv = strstr(line, "inv ");
+        long f;
+        trace_area_t a;
+        if (line[0] == '#' || inv == NULL || sscanf(inv, "inv %ld %d %d %d %d", &f, &a.x1, &a.y1, &a.x2, &a.y2) != 5)
+        {
+            continue;
+        }
+
+        if (f != frame && count > 0)
+        {
+            replay_frame(&dirty, areas, count, totals);
+            count = 0;
+        }
+        frame = f;
+
+        // LVGL clips invalidations to the screen, so should the trace
+        a.x1 = a.x1 < 0 ? 0 : a.x1;
+        a.y1 = a.y1 < 0 ? 0 : a.y1;
+        a.x2 = a.x2 >= DIRTY_W ? DIRTY_W - 1 : a.x2;
+        a.y2 = a.y2 >= DIRTY_H ? DIRTY_H - 1 : a.y2;
+        if (a.x1 <= a.x2 && a.y1 <= a.y2 && count < DIRTY_MAX_AREAS)
+        {
+            areas[count++] = a;
+        }
+    }
+    if (count > 0)
+    {
+        replay_frame(&dirty, areas, count, totals);
+    }
+    fclose(file);
+
+    // The tracker's own statistics agree with the replay
+    CHECK_EQ(dirty.rects_emitted, totals->calls_after);
+    CHECK_EQ(dirty.bytes_emitted, totals->bytes_after);
+    return true;
+}
+
+static void test_dirty_basics(void)
+{
+    esp_lcd_panel_st7262_dirty_t dirty;
+    CHECK(!esp_lcd_panel_st7262_dirty_init(&dirty, 0, DIRTY_H, DIRTY_BPP, DIRTY_CACHE_LINE_PX, 0));
+    CHECK(esp_lcd_panel_st7262_dirty_init(&dirty, DIRTY_W, DIRTY_H, DIRTY_BPP, DIRTY_CACHE_LINE_PX, 0));
+
+    // Clipped away entirely
+    CHECK(!esp_lcd_panel_st7262_dirty_add(&dirty, DIRTY_W, 0, DIRTY_W + 10, 10));
+
+    // Nearly identical areas merge, areas whose bounding box costs more than a call stay separate
+    CHECK(esp_lcd_panel_st7262_dirty_add(&dirty, 10, 10, 50, 50));
+    CHECK(esp_lcd_panel_st7262_dirty_add(&dirty, 12, 12, 52, 52));
+    CHECK(esp_lcd_panel_st7262_dirty_add(&dirty, 40, 40, 80, 80));
+    CHECK(esp_lcd_panel_st7262_dirty_add(&dirty, 500, 300, 700, 400));
+    CHECK_EQ(esp_lcd_panel_st7262_dirty_coalesce(&dirty), 3);
+    CHECK_EQ(dirty.rects[0].x_start, 0);
+    CHECK_EQ(dirty.rects[0].x_end, 64);
+    CHECK_EQ(dirty.rects[0].y_start, 10);
+    CHECK_EQ(dirty.rects[0].y_end, 52);
+
+    // More areas than slots are folded into the cheapest rectangle
+    esp_lcd_panel_st7262_dirty_reset(&dirty);
+    for (int i = 0; i < ESP_LCD_PANEL_ST7262_DIRTY_MAX_RECTS * 2; i++)
+    {
+        CHECK(esp_lcd_panel_st7262_dirty_add(&dirty, (i % 8) * 100, (i / 8) * 100, (i % 8) * 100 + 20, (i / 8) * 100 + 20));
+    }
+    CHECK(dirty.count <= ESP_LCD_PANEL_ST7262_DIRTY_MAX_RECTS);
+}
+
+void test_dirty(void)
+{
+    test_dirty_basics();
+
+    if (host_test_arg == NULL)
+    {
+        return;
+    }
+
+    replay_totals_t totals = {0};
+    CHECK(replay_trace(host_test_arg, &totals));
+    CHECK(totals.frames > 0);
+    CHECK(totals.calls_after <= totals.calls_before);
+
+    // Cost in the tracker's own model, bytes plus the per-call overhead expressed in bytes
+    uint64_t cost_before = totals.lines_before + totals.calls_before * ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES;
+    uint64_t cost_after = totals.bytes_after + totals.calls_after * ESP_LCD_PANEL_ST7262_CALL_OVERHEAD_BYTES;
+    CHECK(cost_after <= cost_before);
+    CHECK(totals.bytes_after <= totals.lines_before);
+    printf("dirty: %llu frames, invalidated pixels %llu bytes\n", (unsigned long long)totals.frames, (unsigned long long)totals.bytes_union);
+    printf("dirty: before %llu calls %llu bytes (%llu in cache lines), after %llu calls %llu bytes, cost %llu -> %llu\n",
+           (unsigned long long)totals.calls_before, (unsigned long long)totals.bytes_before, (unsigned long long)totals.lines_before,
+           (unsigned long long)totals.calls_after,
+           (unsigned long long)totals.bytes_after, (unsigned long long)cost_before, (unsigned long long)cost_after);
+}
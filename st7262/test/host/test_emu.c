@@ -0,0 +1,140 @@
+#include <string.h>
+#include "host_test.h"
+#include "gt911_emu.h"
+#include "gt911_report.h"
+
+#define EMU_MAX_EVENTS 1024
+#define EMU_POLL_US 5000 // Reader poll interval, half the trace's report interval
+
+static gt911_emu_event_t trace[EMU_MAX_EVENTS];
+
+static size_t load_trace(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("emu: cannot open %s\n", path);
+        host_test_failures++;
+        return 0;
+    }
+
+    char line[256];
+    size_t len = 0;
+    while (len < EMU_MAX_EVENTS && fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        CHECK(gt911_emu_parse_event(line, &trace[len]));
+        len++;
+    }
+    fclose(file);
+
+    return len;
+}
+
+static void test_emu_config(void)
+{
+    gt911_emu_t emu;
+    gt911_emu_init(&emu);
+    gt911_transport_t transport = gt911_emu_transport(&emu);
+
+    // Refreshing the block applies it only with a valid checksum
+    uint8_t config[0x80FF - 0x8047 + 2];
+    CHECK_EQ(transport.read(transport.ctx, 0x8047, config, sizeof(config) - 1, 10), ESP_OK);
+    config[sizeof(config) - 1] = 1;
+    CHECK_EQ(transport.write(transport.ctx, 0x8047, config, sizeof(config), 10), ESP_OK);
+    CHECK_EQ(emu.stats.config_applied, 1);
+    config[0x8056 - 0x8047]++;
+    CHECK_EQ(transport.write(transport.ctx, 0x8047, config, sizeof(config), 10), ESP_OK);
+    CHECK_EQ(emu.stats.config_rejected, 1);
+
+    // Out of range and failing transfers
+    uint8_t byte;
+    CHECK_EQ(transport.read(transport.ctx, 0x8000, &byte, 1, 10), ESP_ERR_INVALID_ARG);
+    emu.fail_next = 1;
+    gt911_report_t report;
+    CHECK_EQ(gt911_report_read(&transport, 10, &report), ESP_ERR_TIMEOUT);
+}
+
+// Poll the emulator like the reader task without INT and check every report against
+// the trace, together with the transfers each read took
+static void test_emu_replay(const gt911_emu_event_t *events, size_t len)
+{
+    gt911_emu_t emu;
+    gt911_emu_init(&emu);
+    gt911_emu_play(&emu, events, len, 0, false);
+    gt911_transport_t transport = gt911_emu_transport(&emu);
+
+    size_t next = 0;
+    uint32_t polls = 0;
+    uint32_t empty_polls = 0;
+    int64_t end_us = events[len - 1].time_us + 2 * EMU_POLL_US;
+    int64_t start = host_now_us();
+    for (int64_t now = 0; now <= end_us; now += EMU_POLL_US)
+    {
+        gt911_emu_advance(&emu, now);
+
+        uint32_t transactions = emu.stats.transactions;
+        gt911_report_t report;
+        esp_err_t ret = gt911_report_read(&transport, 10, &report);
+        uint32_t used = emu.stats.transactions - transactions;
+        polls++;
+
+        if (ret == ESP_ERR_NOT_FOUND)
+        {
+            // Only the status burst when there is nothing to read
+            CHECK_EQ(used, 1);
+            empty_polls++;
+            continue;
+        }
+
+        CHECK_EQ(ret, ESP_OK);
+        CHECK(next < len);
+        if (next >= len)
+        {
+            break;
+        }
+        const gt911_emu_event_t *expected = &events[next++];
+        CHECK_EQ(report.touches, expected->touches);
+        for (uint8_t i = 0; i < expected->touches && i < GT911_MAX_POINTS; i++)
+        {
+            CHECK_EQ(report.points[i].id, expected->points[i].id);
+            CHECK_EQ(report.points[i].x, expected->points[i].x);
+            CHECK_EQ(report.points[i].y, expected->points[i].y);
+            CHECK_EQ(report.points[i].size, expected->points[i].size);
+        }
+
+        // Status and first record in one burst, the other records in a second, one clear
+        CHECK_EQ(used, expected->touches > 1 ? 3 : 2);
+    }
+    int64_t elapsed = host_now_us() - start;
+
+    CHECK_EQ(next, len);
+    CHECK_EQ(emu.stats.frames_read, len);
+    CHECK_EQ(emu.stats.frames_overrun, 0);
+
+    printf("emu: %zu reports, %u polls (%u empty), %.2f transfers and %.1f bytes per report, %u us bus per report, %.0f ns host per poll\n",
+           len, polls, empty_polls, (double)(emu.stats.transactions - empty_polls) / len,
+           (double)(emu.stats.bytes_read + emu.stats.bytes_written - empty_polls * (1 + GT911_REPORT_POINT_SIZE)) / len,
+           gt911_emu_bus_us_per_frame(&emu), elapsed * 1000.0 / polls);
+}
+
+void test_emu(void)
+{
+    test_emu_config();
+
+    if (host_test_arg == NULL)
+    {
+        printf("emu: no trace given, usage: st7262_host_tests emu <trace.csv>\n");
+        return;
+    }
+
+    size_t len = load_trace(host_test_arg);
+    CHECK(len > 0);
+    if (len > 0)
+    {
+        test_emu_replay(trace, len);
+    }
+}
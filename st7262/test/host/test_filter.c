@@ -0,0 +1,212 @@
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "gt911_filter.h"
+#include "gt911_emu.h"
+
+#define FILTER_REPORT_US 10000  // GT911 report interval
+#define FILTER_LATENCY_US 16000 // Touch-to-photon latency the prediction compensates
+#define FILTER_WARMUP 5         // Reports before the track has settled
+#define FILTER_MAX_EVENTS 1024
+
+typedef struct
+{
+    const char *name;
+    double x0, v, a; // Position, px/s and px/s^2 along x
+    double noise;    // Uniform sensor noise, +- pixels
+    uint32_t reports;
+} filter_motion_t;
+
+typedef struct
+{
+    double jitter;  // RMS frame-to-frame motion of the output beyond the finger's own
+    double lag;     // Mean distance to the finger at the time the frame is shown
+    double max_err;
+} filter_result_t;
+
+static uint32_t lcg_state = 7;
+
+static double noise(double range)
+{
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return ((double)(lcg_state >> 8) / (1 << 24) * 2 - 1) * range;
+}
+
+static double motion_x(const filter_motion_t *motion, double t_s)
+{
+    return motion->x0 + motion->v * t_s + motion->a * t_s * t_s / 2;
+}
+
+// Feed one synthetic finger through the filter (config NULL for the raw reports) and
+// compare every output with where the finger is FILTER_LATENCY_US later
+static filter_result_t replay_motion(const filter_motion_t *motion, const gt911_filter_config_t *config)
+{
+    gt911_filter_t filter;
+    if (config != NULL)
+    {
+        gt911_filter_init(&filter, config);
+    }
+
+    filter_result_t result = {0};
+    double prev_x = 0, prev_y = 0;
+    uint32_t counted = 0;
+    lcg_state = 7;
+    for (uint32_t i = 0; i < motion->reports; i++)
+    {
+        double t_s = i * FILTER_REPORT_US / 1e6;
+        gt911_touch_t touch = {
+            .touches = 1,
+            .is_touched = true,
+            .timestamp_us = (int64_t)i * FILTER_REPORT_US,
+        };
+        touch.points[0] = (gt911_point_t){
+            .id = 0,
+            .x = (uint16_t)lround(motion_x(motion, t_s) + noise(motion->noise)),
+            .y = (uint16_t)lround(200 + noise(motion->noise)),
+        };
+        if (config != NULL)
+        {
+            gt911_filter_apply(&filter, &touch);
+        }
+
+        double x = touch.points[0].x;
+        double y = touch.points[0].y;
+        if (i >= FILTER_WARMUP)
+        {
+            double shown_s = t_s + FILTER_LATENCY_US / 1e6;
+            double err = hypot(x - motion_x(motion, shown_s), y - 200);
+            result.lag += err;
+            result.max_err = err > result.max_err ? err : result.max_err;
+            double dx = x - prev_x - (motion_x(motion, t_s) - motion_x(motion, t_s - FILTER_REPORT_US / 1e6));
+            result.jitter += dx * dx + (y - prev_y) * (y - prev_y);
+            counted++;
+        }
+        prev_x = x;
+        prev_y = y;
+    }
+
+    result.lag /= counted;
+    result.jitter = sqrt(result.jitter / counted);
+    return result;
+}
+
+static void test_filter_motions(void)
+{
+    const filter_motion_t motions[] = {
+        {"rest", 300, 0, 0, 1.0, 100},
+        {"noisy", 300, 0, 0, 2.0, 100},
+        {"drag", 50, 600, 0, 1.0, 100},
+        {"fling", 50, 2000, -3000, 1.0, 60},
+    };
+
+    gt911_filter_config_t smooth = GT911_FILTER_DEFAULT_CONFIG();
+    smooth.horizon_us = 0;
+    gt911_filter_config_t linear = GT911_FILTER_DEFAULT_CONFIG();
+    linear.horizon_us = FILTER_LATENCY_US;
+    gt911_filter_config_t quadratic = linear;
+    quadratic.gamma = 16;
+
+    printf("filter: %-6s %-10s %8s %8s %8s\n", "motion", "config", "jitter", "lag", "max");
+    for (size_t m = 0; m < sizeof(motions) / sizeof(motions[0]); m++)
+    {
+        const filter_motion_t *motion = &motions[m];
+        filter_result_t raw = replay_motion(motion, NULL);
+        filter_result_t results[3] = {
+            replay_motion(motion, &smooth),
+            replay_motion(motion, &linear),
+            replay_motion(motion, &quadratic),
+        };
+        const char *names[3] = {"smooth", "linear", "quadratic"};
+
+        printf("filter: %-6s %-10s %8.2f %8.2f %8.2f\n", motion->name, "raw", raw.jitter, raw.lag, raw.max_err);
+        for (int c = 0; c < 3; c++)
+        {
+            printf("filter: %-6s %-10s %8.2f %8.2f %8.2f\n", motion->name, names[c], results[c].jitter, results[c].lag, results[c].max_err);
+        }
+
+        if (motion->v == 0)
+        {
+            // A resting finger: smoothing removes jitter, prediction must not add any
+            CHECK(results[0].jitter < raw.jitter);
+            CHECK(results[1].jitter < raw.jitter);
+        }
+        else
+        {
+            // A moving finger: prediction over the latency catches up with it, smoothing alone does not
+            CHECK(results[1].lag < raw.lag / 2);
+            CHECK(results[0].lag > results[1].lag);
+            CHECK(results[1].jitter < raw.jitter * 1.2);
+        }
+    }
+}
+
+// A recorded trace has no ground truth, the finger at the time a frame is shown is taken
+// from the raw report FILTER_LATENCY_US later
+static void test_filter_trace(const char *path)
+{
+    static gt911_emu_event_t events[FILTER_MAX_EVENTS];
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("filter: cannot open %s\n", path);
+        host_test_failures++;
+        return;
+    }
+    char line[256];
+    size_t len = 0;
+    while (len < FILTER_MAX_EVENTS && fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] != '#' && line[0] != '\n' && gt911_emu_parse_event(line, &events[len]))
+        {
+            len++;
+        }
+    }
+    fclose(file);
+    CHECK(len > 0);
+
+    gt911_filter_config_t config = GT911_FILTER_DEFAULT_CONFIG();
+    config.horizon_us = FILTER_LATENCY_US;
+    gt911_filter_t filter;
+    gt911_filter_init(&filter, &config);
+
+    double raw_lag = 0, filtered_lag = 0;
+    uint32_t counted = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        gt911_touch_t touch = {.touches = events[i].touches, .is_touched = events[i].touches > 0, .timestamp_us = events[i].time_us};
+        for (uint8_t p = 0; p < touch.touches && p < GT911_MAX_POINTS; p++)
+        {
+            touch.points[p] = events[i].points[p];
+        }
+        gt911_filter_apply(&filter, &touch);
+
+        // First point only, against the report that is closest to the time it is shown
+        size_t j = i;
+        while (j + 1 < len && events[j + 1].time_us <= events[i].time_us + FILTER_LATENCY_US)
+        {
+            j++;
+        }
+        if (touch.touches == 0 || events[j].touches == 0 || events[j].points[0].id != events[i].points[0].id)
+        {
+            continue;
+        }
+        const gt911_point_t *future = &events[j].points[0];
+        raw_lag += hypot((double)events[i].points[0].x - future->x, (double)events[i].points[0].y - future->y);
+        filtered_lag += hypot((double)touch.points[0].x - future->x, (double)touch.points[0].y - future->y);
+        counted++;
+    }
+
+    if (counted > 0)
+    {
+        printf("filter: trace %zu reports, lag %.2f px raw, %.2f px filtered\n", len, raw_lag / counted, filtered_lag / counted);
+    }
+}
+
+void test_filter(void)
+{
+    test_filter_motions();
+    if (host_test_arg != NULL)
+    {
+        test_filter_trace(host_test_arg);
+    }
+}
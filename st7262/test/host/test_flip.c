@@ -0,0 +1,141 @@
+#include <stdbool.h>
+#include "host_test.h"
+#include "esp_lcd_st7262_flip.h"
+
+// Mock panel: each frame buffer holds the number of the frame rendered into it,
+// scanout latches the front buffer at every vsync like the RGB peripheral does
+typedef struct
+{
+    esp_lcd_panel_st7262_flip_state_t flip;
+    uint32_t fbs[ESP_LCD_PANEL_ST7262_MAX_FBS];
+    int writing;          // Buffer the renderer is drawing into, -1 when idle
+    uint32_t shown_last;  // Frame number scanned out by the last vsync
+    uint32_t torn;        // Vsyncs that scanned out a buffer being written
+    uint32_t regressions; // Vsyncs that showed an older frame than the previous one
+} mock_panel_t;
+
+static void mock_init(mock_panel_t *panel, uint8_t num_fbs)
+{
+    *panel = (mock_panel_t){.writing = -1};
+    CHECK(esp_lcd_panel_st7262_flip_state_init(&panel->flip, num_fbs));
+}
+
+static void mock_vsync(mock_panel_t *panel)
+{
+    esp_lcd_panel_st7262_flip_state_vsync(&panel->flip);
+    if (panel->writing == panel->flip.front)
+    {
+        panel->torn++;
+    }
+    uint32_t shown = panel->fbs[panel->flip.front];
+    if (shown < panel->shown_last)
+    {
+        panel->regressions++;
+    }
+    panel->shown_last = shown;
+}
+
+// Render one frame if a back buffer is free, returns false when the renderer has to wait
+static bool mock_render(mock_panel_t *panel, uint32_t frame)
+{
+    int back = esp_lcd_panel_st7262_flip_state_back(&panel->flip);
+    if (back < 0 || panel->flip.pending)
+    {
+        return false;
+    }
+    panel->writing = back;
+    panel->fbs[back] = frame;
+    panel->writing = -1;
+    return esp_lcd_panel_st7262_flip_state_queue(&panel->flip, (uint8_t)back);
+}
+
+static void test_flip_transitions(void)
+{
+    esp_lcd_panel_st7262_flip_state_t state;
+
+    CHECK(!esp_lcd_panel_st7262_flip_state_init(&state, 0));
+    CHECK(!esp_lcd_panel_st7262_flip_state_init(&state, ESP_LCD_PANEL_ST7262_MAX_FBS + 1));
+    CHECK(!esp_lcd_panel_st7262_flip_state_init(NULL, 2));
+
+    // A single buffer never has a back buffer
+    CHECK(esp_lcd_panel_st7262_flip_state_init(&state, 1));
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), -1);
+    CHECK(!esp_lcd_panel_st7262_flip_state_queue(&state, 0));
+
+    // Double buffering: idle -> pending -> flipped
+    CHECK(esp_lcd_panel_st7262_flip_state_init(&state, 2));
+    CHECK_EQ(state.front, 0);
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), 1);
+    CHECK(!esp_lcd_panel_st7262_flip_state_vsync(&state));
+    CHECK(!esp_lcd_panel_st7262_flip_state_queue(&state, 0)); // Front buffer
+    CHECK(!esp_lcd_panel_st7262_flip_state_queue(&state, 2)); // Out of range
+    CHECK(esp_lcd_panel_st7262_flip_state_queue(&state, 1));
+    CHECK(!esp_lcd_panel_st7262_flip_state_queue(&state, 1)); // Already pending
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), -1);
+    CHECK(esp_lcd_panel_st7262_flip_state_vsync(&state));
+    CHECK_EQ(state.front, 1);
+    CHECK(!state.pending);
+    CHECK_EQ(state.flips, 1);
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), 0);
+
+    // Triple buffering: one buffer stays free while a swap is pending
+    CHECK(esp_lcd_panel_st7262_flip_state_init(&state, 3));
+    CHECK(esp_lcd_panel_st7262_flip_state_queue(&state, 1));
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), 2);
+    CHECK(esp_lcd_panel_st7262_flip_state_vsync(&state));
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), 2);
+    CHECK(esp_lcd_panel_st7262_flip_state_queue(&state, 2));
+    CHECK(esp_lcd_panel_st7262_flip_state_vsync(&state));
+    CHECK_EQ(state.front, 2);
+    CHECK_EQ(esp_lcd_panel_st7262_flip_state_back(&state), 0);
+    CHECK_EQ(state.flips, 2);
+}
+
+// Drive the mock panel with a renderer faster and slower than the refresh rate
+static void test_flip_mock_panel(uint8_t num_fbs, uint32_t renders_per_vsync, uint32_t vsyncs_per_render)
+{
+    mock_panel_t panel;
+    mock_init(&panel, num_fbs);
+
+    uint32_t frame = 1;
+    uint32_t stalls = 0;
+    for (uint32_t tick = 0; tick < 600; tick++)
+    {
+        if (tick % vsyncs_per_render == 0)
+        {
+            for (uint32_t i = 0; i < renders_per_vsync; i++)
+            {
+                if (mock_render(&panel, frame))
+                {
+                    frame++;
+                }
+                else
+                {
+                    stalls++;
+                }
+            }
+        }
+        mock_vsync(&panel);
+    }
+
+    CHECK_EQ(panel.torn, 0);
+    CHECK_EQ(panel.regressions, 0);
+    // Every rendered frame reaches the screen, at most one is still pending
+    CHECK(panel.flip.flips + 1 >= frame - 1);
+    if (renders_per_vsync > 1)
+    {
+        // A renderer faster than the refresh rate is throttled to one frame per vsync
+        CHECK(stalls > 0);
+        CHECK(panel.flip.flips <= 600);
+    }
+}
+
+void test_flip(void)
+{
+    test_flip_transitions();
+    test_flip_mock_panel(2, 1, 1);
+    test_flip_mock_panel(2, 3, 1);
+    test_flip_mock_panel(2, 1, 3);
+    test_flip_mock_panel(3, 1, 1);
+    test_flip_mock_panel(3, 4, 1);
+}
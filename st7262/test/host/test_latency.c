@@ -0,0 +1,250 @@
+#include <string.h>
+#include "host_test.h"
+#include "gt911_emu.h"
+#include "gt911_report.h"
+#include "latency.h"
+
+#define LATENCY_MAX_EVENTS 1024
+#define LATENCY_POLL_US 1000     // Reader task poll interval
+#define LATENCY_WAKE_US 300      // Report callback to the indev read in the UI loop
+#define LATENCY_VSYNC_US 16667   // About 60 Hz
+#define LATENCY_RENDER_US 7000   // Vsync to the last area in the frame buffer, the UI task is busy until then
+#define LATENCY_ANIM_US 33000    // An animation redrawing on its own, not caused by touch
+#define LATENCY_STEP_US 100
+
+static gt911_emu_event_t events[LATENCY_MAX_EVENTS];
+static int64_t acquired_us[LATENCY_MAX_EVENTS + 1]; // By report sequence
+static bool changed[LATENCY_MAX_EVENTS + 1];
+
+typedef struct
+{
+    uint32_t measured;
+    uint32_t misattributed; // Measured samples the shown frame does not contain
+    uint32_t unchanged;
+    latency_summary_t total;
+} latency_run_t;
+
+static void test_latency_stages(void)
+{
+    latency_t lat;
+    latency_init(&lat);
+    CHECK_EQ(latency_sample_id(&lat), 0);
+
+    // Only the sample in flight advances, id 0 never does
+    latency_sample(&lat, 7, 1000, 2000);
+    CHECK_EQ(latency_sample_id(&lat), 7);
+    latency_invalidate(&lat, 0);
+    latency_invalidate(&lat, 6);
+    latency_frame_rendered(&lat);
+    latency_frame_flushed(&lat, 5000);
+    CHECK(!latency_vsync(&lat, 9000));
+
+    latency_invalidate(&lat, 7);
+    CHECK_EQ(latency_sample_id(&lat), 0);
+    latency_frame_rendered(&lat);
+    latency_frame_flushed(&lat, 5000);
+    CHECK(latency_vsync(&lat, 9000));
+    CHECK_EQ(lat.last_id, 7);
+
+    latency_summary_t total;
+    latency_summary(&lat, LATENCY_TOTAL, &total);
+    CHECK_EQ(total.count, 1);
+    CHECK_EQ(total.max_us, 8000);
+
+    // A sample that changed nothing is replaced by the next one
+    latency_sample(&lat, 8, 10000, 10500);
+    latency_sample(&lat, 9, 20000, 20500);
+    CHECK_EQ(latency_sample_id(&lat), 9);
+    CHECK_EQ(lat.unchanged, 1);
+}
+
+// Play the events through the emulator, the reader, the indev and a simulated render and
+// vsync loop. With gated invalidations only the indev pass passes the sample id, as in
+// main.c; otherwise every invalidation advances whatever sample is in flight.
+static latency_run_t replay(const gt911_emu_event_t *trace, size_t len, bool gated)
+{
+    gt911_emu_t emu;
+    gt911_emu_init(&emu);
+    gt911_emu_play(&emu, trace, len, 0, false);
+    gt911_transport_t transport = gt911_emu_transport(&emu);
+
+    latency_t lat;
+    latency_init(&lat);
+    memset(changed, 0, sizeof(changed));
+
+    uint32_t sequence = 0;
+    int64_t read_at = -1;
+    gt911_report_t pending = {0};
+    gt911_report_t shown = {0};
+
+    bool dirty = false;
+    int64_t render_done = -1;
+    uint32_t frame_first = 0, frame_last = 0; // Samples the frame being rendered contains
+    uint32_t dirty_first = 0, dirty_last = 0; // Samples invalidated since the last render started
+    uint32_t screen_first = 0, screen_last = 0;
+
+    latency_run_t run = {0};
+    int64_t end_us = trace[len - 1].time_us + 4 * LATENCY_VSYNC_US;
+    for (int64_t now = 0; now <= end_us; now += LATENCY_STEP_US)
+    {
+        if (now % LATENCY_VSYNC_US < LATENCY_STEP_US)
+        {
+            // The frame flushed before this vsync is what the panel shows from now on
+            if (render_done >= 0 && render_done <= now)
+            {
+                screen_first = frame_first, screen_last = frame_last;
+                render_done = -1;
+            }
+            if (latency_vsync(&lat, now))
+            {
+                run.measured++;
+                uint32_t id = lat.last_id;
+                run.misattributed += !changed[id] || id < screen_first || id > screen_last;
+            }
+            if (dirty && render_done < 0)
+            {
+                dirty = false;
+                render_done = now + LATENCY_RENDER_US;
+                frame_first = dirty_first, frame_last = dirty_last;
+                dirty_first = dirty_last = 0;
+            }
+        }
+
+        if (render_done >= 0 && now <= render_done && render_done < now + LATENCY_STEP_US)
+        {
+            latency_frame_rendered(&lat);
+            latency_frame_flushed(&lat, render_done);
+        }
+
+        if (now % LATENCY_ANIM_US < LATENCY_STEP_US)
+        {
+            dirty = true;
+            if (!gated)
+            {
+                latency_invalidate(&lat, latency_sample_id(&lat));
+            }
+        }
+
+        if (now % LATENCY_POLL_US < LATENCY_STEP_US)
+        {
+            gt911_emu_advance(&emu, now);
+            gt911_report_t report;
+            if (gt911_report_read(&transport, 10, &report) == ESP_OK)
+            {
+                sequence++;
+                acquired_us[sequence] = now;
+                pending = report;
+                read_at = now + LATENCY_WAKE_US;
+            }
+        }
+
+        // LVGL renders in the UI task, the indev is not read before the frame is done
+        bool rendering = render_done >= 0 && now < render_done;
+        if (read_at >= 0 && now >= read_at && !rendering)
+        {
+            read_at = -1;
+            latency_sample(&lat, sequence, acquired_us[sequence], now);
+
+            // The UI redraws only when the report moved something
+            changed[sequence] = pending.touches != shown.touches ||
+                                (pending.touches > 0 && memcmp(pending.points, shown.points, sizeof(pending.points[0])) != 0);
+            shown = pending;
+            if (changed[sequence])
+            {
+                latency_invalidate(&lat, sequence);
+                dirty = true;
+                dirty_first = dirty_first != 0 ? dirty_first : sequence;
+                dirty_last = sequence;
+            }
+            else
+            {
+                run.unchanged++;
+            }
+        }
+    }
+
+    latency_summary(&lat, LATENCY_TOTAL, &run.total);
+    CHECK_EQ(run.total.count, run.measured);
+    return run;
+}
+
+static void report_run(const char *name, const char *mode, const latency_run_t *run)
+{
+    printf("latency: %-6s %-7s %3u measured, %3u not in the shown frame, %3u unchanged, total p50 %lu p90 %lu max %lu us\n",
+           name, mode, run->measured, run->misattributed, run->unchanged, (unsigned long)run->total.p50_us,
+           (unsigned long)run->total.p90_us, (unsigned long)run->total.max_us);
+}
+
+static void test_latency_replay(const char *name, const gt911_emu_event_t *trace, size_t len)
+{
+    latency_run_t gated = replay(trace, len, true);
+    latency_run_t ungated = replay(trace, len, false);
+    report_run(name, "indev", &gated);
+    report_run(name, "any", &ungated);
+
+    // Every measured sample is one that changed the screen, shown in the frame it measures
+    CHECK(gated.measured > 0);
+    CHECK_EQ(gated.misattributed, 0);
+
+    // At least a read, one render and the wait for the next vsync
+    CHECK(gated.total.max_us >= LATENCY_WAKE_US + LATENCY_RENDER_US);
+    CHECK(gated.total.max_us <= 3 * LATENCY_VSYNC_US);
+}
+
+// A drag followed by a resting finger, so there are samples that change nothing
+static size_t drag_and_rest(gt911_emu_event_t *out)
+{
+    size_t len = 0;
+    for (int i = 0; i < 40; i++)
+    {
+        out[len++] = (gt911_emu_event_t){.time_us = i * 10000, .touches = 1, .points = {{.x = (uint16_t)(40 + 3 * i), .y = 100, .size = 24}}};
+    }
+    for (int i = 40; i < 100; i++)
+    {
+        out[len++] = (gt911_emu_event_t){.time_us = i * 10000, .touches = 1, .points = {{.x = 157, .y = 100, .size = 24}}};
+    }
+    out[len++] = (gt911_emu_event_t){.time_us = 100 * 10000, .touches = 0};
+    return len;
+}
+
+static size_t load_trace(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("latency: cannot open %s\n", path);
+        host_test_failures++;
+        return 0;
+    }
+
+    char line[256];
+    size_t len = 0;
+    while (len < LATENCY_MAX_EVENTS && fgets(line, sizeof(line), file) != NULL)
+    {
+        if (line[0] != '#' && line[0] != '\n' && gt911_emu_parse_event(line, &events[len]))
+        {
+            len++;
+        }
+    }
+    fclose(file);
+
+    return len;
+}
+
+void test_latency(void)
+{
+    test_latency_stages();
+
+    size_t len = drag_and_rest(events);
+    test_latency_replay("drag", events, len);
+
+    if (host_test_arg != NULL)
+    {
+        len = load_trace(host_test_arg);
+        CHECK(len > 0);
+        if (len > 0)
+        {
+            test_latency_replay("trace", events, len);
+        }
+    }
+}
@@ -0,0 +1,289 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_lcd_st7262_pixel.h"
+
+// Built with ESP_LCD_PANEL_ST7262_PIXEL_PIE=1, so the kernels without suffix run the PIE
+// row split (head, 16-byte blocks, tail) around C block moves, see esp_lcd_st7262_pixel.h
+
+#define PIXEL_BUF_PX (64 * 24)
+#define PIXEL_BENCH_W 800
+#define PIXEL_BENCH_H 480
+
+static uint32_t rng_state = 0x12345678;
+
+static uint16_t rng16(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (uint16_t)rng_state;
+}
+
+static void randomize(uint16_t *buf, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        buf[i] = rng16();
+    }
+}
+
+/* Scalar references, one pixel and one channel at a time */
+
+static uint16_t ref_blend_px(uint16_t fg, uint16_t bg, uint32_t alpha)
+{
+    uint32_t r = (((fg >> 11) & 0x1F) * alpha + ((bg >> 11) & 0x1F) * (32 - alpha)) >> 5;
+    uint32_t g = (((fg >> 5) & 0x3F) * alpha + ((bg >> 5) & 0x3F) * (32 - alpha)) >> 5;
+    uint32_t b = ((fg & 0x1F) * alpha + (bg & 0x1F) * (32 - alpha)) >> 5;
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void ref_fill(uint16_t *dst, uint32_t stride, uint32_t w, uint32_t h, uint16_t colour)
+{
+    for (uint32_t y = 0; y < h; y++)
+    {
+        for (uint32_t x = 0; x < w; x++)
+        {
+            dst[y * stride / 2 + x] = colour;
+        }
+    }
+}
+
+static void ref_copy(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h)
+{
+    for (uint32_t y = 0; y < h; y++)
+    {
+        for (uint32_t x = 0; x < w; x++)
+        {
+            dst[y * dst_stride / 2 + x] = src[y * src_stride / 2 + x];
+        }
+    }
+}
+
+static void ref_blend(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint32_t w, uint32_t h, uint8_t opa)
+{
+    uint32_t alpha = ((uint32_t)opa + 4) >> 3;
+    for (uint32_t y = 0; y < h; y++)
+    {
+        for (uint32_t x = 0; x < w; x++)
+        {
+            uint16_t *d = &dst[y * dst_stride / 2 + x];
+            *d = ref_blend_px(src[y * src_stride / 2 + x], *d, alpha);
+        }
+    }
+}
+
+static void ref_blend_colour(uint16_t *dst, uint32_t stride, uint32_t w, uint32_t h, uint16_t colour, uint8_t opa)
+{
+    uint32_t alpha = ((uint32_t)opa + 4) >> 3;
+    for (uint32_t y = 0; y < h; y++)
+    {
+        for (uint32_t x = 0; x < w; x++)
+        {
+            uint16_t *d = &dst[y * stride / 2 + x];
+            *d = ref_blend_px(colour, *d, alpha);
+        }
+    }
+}
+
+static void ref_swap_rb(uint16_t *buf, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint16_t r = (buf[i] >> 11) & 0x1F, g = (buf[i] >> 5) & 0x3F, b = buf[i] & 0x1F;
+        buf[i] = (uint16_t)((b << 11) | (g << 5) | r);
+    }
+}
+
+static void ref_swap_bytes(uint16_t *buf, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        buf[i] = (uint16_t)((buf[i] >> 8) | (buf[i] << 8));
+    }
+}
+
+/* Bit-exact comparison over odd widths, offsets and strides, the pixels around the rectangle must stay untouched */
+
+typedef enum
+{
+    KERNEL_FILL,
+    KERNEL_COPY,
+    KERNEL_BLEND,
+    KERNEL_BLEND_COLOUR,
+    KERNEL_SWAP_RB,
+    KERNEL_SWAP_BYTES,
+    KERNEL_COUNT,
+} kernel_t;
+
+static const char *const kernel_names[KERNEL_COUNT] = {"fill", "copy", "blend", "blend_colour", "swap_rb", "swap_bytes"};
+
+typedef enum
+{
+    IMPL_REF,
+    IMPL_SWAR,
+    IMPL_DISPATCH,
+    IMPL_COUNT,
+} impl_t;
+
+static const char *const impl_names[IMPL_COUNT] = {"scalar", "swar", "pie"};
+
+typedef struct
+{
+    uint16_t *dst;
+    uint32_t dst_stride;
+    const uint16_t *src;
+    uint32_t src_stride;
+    uint32_t w;
+    uint32_t h;
+    uint16_t colour;
+    uint8_t opa;
+} kernel_args_t;
+
+static void run_kernel(kernel_t kernel, impl_t impl, const kernel_args_t *a)
+{
+    switch (kernel)
+    {
+    case KERNEL_FILL:
+        impl == IMPL_REF    ? ref_fill(a->dst, a->dst_stride, a->w, a->h, a->colour)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_fill_swar(a->dst, a->dst_stride, a->w, a->h, a->colour)
+                            : esp_lcd_panel_st7262_pixel_fill(a->dst, a->dst_stride, a->w, a->h, a->colour);
+        break;
+    case KERNEL_COPY:
+        impl == IMPL_REF    ? ref_copy(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_copy_swar(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h)
+                            : esp_lcd_panel_st7262_pixel_copy(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h);
+        break;
+    case KERNEL_BLEND:
+        impl == IMPL_REF    ? ref_blend(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h, a->opa)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_blend_swar(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h, a->opa)
+                            : esp_lcd_panel_st7262_pixel_blend(a->dst, a->dst_stride, a->src, a->src_stride, a->w, a->h, a->opa);
+        break;
+    case KERNEL_BLEND_COLOUR:
+        impl == IMPL_REF    ? ref_blend_colour(a->dst, a->dst_stride, a->w, a->h, a->colour, a->opa)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_blend_colour_swar(a->dst, a->dst_stride, a->w, a->h, a->colour, a->opa)
+                            : esp_lcd_panel_st7262_pixel_blend_colour(a->dst, a->dst_stride, a->w, a->h, a->colour, a->opa);
+        break;
+    case KERNEL_SWAP_RB:
+        impl == IMPL_REF    ? ref_swap_rb(a->dst, a->w)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_swap_rb_swar(a->dst, a->w)
+                            : esp_lcd_panel_st7262_pixel_swap_rb(a->dst, a->w);
+        break;
+    case KERNEL_SWAP_BYTES:
+        impl == IMPL_REF    ? ref_swap_bytes(a->dst, a->w)
+        : impl == IMPL_SWAR ? esp_lcd_panel_st7262_pixel_swap_bytes_swar(a->dst, a->w)
+                            : esp_lcd_panel_st7262_pixel_swap_bytes(a->dst, a->w);
+        break;
+    default:
+        break;
+    }
+}
+
+static void test_pixel_exact(kernel_t kernel)
+{
+    static const uint8_t opas[] = {0, 3, 4, 12, 100, 128, 200, 251, 252, 255};
+    static uint16_t src[PIXEL_BUF_PX] __attribute__((aligned(16)));
+    static uint16_t init[PIXEL_BUF_PX] __attribute__((aligned(16)));
+    static uint16_t out[IMPL_COUNT][PIXEL_BUF_PX] __attribute__((aligned(16)));
+    uint32_t mismatches = 0;
+
+    for (uint32_t w = 0; w <= 40; w++)
+    {
+        for (uint32_t dst_off = 0; dst_off < 8; dst_off++)
+        {
+            for (uint32_t src_off = 0; src_off < 8; src_off += 3)
+            {
+                randomize(src, PIXEL_BUF_PX);
+                randomize(init, PIXEL_BUF_PX);
+                uint16_t colour = rng16();
+                uint8_t opa = opas[(w + dst_off) % sizeof(opas)];
+
+                for (impl_t impl = 0; impl < IMPL_COUNT; impl++)
+                {
+                    memcpy(out[impl], init, sizeof(init));
+                    // Strides of whole 16-byte blocks and of odd pixel counts
+                    kernel_args_t args = {
+                        .dst = out[impl] + dst_off,
+                        .dst_stride = (w % 2 ? 56 : 53) * 2,
+                        .src = src + src_off,
+                        .src_stride = (w % 3 ? 48 : 61) * 2,
+                        .w = w,
+                        .h = kernel == KERNEL_SWAP_RB || kernel == KERNEL_SWAP_BYTES ? 1 : 5,
+                        .colour = colour,
+                        .opa = opa,
+                    };
+                    run_kernel(kernel, impl, &args);
+                }
+
+                mismatches += memcmp(out[IMPL_REF], out[IMPL_SWAR], sizeof(init)) != 0;
+                mismatches += memcmp(out[IMPL_REF], out[IMPL_DISPATCH], sizeof(init)) != 0;
+            }
+        }
+    }
+
+    if (mismatches != 0)
+    {
+        fprintf(stderr, "pixel: %s differs from the scalar reference in %u cases\n", kernel_names[kernel], mismatches);
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+static void test_pixel_bench(kernel_t kernel)
+{
+    size_t bytes = PIXEL_BENCH_W * PIXEL_BENCH_H * sizeof(uint16_t);
+    uint16_t *dst = aligned_alloc(16, bytes);
+    uint16_t *src = aligned_alloc(16, bytes);
+    CHECK(dst != NULL && src != NULL);
+    if (dst == NULL || src == NULL)
+    {
+        free(dst);
+        free(src);
+        return;
+    }
+    randomize(src, PIXEL_BENCH_W * PIXEL_BENCH_H);
+    randomize(dst, PIXEL_BENCH_W * PIXEL_BENCH_H);
+
+    bool swap = kernel == KERNEL_SWAP_RB || kernel == KERNEL_SWAP_BYTES;
+    kernel_args_t args = {
+        .dst = dst,
+        .dst_stride = PIXEL_BENCH_W * 2,
+        .src = src,
+        .src_stride = PIXEL_BENCH_W * 2,
+        .w = swap ? PIXEL_BENCH_W * PIXEL_BENCH_H : PIXEL_BENCH_W,
+        .h = swap ? 1 : PIXEL_BENCH_H,
+        .colour = 0x1234,
+        .opa = 128,
+    };
+
+    printf("pixel: %-12s", kernel_names[kernel]);
+    for (impl_t impl = 0; impl < IMPL_COUNT; impl++)
+    {
+        const uint32_t frames = 20;
+        int64_t start = host_now_us();
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            run_kernel(kernel, impl, &args);
+        }
+        int64_t elapsed = host_now_us() - start;
+        double mpix = (double)PIXEL_BENCH_W * PIXEL_BENCH_H * frames / (elapsed > 0 ? elapsed : 1);
+        printf(" %s %7.1f", impl_names[impl], mpix);
+    }
+    printf(" Mpix/s\n");
+
+    free(dst);
+    free(src);
+}
+
+void test_pixel(void)
+{
+    for (kernel_t kernel = 0; kernel < KERNEL_COUNT; kernel++)
+    {
+        test_pixel_exact(kernel);
+    }
+
+    // Host numbers, the "pie" column runs the C stand-in of the vector blocks
+    for (kernel_t kernel = 0; kernel < KERNEL_COUNT; kernel++)
+    {
+        test_pixel_bench(kernel);
+    }
+}
@@ -0,0 +1,217 @@
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "esp_lcd_st7262_queue.h"
+
+#define QUEUE_DEPTH 4
+#define QUEUE_REQUESTS 200000
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t check; // Catches torn copies
+} queue_request_t;
+
+// The worker of the driver with semaphores in place of its task notification and of the
+// semaphore a producer waits on while the ring is full
+typedef struct
+{
+    esp_lcd_panel_st7262_queue_t queue;
+    queue_request_t slots[QUEUE_DEPTH];
+    sem_t notify;
+    sem_t space;
+    uint32_t received;
+    uint32_t out_of_order;
+    uint32_t torn;
+    uint32_t overfull;
+    uint32_t sleeps;
+    uint32_t slow_every; // Stall the worker now and then so the producer fills the ring
+} queue_worker_t;
+
+static void *queue_worker(void *arg)
+{
+    queue_worker_t *worker = (queue_worker_t *)arg;
+    queue_request_t request;
+
+    while (true)
+    {
+        uint32_t queued = __atomic_load_n(&worker->queue.head, __ATOMIC_ACQUIRE) - worker->queue.tail;
+        worker->overfull += queued > QUEUE_DEPTH;
+
+        if (!esp_lcd_panel_st7262_queue_pop(&worker->queue, &request))
+        {
+            if (esp_lcd_panel_st7262_queue_stopped(&worker->queue))
+            {
+                return NULL;
+            }
+            if (esp_lcd_panel_st7262_queue_prepare_wait(&worker->queue))
+            {
+                worker->sleeps++;
+                sem_wait(&worker->notify);
+            }
+            esp_lcd_panel_st7262_queue_end_wait(&worker->queue);
+            continue;
+        }
+
+        if (esp_lcd_panel_st7262_queue_wake_producer(&worker->queue))
+        {
+            sem_post(&worker->space);
+        }
+
+        worker->out_of_order += request.seq != worker->received;
+        worker->torn += request.check != ~request.seq;
+        worker->received++;
+        if (worker->slow_every != 0 && request.seq % worker->slow_every == 0)
+        {
+            usleep(200);
+        }
+    }
+}
+
+static void queue_worker_init(queue_worker_t *worker, uint32_t slow_every)
+{
+    *worker = (queue_worker_t){.slow_every = slow_every};
+    CHECK(esp_lcd_panel_st7262_queue_init(&worker->queue, worker->slots, QUEUE_DEPTH, sizeof(queue_request_t)));
+    sem_init(&worker->notify, 0, 0);
+    sem_init(&worker->space, 0, 0);
+}
+
+static void queue_wake(queue_worker_t *worker)
+{
+    if (esp_lcd_panel_st7262_queue_wake_consumer(&worker->queue))
+    {
+        sem_post(&worker->notify);
+    }
+}
+
+static void test_queue_single_thread(void)
+{
+    esp_lcd_panel_st7262_queue_t queue;
+    queue_request_t slots[QUEUE_DEPTH];
+    queue_request_t request;
+
+    CHECK(!esp_lcd_panel_st7262_queue_init(&queue, slots, 0, sizeof(queue_request_t)));
+    CHECK(!esp_lcd_panel_st7262_queue_init(&queue, NULL, QUEUE_DEPTH, sizeof(queue_request_t)));
+    CHECK(esp_lcd_panel_st7262_queue_init(&queue, slots, QUEUE_DEPTH, sizeof(queue_request_t)));
+    CHECK(!esp_lcd_panel_st7262_queue_pop(&queue, &request));
+
+    // Fill, overflow, drain and wrap around a few times
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    for (uint32_t round = 0; round < 5; round++)
+    {
+        while (esp_lcd_panel_st7262_queue_push(&queue, &(queue_request_t){next_in, ~next_in}))
+        {
+            next_in++;
+        }
+        CHECK_EQ(next_in - next_out, QUEUE_DEPTH);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            CHECK(esp_lcd_panel_st7262_queue_pop(&queue, &request));
+            CHECK_EQ(request.seq, next_out);
+            next_out++;
+        }
+    }
+
+    // No wake-up is owed unless the consumer or the producer announced a wait
+    CHECK(!esp_lcd_panel_st7262_queue_wake_consumer(&queue));
+    CHECK(!esp_lcd_panel_st7262_queue_wake_producer(&queue));
+    CHECK(!esp_lcd_panel_st7262_queue_prepare_push_wait(&queue)); // Not full
+    CHECK(esp_lcd_panel_st7262_queue_wake_producer(&queue));
+    while (esp_lcd_panel_st7262_queue_push(&queue, &(queue_request_t){next_in, ~next_in}))
+    {
+        next_in++;
+    }
+    CHECK(esp_lcd_panel_st7262_queue_prepare_push_wait(&queue)); // Full, the producer may sleep
+    esp_lcd_panel_st7262_queue_end_push_wait(&queue);
+    CHECK(!esp_lcd_panel_st7262_queue_wake_producer(&queue));
+    CHECK(!esp_lcd_panel_st7262_queue_prepare_wait(&queue)); // Not empty
+    esp_lcd_panel_st7262_queue_end_wait(&queue);
+
+    // A stop lets the consumer drain what was queued first
+    esp_lcd_panel_st7262_queue_stop(&queue);
+    CHECK(!esp_lcd_panel_st7262_queue_stopped(&queue));
+    while (esp_lcd_panel_st7262_queue_pop(&queue, &request))
+    {
+        CHECK_EQ(request.seq, next_out);
+        next_out++;
+    }
+    CHECK_EQ(next_out, next_in);
+    CHECK(esp_lcd_panel_st7262_queue_stopped(&queue));
+    CHECK(!esp_lcd_panel_st7262_queue_prepare_wait(&queue)); // Stop requested, do not sleep
+}
+
+// Producer and worker threads, ordering and throttling when the worker falls behind
+static void test_queue_threads(uint32_t slow_every)
+{
+    queue_worker_t worker;
+    queue_worker_init(&worker, slow_every);
+
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, queue_worker, &worker) == 0);
+
+    // Sleep on a full ring like esp_lcd_panel_st7262_draw_bitmap_async(), a lost wake-up hangs here
+    uint32_t full = 0;
+    uint32_t producer_sleeps = 0;
+    for (uint32_t seq = 0; seq < QUEUE_REQUESTS; seq++)
+    {
+        queue_request_t request = {seq, ~seq};
+        while (!esp_lcd_panel_st7262_queue_push(&worker.queue, &request))
+        {
+            full++;
+            if (esp_lcd_panel_st7262_queue_prepare_push_wait(&worker.queue))
+            {
+                producer_sleeps++;
+                sem_wait(&worker.space);
+            }
+            esp_lcd_panel_st7262_queue_end_push_wait(&worker.queue);
+        }
+        queue_wake(&worker);
+    }
+
+    // Stop from this thread after the last submission, the worker drains the ring first
+    esp_lcd_panel_st7262_queue_stop(&worker.queue);
+    queue_wake(&worker);
+    pthread_join(thread, NULL);
+
+    CHECK_EQ(worker.received, QUEUE_REQUESTS);
+    CHECK_EQ(worker.out_of_order, 0);
+    CHECK_EQ(worker.torn, 0);
+    CHECK_EQ(worker.overfull, 0);
+    if (slow_every != 0)
+    {
+        CHECK(full > 0);
+    }
+    printf("queue: %u requests, worker slow every %u: producer found the ring full %u times and slept %u times, worker slept %u times\n",
+           QUEUE_REQUESTS, slow_every, full, producer_sleeps, worker.sleeps);
+
+    sem_destroy(&worker.notify);
+    sem_destroy(&worker.space);
+}
+
+// A stop reaches a sleeping worker without any request
+static void test_queue_stop_idle(void)
+{
+    queue_worker_t worker;
+    queue_worker_init(&worker, 0);
+
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, queue_worker, &worker) == 0);
+    usleep(1000);
+    esp_lcd_panel_st7262_queue_stop(&worker.queue);
+    queue_wake(&worker);
+    pthread_join(thread, NULL);
+    CHECK_EQ(worker.received, 0);
+
+    sem_destroy(&worker.notify);
+    sem_destroy(&worker.space);
+}
+
+void test_queue(void)
+{
+    test_queue_single_thread();
+    test_queue_threads(0);
+    test_queue_threads(5000);
+    test_queue_stop_idle();
+}
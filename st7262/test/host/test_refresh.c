@@ -0,0 +1,156 @@
+#include "host_test.h"
+#include "esp_lcd_st7262_refresh.h"
+#include "esp_lcd_st7262_flip.h"
+
+#define REFRESH_FRAME_US 25000 // 40 Hz, the 8048S043 default timing
+#define REFRESH_FRAME_BYTES (800 * 480 * 2)
+#define REFRESH_SIM_FRAMES 20000
+
+static uint32_t lcg_state = 1;
+
+// Uniform in [-range, range]
+static int32_t jitter(int32_t range)
+{
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return (int32_t)((lcg_state >> 8) % (uint32_t)(2 * range + 1)) - range;
+}
+
+static void test_refresh_policy(void)
+{
+    esp_lcd_panel_st7262_refresh_t state;
+
+    CHECK(!esp_lcd_panel_st7262_refresh_init(NULL, REFRESH_FRAME_BYTES, 2, 10));
+    CHECK(!esp_lcd_panel_st7262_refresh_init(&state, 0, 2, 10));
+    CHECK(esp_lcd_panel_st7262_refresh_init(&state, REFRESH_FRAME_BYTES, 2, 10));
+
+    // The first tick refreshes, the next one waits for its vsync
+    CHECK(esp_lcd_panel_st7262_refresh_tick(&state));
+    CHECK(!esp_lcd_panel_st7262_refresh_tick(&state));
+    CHECK_EQ(state.stats.deferred, 1);
+    esp_lcd_panel_st7262_refresh_done(&state);
+
+    // Idle frames refresh, then only the keep-alive does
+    CHECK(esp_lcd_panel_st7262_refresh_tick(&state));
+    esp_lcd_panel_st7262_refresh_done(&state);
+    CHECK(esp_lcd_panel_st7262_refresh_tick(&state));
+    esp_lcd_panel_st7262_refresh_done(&state);
+    uint32_t refreshed = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        if (esp_lcd_panel_st7262_refresh_tick(&state))
+        {
+            refreshed++;
+            esp_lcd_panel_st7262_refresh_done(&state);
+        }
+    }
+    CHECK_EQ(refreshed, 2);
+
+    // Content changes refresh at the next tick
+    esp_lcd_panel_st7262_refresh_mark_dirty(&state);
+    CHECK(esp_lcd_panel_st7262_refresh_tick(&state));
+
+    // A lost vsync only holds the refreshes back for the stall limit
+    uint32_t ticks = 1;
+    esp_lcd_panel_st7262_refresh_mark_dirty(&state);
+    while (!esp_lcd_panel_st7262_refresh_tick(&state))
+    {
+        ticks++;
+    }
+    CHECK_EQ(ticks, ESP_LCD_PANEL_ST7262_REFRESH_STALL_FRAMES);
+
+    // Skipped ticks account one frame each, deferred ones nothing
+    CHECK_EQ(state.stats.bytes_saved, (uint64_t)state.stats.skipped * REFRESH_FRAME_BYTES);
+
+    CHECK_EQ(esp_lcd_panel_st7262_refresh_period_us(REFRESH_FRAME_US),
+             REFRESH_FRAME_US + REFRESH_FRAME_US * ESP_LCD_PANEL_ST7262_REFRESH_MARGIN_PCT / 100);
+}
+
+typedef struct
+{
+    uint32_t ticks;
+    uint32_t deferred;
+    uint32_t flips;
+    uint32_t mismatches; // Vsyncs after which the flip state disagrees with the scanned buffer
+} refresh_sim_t;
+
+// The driver's on-demand path: the timer ticks the policy and starts the frame with the
+// queued buffer, the vsync only completes a flip that frame started. The renderer queues
+// a new buffer at a random time, also between a tick and its vsync.
+static refresh_sim_t refresh_simulate(uint32_t period_us, int32_t tick_jitter_us, int32_t vsync_jitter_us)
+{
+    esp_lcd_panel_st7262_refresh_t state;
+    esp_lcd_panel_st7262_flip_state_t flip;
+    refresh_sim_t sim = {0};
+
+    CHECK(esp_lcd_panel_st7262_refresh_init(&state, REFRESH_FRAME_BYTES, 4, 0));
+    CHECK(esp_lcd_panel_st7262_flip_state_init(&flip, 2));
+
+    bool flip_started = false;
+    int scanned = flip.front;
+    int64_t vsync_at = -1;
+    int64_t render_at = period_us / 2;
+    for (uint32_t k = 1; k <= REFRESH_SIM_FRAMES; k++)
+    {
+        int64_t tick_at = (int64_t)k * period_us + jitter(tick_jitter_us);
+
+        // Events before this tick, in time order
+        while ((vsync_at >= 0 && vsync_at < tick_at) || render_at < tick_at)
+        {
+            if (vsync_at >= 0 && (vsync_at <= render_at || render_at >= tick_at))
+            {
+                if (flip_started)
+                {
+                    sim.flips += esp_lcd_panel_st7262_flip_state_vsync(&flip);
+                    flip_started = false;
+                }
+                esp_lcd_panel_st7262_refresh_done(&state);
+                sim.mismatches += flip.front != scanned;
+                vsync_at = -1;
+            }
+            else
+            {
+                int back = esp_lcd_panel_st7262_flip_state_back(&flip);
+                if (back >= 0 && !flip.pending)
+                {
+                    esp_lcd_panel_st7262_flip_state_queue(&flip, (uint8_t)back);
+                    esp_lcd_panel_st7262_refresh_mark_dirty(&state);
+                }
+                render_at += period_us / 2 + jitter(period_us / 3);
+            }
+        }
+
+        sim.ticks++;
+        if (esp_lcd_panel_st7262_refresh_tick(&state))
+        {
+            flip_started = flip.pending;
+            scanned = flip.pending ? flip.queued : flip.front;
+            vsync_at = tick_at + REFRESH_FRAME_US + jitter(vsync_jitter_us);
+        }
+    }
+    sim.deferred = state.stats.deferred;
+
+    return sim;
+}
+
+static void test_refresh_pacing(void)
+{
+    // Ticks at exactly the frame period race the vsync of the frame they started
+    refresh_sim_t exact = refresh_simulate(REFRESH_FRAME_US, 500, 250);
+    CHECK(exact.deferred > 0);
+    CHECK_EQ(exact.mismatches, 0);
+
+    // With the margin every tick comes after the vsync
+    refresh_sim_t paced = refresh_simulate(esp_lcd_panel_st7262_refresh_period_us(REFRESH_FRAME_US), 500, 250);
+    CHECK_EQ(paced.deferred, 0);
+    CHECK_EQ(paced.mismatches, 0);
+    CHECK(paced.flips > 0);
+
+    printf("refresh: %u ticks, deferred %u at the frame period, %u with %d%% margin, %u flips\n",
+           exact.ticks, exact.deferred, paced.deferred, ESP_LCD_PANEL_ST7262_REFRESH_MARGIN_PCT, paced.flips);
+}
+
+void test_refresh(void)
+{
+    test_refresh_policy();
+    test_refresh_pacing();
+}
@@ -0,0 +1,145 @@
+#include <string.h>
+#include "host_test.h"
+#include "gt911_emu.h"
+#include "gt911_report.h"
+
+#define REG(addr) ((addr) - GT911_EMU_REG_BASE)
+
+static gt911_emu_event_t report_event(uint8_t touches)
+{
+    gt911_emu_event_t event = {.touches = touches};
+    for (uint8_t i = 0; i < touches && i < GT911_MAX_POINTS; i++)
+    {
+        // Values above 255 check the byte order of every field
+        event.points[i] = (gt911_point_t){.id = (uint8_t)(i + 3), .x = (uint16_t)(0x0123 + i * 0x0101), .y = (uint16_t)(0x0210 + i), .size = (uint16_t)(0x0302 + i)};
+    }
+    return event;
+}
+
+static void check_points(const gt911_report_t *report, const gt911_emu_event_t *event, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        CHECK_EQ(report->points[i].id, event->points[i].id);
+        CHECK_EQ(report->points[i].x, event->points[i].x);
+        CHECK_EQ(report->points[i].y, event->points[i].y);
+        CHECK_EQ(report->points[i].size, event->points[i].size);
+    }
+}
+
+// Read one report and return the transfers it took
+static uint32_t read_report(gt911_emu_t *emu, gt911_report_t *report, esp_err_t expected)
+{
+    gt911_transport_t transport = gt911_emu_transport(emu);
+    uint32_t before = emu->stats.transactions;
+    CHECK_EQ(gt911_report_read(&transport, 10, report), expected);
+    return emu->stats.transactions - before;
+}
+
+static void test_report_handshake(void)
+{
+    gt911_emu_t emu;
+    gt911_report_t report;
+    gt911_emu_init(&emu);
+
+    // Nothing posted: one status read, no report and nothing acknowledged
+    CHECK_EQ(read_report(&emu, &report, ESP_ERR_NOT_FOUND), 1);
+    CHECK_EQ(emu.stats.frames_read, 0);
+    CHECK_EQ(emu.stats.bytes_written, 0);
+
+    // One touch: status and record in one burst, then the clear
+    gt911_emu_event_t one = report_event(1);
+    gt911_emu_post(&emu, &one);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 2);
+    CHECK_EQ(report.touches, 1);
+    CHECK_EQ(report.point_info, 0x81);
+    check_points(&report, &one, 1);
+    CHECK_EQ(emu.regs[REG(GT911_REPORT_REG)], 0);
+    CHECK_EQ(emu.stats.bytes_read, 2 * (1 + GT911_REPORT_POINT_SIZE));
+    CHECK_EQ(emu.stats.bytes_written, 1);
+
+    // The same report is not read twice
+    CHECK_EQ(read_report(&emu, &report, ESP_ERR_NOT_FOUND), 1);
+    CHECK_EQ(emu.stats.frames_read, 1);
+
+    // A release is a report without touches
+    gt911_emu_event_t release = report_event(0);
+    gt911_emu_post(&emu, &release);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 2);
+    CHECK_EQ(report.touches, 0);
+    CHECK_EQ(report.point_info, 0x80);
+
+    // A report posted before the previous one is acknowledged waits for the clear
+    gt911_emu_event_t two = report_event(2);
+    gt911_emu_event_t three = report_event(3);
+    gt911_emu_post(&emu, &two);
+    gt911_emu_post(&emu, &three);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 3);
+    CHECK_EQ(report.touches, 2);
+    check_points(&report, &two, 2);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 3);
+    CHECK_EQ(report.touches, 3);
+    check_points(&report, &three, 3);
+    CHECK_EQ(emu.stats.frames_overrun, 0);
+}
+
+static void test_report_limits(void)
+{
+    gt911_emu_t emu;
+    gt911_report_t report;
+    gt911_emu_init(&emu);
+
+    // Five touches: the remaining four records in one read
+    gt911_emu_event_t five = report_event(5);
+    gt911_emu_post(&emu, &five);
+    uint32_t read_before = emu.stats.bytes_read;
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 3);
+    CHECK_EQ(emu.stats.bytes_read - read_before, 1 + 5 * GT911_REPORT_POINT_SIZE);
+    check_points(&report, &five, 5);
+
+    // The configured touch number limits the records the controller fills
+    emu.regs[REG(0x804C)] = 2;
+    gt911_emu_post(&emu, &five);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 3);
+    CHECK_EQ(report.touches, 2);
+    check_points(&report, &five, 2);
+
+    // A touch count above the record count only reads the records that exist, the
+    // other status bits are kept for the caller
+    emu.regs[REG(GT911_REPORT_REG)] = 0x80 | 0x40 | 0x10 | 7;
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 3);
+    CHECK_EQ(report.touches, 7);
+    CHECK_EQ(report.point_info, 0x80 | 0x40 | 0x10 | 7);
+
+    // A failed status read acknowledges nothing, the report is read on the next try
+    gt911_emu_event_t one = report_event(1);
+    gt911_emu_post(&emu, &one);
+    emu.fail_next = 1;
+    CHECK_EQ(read_report(&emu, &report, ESP_ERR_TIMEOUT), 1);
+    CHECK_EQ(read_report(&emu, &report, ESP_OK), 2);
+    check_points(&report, &one, 1);
+}
+
+static void test_report_decode(void)
+{
+    uint8_t data[1 + GT911_MAX_POINTS * GT911_REPORT_POINT_SIZE] = {0x82, 4, 0x34, 0x12, 0x78, 0x56, 0x10, 0x00, 0xFF, 9, 0xFF, 0xFF, 0, 0, 1, 0, 0};
+    gt911_report_t report;
+    gt911_report_decode(data, &report);
+
+    CHECK_EQ(report.touches, 2);
+    CHECK_EQ(report.points[0].id, 4);
+    CHECK_EQ(report.points[0].x, 0x1234);
+    CHECK_EQ(report.points[0].y, 0x5678);
+    CHECK_EQ(report.points[0].size, 0x10);
+    CHECK_EQ(report.points[1].id, 9);
+    CHECK_EQ(report.points[1].x, 0xFFFF);
+    CHECK_EQ(report.points[1].y, 0);
+    CHECK_EQ(report.points[1].size, 1);
+}
+
+void test_report(void)
+{
+    test_report_decode();
+    test_report_handshake();
+    test_report_limits();
+}
@@ -0,0 +1,148 @@
+#include <pthread.h>
+#include <sched.h>
+#include "host_test.h"
+#include "gt911_ring.h"
+
+#define RING_REPORTS 100000
+
+// Every field derives from the sequence, so a torn copy shows
+static gt911_touch_t ring_report(uint32_t seq)
+{
+    gt911_touch_t touch = {.touches = 1, .is_touched = true, .sequence = seq, .timestamp_us = (int64_t)seq * 10};
+    touch.points[0] = (gt911_point_t){.id = (uint8_t)seq, .x = (uint16_t)seq, .y = (uint16_t)~seq, .size = (uint16_t)(seq >> 16)};
+    return touch;
+}
+
+static bool ring_report_ok(const gt911_touch_t *touch)
+{
+    gt911_touch_t expected = ring_report(touch->sequence);
+    return touch->timestamp_us == expected.timestamp_us && touch->points[0].id == expected.points[0].id &&
+           touch->points[0].x == expected.points[0].x && touch->points[0].y == expected.points[0].y &&
+           touch->points[0].size == expected.points[0].size;
+}
+
+static void test_ring_single(void)
+{
+    gt911_ring_t ring;
+    gt911_touch_t touch;
+    gt911_ring_init(&ring);
+
+    CHECK(!gt911_ring_pop(&ring, &touch));
+    CHECK(!gt911_ring_latest(&ring, &touch));
+
+    // Fill, overflow and drain in order
+    for (uint32_t seq = 1; seq <= GT911_RING_SIZE + 3; seq++)
+    {
+        gt911_touch_t report = ring_report(seq);
+        CHECK_EQ(gt911_ring_push(&ring, &report), seq <= GT911_RING_SIZE);
+    }
+    CHECK_EQ(gt911_ring_count(&ring), GT911_RING_SIZE);
+    CHECK_EQ(ring.pushed, GT911_RING_SIZE + 3);
+    CHECK_EQ(ring.dropped, 3);
+
+    // The latest slot keeps the newest report even when it was not buffered
+    CHECK(gt911_ring_latest(&ring, &touch));
+    CHECK_EQ(touch.sequence, GT911_RING_SIZE + 3);
+
+    for (uint32_t seq = 1; seq <= GT911_RING_SIZE; seq++)
+    {
+        CHECK(gt911_ring_pop(&ring, &touch));
+        CHECK_EQ(touch.sequence, seq);
+        CHECK(ring_report_ok(&touch));
+    }
+    CHECK(!gt911_ring_pop(&ring, &touch));
+    CHECK_EQ(gt911_ring_count(&ring), 0);
+}
+
+typedef struct
+{
+    gt911_ring_t ring;
+    uint32_t latest_torn;
+    uint32_t latest_backwards;
+    volatile bool done;
+} ring_shared_t;
+
+static void *ring_producer(void *arg)
+{
+    ring_shared_t *shared = (ring_shared_t *)arg;
+    for (uint32_t seq = 1; seq <= RING_REPORTS; seq++)
+    {
+        gt911_touch_t report = ring_report(seq);
+        while (!gt911_ring_push(&shared->ring, &report))
+        {
+            // Full, the reader task would drop it; retry here so the order can be checked
+            sched_yield();
+        }
+    }
+    __atomic_store_n(&shared->done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// A second reader of the latest slot, like gt911_get_touch() from another task
+static void *ring_latest_reader(void *arg)
+{
+    ring_shared_t *shared = (ring_shared_t *)arg;
+    uint32_t last = 0;
+    gt911_touch_t touch;
+    while (!__atomic_load_n(&shared->done, __ATOMIC_ACQUIRE))
+    {
+        if (gt911_ring_latest(&shared->ring, &touch))
+        {
+            shared->latest_torn += !ring_report_ok(&touch);
+            shared->latest_backwards += touch.sequence < last;
+            last = touch.sequence;
+        }
+        sched_yield();
+    }
+    return NULL;
+}
+
+static void test_ring_threads(void)
+{
+    static ring_shared_t shared;
+    gt911_ring_init(&shared.ring);
+    shared.done = false;
+
+    pthread_t producer, latest;
+    int64_t start = host_now_us();
+    CHECK_EQ(pthread_create(&producer, NULL, ring_producer, &shared), 0);
+    CHECK_EQ(pthread_create(&latest, NULL, ring_latest_reader, &shared), 0);
+
+    uint32_t expected = 1;
+    uint32_t out_of_order = 0;
+    uint32_t torn = 0;
+    uint32_t max_count = 0;
+    gt911_touch_t touch;
+    while (expected <= RING_REPORTS)
+    {
+        uint32_t count = gt911_ring_count(&shared.ring);
+        max_count = count > max_count ? count : max_count;
+        if (!gt911_ring_pop(&shared.ring, &touch))
+        {
+            sched_yield();
+            continue;
+        }
+        out_of_order += touch.sequence != expected;
+        torn += !ring_report_ok(&touch);
+        expected++;
+    }
+    int64_t elapsed = host_now_us() - start;
+
+    pthread_join(producer, NULL);
+    pthread_join(latest, NULL);
+
+    CHECK_EQ(out_of_order, 0);
+    CHECK_EQ(torn, 0);
+    CHECK(max_count <= GT911_RING_SIZE);
+    CHECK_EQ(shared.latest_torn, 0);
+    CHECK_EQ(shared.latest_backwards, 0);
+
+    printf("ring: %u reports between threads, %.0f ns each, %u dropped pushes retried, at most %u buffered\n",
+           RING_REPORTS, elapsed * 1000.0 / RING_REPORTS, shared.ring.dropped, max_count);
+}
+
+void test_ring(void)
+{
+    test_ring_single();
+    test_ring_threads();
+}
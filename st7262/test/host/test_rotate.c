@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "esp_lcd_st7262_rotate.h"
+
+#define ROTATE_PANEL_W 800
+#define ROTATE_PANEL_H 480
+
+static const char *const rotation_names[] = {"0", "90", "180", "270"};
+
+// Panel position of logical pixel (x, y) on a screen rotated by rotation
+static void naive_map(esp_lcd_panel_st7262_rotation_t rotation, uint32_t panel_w, uint32_t panel_h, uint32_t x, uint32_t y,
+                      uint32_t *px, uint32_t *py)
+{
+    switch (rotation)
+    {
+    case ESP_LCD_PANEL_ST7262_ROTATION_90:
+        *px = y;
+        *py = panel_h - 1 - x;
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_180:
+        *px = panel_w - 1 - x;
+        *py = panel_h - 1 - y;
+        break;
+    case ESP_LCD_PANEL_ST7262_ROTATION_270:
+        *px = panel_w - 1 - y;
+        *py = x;
+        break;
+    default:
+        *px = x;
+        *py = y;
+        break;
+    }
+}
+
+// Straight per-pixel loop over the whole block, what the tiled transpose replaces
+static void naive_rotate(const uint16_t *src, uint32_t w, uint32_t h, uint16_t *dst, esp_lcd_panel_st7262_rotation_t rotation)
+{
+    bool swapped = rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+    uint32_t dst_w = swapped ? h : w;
+    uint32_t dst_h = swapped ? w : h;
+    for (uint32_t y = 0; y < h; y++)
+    {
+        for (uint32_t x = 0; x < w; x++)
+        {
+            uint32_t px, py;
+            naive_map(rotation, dst_w, dst_h, x, y, &px, &py);
+            dst[py * dst_w + px] = src[y * w + x];
+        }
+    }
+}
+
+static void fill_pattern(uint16_t *buf, uint32_t count, uint32_t seed)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        buf[i] = (uint16_t)(i * 2654435761u + seed);
+    }
+}
+
+// Blocks of every shape around the tile size, with padded strides
+static void test_rotate_blocks(void)
+{
+    static uint16_t src[40 * 40];
+    static uint16_t expected[40 * 40];
+    static uint16_t dst[48 * 48];
+
+    for (uint32_t rotation = 0; rotation < 4; rotation++)
+    {
+        bool swapped = rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+        uint32_t mismatches = 0;
+        for (uint32_t w = 1; w <= 40; w += 3)
+        {
+            for (uint32_t h = 1; h <= 40; h += 5)
+            {
+                fill_pattern(src, w * h, w + h);
+                naive_rotate(src, w, h, expected, rotation);
+                memset(dst, 0, sizeof(dst));
+                esp_lcd_panel_st7262_rotate_rgb565(src, w * 2, w, h, dst, 48 * 2, rotation);
+
+                uint32_t dst_w = swapped ? h : w;
+                uint32_t dst_h = swapped ? w : h;
+                for (uint32_t y = 0; y < 48; y++)
+                {
+                    for (uint32_t x = 0; x < 48; x++)
+                    {
+                        uint16_t want = x < dst_w && y < dst_h ? expected[y * dst_w + x] : 0;
+                        mismatches += dst[y * 48 + x] != want;
+                    }
+                }
+            }
+        }
+        if (mismatches != 0)
+        {
+            fprintf(stderr, "rotate: %s degrees differs in %u pixels\n", rotation_names[rotation], mismatches);
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+}
+
+// Rotating areas one by one and placing them with rotate_area equals rotating the whole screen
+static void test_rotate_areas(uint16_t *logical, uint16_t *expected, uint16_t *panel, uint16_t *scratch)
+{
+    fill_pattern(logical, ROTATE_PANEL_W * ROTATE_PANEL_H, 7);
+
+    for (uint32_t rotation = 0; rotation < 4; rotation++)
+    {
+        bool swapped = rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+        uint32_t lw = swapped ? ROTATE_PANEL_H : ROTATE_PANEL_W;
+        uint32_t lh = swapped ? ROTATE_PANEL_W : ROTATE_PANEL_H;
+        naive_rotate(logical, lw, lh, expected, rotation);
+        memset(panel, 0, ROTATE_PANEL_W * ROTATE_PANEL_H * sizeof(uint16_t));
+
+        // Uneven bands of whole rows, like LVGL partial rendering, split in two columns
+        uint32_t split = lw / 3 + 5;
+        for (uint32_t y = 0; y < lh;)
+        {
+            uint32_t rows = y % 7 + 37 < lh - y ? y % 7 + 37 : lh - y;
+            for (uint32_t half = 0; half < 2; half++)
+            {
+                uint32_t x = half ? split : 0;
+                uint32_t w = half ? lw - split : split;
+                esp_lcd_panel_st7262_rotate_rgb565(logical + y * lw + x, lw * 2, w, rows, scratch, (swapped ? rows : w) * 2, rotation);
+
+                int x1 = x, y1 = y, x2 = x + w, y2 = y + rows;
+                esp_lcd_panel_st7262_rotate_area(ROTATE_PANEL_W, ROTATE_PANEL_H, rotation, &x1, &y1, &x2, &y2);
+                CHECK(x1 >= 0 && y1 >= 0 && x2 <= ROTATE_PANEL_W && y2 <= ROTATE_PANEL_H);
+                CHECK_EQ((uint32_t)((x2 - x1) * (y2 - y1)), w * rows);
+                for (int py = y1; py < y2; py++)
+                {
+                    memcpy(&panel[py * ROTATE_PANEL_W + x1], &scratch[(py - y1) * (x2 - x1)], (x2 - x1) * sizeof(uint16_t));
+                }
+            }
+            y += rows;
+        }
+
+        CHECK(memcmp(panel, expected, ROTATE_PANEL_W * ROTATE_PANEL_H * sizeof(uint16_t)) == 0);
+    }
+}
+
+static double bench_us(const uint16_t *src, uint32_t w, uint32_t h, uint16_t *dst, esp_lcd_panel_st7262_rotation_t rotation, bool naive)
+{
+    bool swapped = rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+    const uint32_t frames = 20;
+    int64_t start = host_now_us();
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        if (naive)
+        {
+            naive_rotate(src, w, h, dst, rotation);
+        }
+        else
+        {
+            esp_lcd_panel_st7262_rotate_rgb565(src, w * 2, w, h, dst, (swapped ? h : w) * 2, rotation);
+        }
+    }
+    return (double)(host_now_us() - start) / frames;
+}
+
+// Full 800x480 frames, tiled transpose against the naive per-pixel loop
+static void test_rotate_bench(const uint16_t *src, uint16_t *dst)
+{
+    for (uint32_t rotation = 1; rotation < 4; rotation++)
+    {
+        bool swapped = rotation == ESP_LCD_PANEL_ST7262_ROTATION_90 || rotation == ESP_LCD_PANEL_ST7262_ROTATION_270;
+        uint32_t w = swapped ? ROTATE_PANEL_H : ROTATE_PANEL_W;
+        uint32_t h = swapped ? ROTATE_PANEL_W : ROTATE_PANEL_H;
+        double naive = bench_us(src, w, h, dst, rotation, true);
+        double tiled = bench_us(src, w, h, dst, rotation, false);
+        printf("rotate: %3s degrees 800x480 naive %7.0f us tiled %7.0f us (%.2fx)\n", rotation_names[rotation], naive, tiled,
+               tiled > 0 ? naive / tiled : 0);
+    }
+}
+
+void test_rotate(void)
+{
+    size_t bytes = ROTATE_PANEL_W * ROTATE_PANEL_H * sizeof(uint16_t);
+    uint16_t *logical = malloc(bytes);
+    uint16_t *expected = malloc(bytes);
+    uint16_t *panel = malloc(bytes);
+    uint16_t *scratch = malloc(bytes);
+    CHECK(logical != NULL && expected != NULL && panel != NULL && scratch != NULL);
+
+    if (logical != NULL && expected != NULL && panel != NULL && scratch != NULL)
+    {
+        test_rotate_blocks();
+        test_rotate_areas(logical, expected, panel, scratch);
+        test_rotate_bench(logical, panel);
+    }
+
+    free(logical);
+    free(expected);
+    free(panel);
+    free(scratch);
+}
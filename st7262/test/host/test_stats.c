@@ -0,0 +1,218 @@
+#include <pthread.h>
+#include <string.h>
+#include "host_test.h"
+// As CONFIG_ESP_LCD_ST7262_STATS sets it for the driver, so the recording macros are live
+#define ESP_LCD_PANEL_ST7262_STATS 1
+#include "esp_lcd_st7262_stats.h"
+
+#define STATS_THREAD_RECORDS 100000
+
+static uint32_t word_at(const uint8_t *buf, size_t index)
+{
+    const uint8_t *p = buf + index * sizeof(uint32_t);
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void test_stats_buckets(void)
+{
+    esp_lcd_panel_st7262_histogram_t hist = {0};
+
+    // Bucket 0 counts zeros, bucket i counts [2^(i-1), 2^i)
+    const uint32_t values[] = {0, 1, 2, 3, 4, 7, 8, 1000};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+    {
+        ESP_LCD_PANEL_ST7262_STATS_RECORD(&hist, values[i]);
+    }
+    CHECK_EQ(hist.count, 8);
+    CHECK_EQ(hist.max, 1000);
+    CHECK_EQ(hist.buckets[0], 1);
+    CHECK_EQ(hist.buckets[1], 1);
+    CHECK_EQ(hist.buckets[2], 2);
+    CHECK_EQ(hist.buckets[3], 2);
+    CHECK_EQ(hist.buckets[4], 1);
+    CHECK_EQ(hist.buckets[10], 1);
+
+    // The last bucket also takes everything above 2^23
+    ESP_LCD_PANEL_ST7262_STATS_RECORD(&hist, (1u << 22) - 1);
+    ESP_LCD_PANEL_ST7262_STATS_RECORD(&hist, 1u << 22);
+    ESP_LCD_PANEL_ST7262_STATS_RECORD(&hist, UINT32_MAX);
+    CHECK_EQ(hist.buckets[22], 1);
+    CHECK_EQ(hist.buckets[ESP_LCD_PANEL_ST7262_HIST_BUCKETS - 1], 2);
+    CHECK_EQ(hist.max, UINT32_MAX);
+
+    uint32_t missed = 0;
+    ESP_LCD_PANEL_ST7262_STATS_ADD(&missed, 3);
+    CHECK_EQ(missed, 3);
+}
+
+static void test_stats_percentiles(void)
+{
+    esp_lcd_panel_st7262_histogram_t hist = {0};
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 50), 0);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(NULL, 50), 0);
+
+    // 1..100: the median falls in [32, 64), the top decile in [64, 128) capped by the maximum
+    for (uint32_t value = 1; value <= 100; value++)
+    {
+        esp_lcd_panel_st7262_histogram_record(&hist, value);
+    }
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 0), 1);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 1), 1);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 50), 63);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 63), 63);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 64), 100);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 99), 100);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&hist, 150), 100);
+
+    // Only zeros, and only values in the last bucket
+    esp_lcd_panel_st7262_histogram_t zeros = {0};
+    esp_lcd_panel_st7262_histogram_record(&zeros, 0);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&zeros, 99), 0);
+    esp_lcd_panel_st7262_histogram_t large = {0};
+    esp_lcd_panel_st7262_histogram_record(&large, 1u << 30);
+    CHECK_EQ(esp_lcd_panel_st7262_histogram_percentile(&large, 50), 1u << 30);
+}
+
+static void *stats_recorder(void *arg)
+{
+    esp_lcd_panel_st7262_stats_t *stats = arg;
+    for (uint32_t i = 0; i < STATS_THREAD_RECORDS; i++)
+    {
+        esp_lcd_panel_st7262_histogram_record(&stats->draw_us, i & 0xFF);
+    }
+    return NULL;
+}
+
+// Two recorders racing a reader that takes and resets, no record is lost or counted twice
+static void test_stats_take(void)
+{
+    esp_lcd_panel_st7262_stats_t stats = {0};
+    esp_lcd_panel_st7262_stats_t copy;
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++)
+    {
+        CHECK_EQ(pthread_create(&threads[i], NULL, stats_recorder, &stats), 0);
+    }
+
+    uint64_t counted = 0, bucketed = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        esp_lcd_panel_st7262_stats_take(&stats, &copy);
+        counted += copy.draw_us.count;
+        for (int b = 0; b < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; b++)
+        {
+            bucketed += copy.draw_us.buckets[b];
+        }
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    esp_lcd_panel_st7262_stats_take(&stats, &copy);
+    counted += copy.draw_us.count;
+    for (int b = 0; b < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; b++)
+    {
+        bucketed += copy.draw_us.buckets[b];
+    }
+
+    CHECK_EQ(counted, 2 * STATS_THREAD_RECORDS);
+    CHECK_EQ(bucketed, 2 * STATS_THREAD_RECORDS);
+    CHECK_EQ(stats.draw_us.count, 0);
+    CHECK_EQ(stats.draw_us.max, 0);
+
+    // NULL copy only resets
+    esp_lcd_panel_st7262_histogram_record(&stats.vsync_interval_us, 16667);
+    esp_lcd_panel_st7262_stats_take(&stats, NULL);
+    CHECK_EQ(stats.vsync_interval_us.count, 0);
+}
+
+static void sample_stats(esp_lcd_panel_st7262_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    for (int i = 0; i < 3; i++)
+    {
+        esp_lcd_panel_st7262_histogram_record(&stats->vsync_interval_us, 16667); // Bucket 15
+    }
+    esp_lcd_panel_st7262_histogram_record(&stats->draw_bytes, 0);
+    esp_lcd_panel_st7262_histogram_record(&stats->draw_us, 5); // Bucket 3
+    stats->missed_vsyncs = 2;
+}
+
+static void test_stats_csv(void)
+{
+    esp_lcd_panel_st7262_stats_t stats;
+    sample_stats(&stats);
+
+    char expected[512];
+    int pos = snprintf(expected, sizeof(expected), "vsync_interval_us,3,16667");
+    for (int i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        pos += snprintf(expected + pos, sizeof(expected) - pos, ",%d", i == 15 ? 3 : 0);
+    }
+    pos += snprintf(expected + pos, sizeof(expected) - pos, "\ndraw_bytes,1,0,1");
+    for (int i = 1; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        pos += snprintf(expected + pos, sizeof(expected) - pos, ",0");
+    }
+    pos += snprintf(expected + pos, sizeof(expected) - pos, "\ndraw_us,1,5");
+    for (int i = 0; i < ESP_LCD_PANEL_ST7262_HIST_BUCKETS; i++)
+    {
+        pos += snprintf(expected + pos, sizeof(expected) - pos, ",%d", i == 3 ? 1 : 0);
+    }
+    pos += snprintf(expected + pos, sizeof(expected) - pos, "\nmissed_vsyncs,2\n");
+
+    // Sizing call, exact buffer, truncation
+    size_t needed = esp_lcd_panel_st7262_stats_csv(&stats, NULL, 0);
+    CHECK_EQ(needed, pos);
+    char buf[512];
+    CHECK_EQ(esp_lcd_panel_st7262_stats_csv(&stats, buf, needed + 1), needed);
+    CHECK(strcmp(buf, expected) == 0);
+
+    char small[20];
+    CHECK_EQ(esp_lcd_panel_st7262_stats_csv(&stats, small, sizeof(small)), needed);
+    CHECK_EQ(strlen(small), sizeof(small) - 1);
+    CHECK(strncmp(small, expected, sizeof(small) - 1) == 0);
+    CHECK_EQ(esp_lcd_panel_st7262_stats_csv(NULL, buf, sizeof(buf)), 0);
+
+    printf("stats: csv %zu bytes, first line %.*s\n", needed, (int)(strchr(buf, '\n') - buf), buf);
+}
+
+static void test_stats_pack(void)
+{
+    esp_lcd_panel_st7262_stats_t stats;
+    sample_stats(&stats);
+
+    uint8_t buf[ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE + 4];
+    CHECK_EQ(ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE, (2 + 3 * 26 + 1) * 4);
+    CHECK_EQ(esp_lcd_panel_st7262_stats_pack(&stats, buf, sizeof(buf)), ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE);
+
+    // Version, bucket count, then count, max and buckets per histogram, then missed vsyncs
+    const size_t hist_words = 2 + ESP_LCD_PANEL_ST7262_HIST_BUCKETS;
+    CHECK_EQ(word_at(buf, 0), 1);
+    CHECK_EQ(word_at(buf, 1), ESP_LCD_PANEL_ST7262_HIST_BUCKETS);
+    CHECK_EQ(word_at(buf, 2), 3);
+    CHECK_EQ(word_at(buf, 3), 16667);
+    CHECK_EQ(word_at(buf, 4 + 15), 3);
+    CHECK_EQ(word_at(buf, 2 + hist_words), 1);
+    CHECK_EQ(word_at(buf, 2 + hist_words + 2), 1);
+    CHECK_EQ(word_at(buf, 2 + 2 * hist_words + 1), 5);
+    CHECK_EQ(word_at(buf, 2 + 2 * hist_words + 2 + 3), 1);
+    CHECK_EQ(word_at(buf, 2 + 3 * hist_words), 2);
+
+    // Little-endian whatever the host
+    CHECK_EQ(buf[12], 16667 & 0xFF);
+    CHECK_EQ(buf[13], 16667 >> 8);
+
+    CHECK_EQ(esp_lcd_panel_st7262_stats_pack(&stats, buf, ESP_LCD_PANEL_ST7262_STATS_PACKED_SIZE - 1), 0);
+    CHECK_EQ(esp_lcd_panel_st7262_stats_pack(NULL, buf, sizeof(buf)), 0);
+    CHECK_EQ(esp_lcd_panel_st7262_stats_pack(&stats, NULL, sizeof(buf)), 0);
+}
+
+void test_stats(void)
+{
+    test_stats_buckets();
+    test_stats_percentiles();
+    test_stats_take();
+    test_stats_csv();
+    test_stats_pack();
+}
@@ -0,0 +1,110 @@
+#include "host_test.h"
+#include "esp_lcd_st7262_timing.h"
+
+#define TIMING_DIRECT_MAX_PCLK 16533333 // Limit of the direct GDMA scanout, see the bandwidth suite
+
+typedef struct
+{
+    const char *name;
+    uint32_t fps_x100;
+    uint32_t line_time_ns;
+    uint32_t frame_time_us;
+    uint32_t direct_bytes_per_s; // PCLK * 2, GDMA streams while pixels are clocked out
+    uint32_t bounce_bytes_per_s; // Spread over the whole 820-clock line
+    esp_lcd_panel_st7262_timing_status_t direct;
+} timing_expected_t;
+
+// 820 x 500 clocks per frame with the 8048S043 porches
+static const timing_expected_t timing_expected[] = {
+    {"12MHZ", 2926, 68333, 34166, 24000000, 23414634, ESP_LCD_PANEL_ST7262_TIMING_OK},
+    {"16MHZ", 3902, 51250, 25625, 32000000, 31219512, ESP_LCD_PANEL_ST7262_TIMING_OK},
+    {"21MHZ", 5121, 39047, 19523, 42000000, 40975609, ESP_LCD_PANEL_ST7262_TIMING_UNSUSTAINABLE},
+};
+
+static const esp_lcd_panel_st7262_timing_mode_t timing_direct = {.h_res = 800, .v_res = 480, .bytes_per_px = 2};
+static const esp_lcd_panel_st7262_timing_mode_t timing_bounce = {.h_res = 800, .v_res = 480, .bytes_per_px = 2, .bounce_buffer_lines = 10};
+
+static void test_timing_profiles(void)
+{
+    CHECK_EQ(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT, 3);
+    CHECK(esp_lcd_panel_st7262_timing_find(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS, ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT, "24MHZ") == NULL);
+    CHECK(esp_lcd_panel_st7262_timing_find(NULL, 3, "16MHZ") == NULL);
+    CHECK(esp_lcd_panel_st7262_timing_find(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS, ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT, NULL) == NULL);
+
+    for (size_t i = 0; i < sizeof(timing_expected) / sizeof(timing_expected[0]); i++)
+    {
+        const timing_expected_t *expected = &timing_expected[i];
+        const esp_lcd_panel_st7262_timing_profile_t *profile =
+            esp_lcd_panel_st7262_timing_find(ESP_LCD_PANEL_ST7262_8048S043_TIMINGS, ESP_LCD_PANEL_ST7262_8048S043_TIMINGS_COUNT, expected->name);
+        CHECK(profile != NULL);
+        if (profile == NULL)
+        {
+            continue;
+        }
+
+        esp_lcd_panel_st7262_timing_result_t result;
+        CHECK(esp_lcd_panel_st7262_timing_calc(&timing_direct, profile, &result));
+        CHECK_EQ(result.h_total, 820);
+        CHECK_EQ(result.v_total, 500);
+        CHECK_EQ(result.fps_x100, expected->fps_x100);
+        CHECK_EQ(result.line_time_ns, expected->line_time_ns);
+        CHECK_EQ(result.frame_time_us, expected->frame_time_us);
+        CHECK_EQ(result.bandwidth.required_bytes_per_s, expected->direct_bytes_per_s);
+        CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, profile, NULL), expected->direct);
+        uint32_t direct_headroom = result.headroom_pct;
+
+        // Bounce buffers sustain every profile
+        CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_bounce, profile, &result), ESP_LCD_PANEL_ST7262_TIMING_OK);
+        CHECK_EQ(result.bandwidth.required_bytes_per_s, expected->bounce_bytes_per_s);
+        CHECK(result.headroom_pct > 0);
+
+        printf("timing: %-5s %2u.%02u fps, line %u ns, frame %u us, direct %u B/s (%u%% headroom), bounce %u B/s (%u%% headroom)\n",
+               profile->name, result.fps_x100 / 100, result.fps_x100 % 100, result.line_time_ns, result.frame_time_us,
+               expected->direct_bytes_per_s, direct_headroom, result.bandwidth.required_bytes_per_s, result.headroom_pct);
+    }
+}
+
+static void test_timing_boundaries(void)
+{
+    esp_lcd_panel_st7262_timing_profile_t profile = ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[1];
+    esp_lcd_panel_st7262_timing_result_t result;
+
+    // Exactly at the direct scanout limit, and one clock above it
+    profile.pclk_hz = TIMING_DIRECT_MAX_PCLK;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, &result), ESP_LCD_PANEL_ST7262_TIMING_OK);
+    CHECK_EQ(result.bandwidth.max_pclk_hz, TIMING_DIRECT_MAX_PCLK);
+    CHECK_EQ(result.headroom_pct, 0);
+    profile.pclk_hz = TIMING_DIRECT_MAX_PCLK + 1;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, &result), ESP_LCD_PANEL_ST7262_TIMING_UNSUSTAINABLE);
+    CHECK_EQ(result.headroom_pct, 0);
+
+    // The 16 MHz profile leaves 3 % of the direct limit
+    profile.pclk_hz = 16 * 1000 * 1000;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, &result), ESP_LCD_PANEL_ST7262_TIMING_OK);
+    CHECK_EQ(result.headroom_pct, 3);
+
+    // Invalid profiles and modes
+    profile.pclk_hz = 0;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    profile = ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[1];
+    profile.hsync_pulse_width = 0;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    profile = ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[1];
+    profile.vsync_pulse_width = 0;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    profile = ESP_LCD_PANEL_ST7262_8048S043_TIMINGS[1];
+    esp_lcd_panel_st7262_timing_mode_t mode = timing_direct;
+    mode.h_res = 0;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&mode, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    mode = timing_direct;
+    mode.bytes_per_px = 0;
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&mode, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(NULL, &profile, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+    CHECK_EQ(esp_lcd_panel_st7262_timing_validate(&timing_direct, NULL, NULL), ESP_LCD_PANEL_ST7262_TIMING_INVALID);
+}
+
+void test_timing(void)
+{
+    test_timing_profiles();
+    test_timing_boundaries();
+}
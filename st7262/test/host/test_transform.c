@@ -0,0 +1,237 @@
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "gt911_transform.h"
+
+#define TOUCH_W 480 // Controller resolution of the 8048S043
+#define TOUCH_H 272
+#define SCREEN_W 800
+#define SCREEN_H 480
+#define TRANSFORM_BENCH_POINTS (1 << 22)
+
+// gt911_update_transform(): calibration, then rotation, then scale to the screen
+static void build_transform(gt911_transform_t *t, const gt911_transform_t *calibration, uint8_t rotation)
+{
+    gt911_transform_t step;
+    *t = *calibration;
+    CHECK(gt911_transform_rotation(&step, rotation, TOUCH_W, TOUCH_H));
+    gt911_transform_compose(t, t, &step);
+
+    bool swapped = rotation == ROTATION_LEFT || rotation == ROTATION_RIGHT;
+    CHECK(gt911_transform_scale(&step, swapped ? TOUCH_H : TOUCH_W, swapped ? TOUCH_W : TOUCH_H, SCREEN_W, SCREEN_H));
+    gt911_transform_compose(t, t, &step);
+}
+
+// The intended mapping in floating point: the rotated axes span the controller range they
+// came from, then scale to the screen
+static void reference(uint8_t rotation, double x, double y, double *out_x, double *out_y)
+{
+    double rx, ry, rw, rh;
+    switch (rotation)
+    {
+    case ROTATION_NORMAL:
+        rx = TOUCH_W - x, ry = TOUCH_H - y, rw = TOUCH_W, rh = TOUCH_H;
+        break;
+    case ROTATION_LEFT:
+        rx = TOUCH_H - y, ry = x, rw = TOUCH_H, rh = TOUCH_W;
+        break;
+    case ROTATION_RIGHT:
+        rx = y, ry = TOUCH_W - x, rw = TOUCH_H, rh = TOUCH_W;
+        break;
+    default:
+        rx = x, ry = y, rw = TOUCH_W, rh = TOUCH_H;
+        break;
+    }
+    *out_x = rx * SCREEN_W / rw;
+    *out_y = ry * SCREEN_H / rh;
+}
+
+// The per-point switch and gt911_map_to_screen() the transform replaced
+static void baseline(uint8_t rotation, int32_t x, int32_t y, int32_t *out_x, int32_t *out_y)
+{
+    int32_t temp;
+    switch (rotation)
+    {
+    case ROTATION_NORMAL:
+        x = TOUCH_W - x;
+        y = TOUCH_H - y;
+        break;
+    case ROTATION_LEFT:
+        temp = x;
+        x = TOUCH_W - y;
+        y = temp;
+        break;
+    case ROTATION_RIGHT:
+        temp = x;
+        x = y;
+        y = TOUCH_H - temp;
+        break;
+    default:
+        break;
+    }
+    bool swapped = rotation == ROTATION_LEFT || rotation == ROTATION_RIGHT;
+    *out_x = x * SCREEN_W / (swapped ? TOUCH_H : TOUCH_W);
+    *out_y = y * SCREEN_H / (swapped ? TOUCH_W : TOUCH_H);
+}
+
+static void test_transform_rotations(void)
+{
+    gt911_transform_t identity;
+    gt911_transform_identity(&identity);
+
+    const uint8_t rotations[] = {ROTATION_LEFT, ROTATION_INVERTED, ROTATION_RIGHT, ROTATION_NORMAL};
+    const char *names[] = {"left", "inverted", "right", "normal"};
+    for (int r = 0; r < 4; r++)
+    {
+        gt911_transform_t t;
+        build_transform(&t, &identity, rotations[r]);
+
+        double max_err = 0;
+        int32_t max_baseline = 0;
+        for (int32_t y = 0; y <= TOUCH_H; y++)
+        {
+            for (int32_t x = 0; x <= TOUCH_W; x++)
+            {
+                gt911_point_t p = {.x = (uint16_t)x, .y = (uint16_t)y};
+                gt911_transform_apply(&t, &p, 1);
+
+                double rx, ry;
+                reference(rotations[r], x, y, &rx, &ry);
+                double err = fmax(fabs(p.x - rx), fabs(p.y - ry));
+                max_err = err > max_err ? err : max_err;
+
+                int32_t bx, by;
+                baseline(rotations[r], x, y, &bx, &by);
+                int32_t diff = abs(p.x - bx) > abs(p.y - by) ? abs(p.x - bx) : abs(p.y - by);
+                max_baseline = diff > max_baseline ? diff : max_baseline;
+            }
+        }
+
+        // Rounded to the nearest pixel, the Q16 coefficients add a few thousandths
+        CHECK(max_err <= 0.51);
+        if (rotations[r] == ROTATION_LEFT || rotations[r] == ROTATION_RIGHT)
+        {
+            // The old switch used W - y and H - x on the swapped axes, which shifted these
+            // rotations by (W - H) controller pixels, scaled to the screen axis they land on
+            int32_t shift = rotations[r] == ROTATION_LEFT ? (TOUCH_W - TOUCH_H) * SCREEN_W / TOUCH_H : (TOUCH_W - TOUCH_H) * SCREEN_H / TOUCH_W;
+            CHECK(abs(max_baseline - shift) <= 1);
+        }
+        else
+        {
+            // The old path truncated instead of rounding
+            CHECK(max_baseline <= 1);
+        }
+        printf("transform: %-8s max error %.3f px, max difference to the old mapping %d px\n", names[r], max_err, max_baseline);
+    }
+
+    // Corners stay on the screen for every rotation
+    for (int r = 0; r < 4; r++)
+    {
+        gt911_transform_t t;
+        build_transform(&t, &identity, rotations[r]);
+        gt911_point_t corners[4] = {{.x = 0, .y = 0}, {.x = TOUCH_W, .y = 0}, {.x = 0, .y = TOUCH_H}, {.x = TOUCH_W, .y = TOUCH_H}};
+        gt911_transform_apply(&t, corners, 4);
+        for (int c = 0; c < 4; c++)
+        {
+            CHECK(corners[c].x <= SCREEN_W);
+            CHECK(corners[c].y <= SCREEN_H);
+        }
+    }
+}
+
+static void test_transform_calibration(void)
+{
+    // A panel that is slightly rotated, scaled and offset against the controller
+    const double ca = 0.98, cb = 0.03, cc = 4.5, cd = -0.02, ce = 1.03, cf = -3.0;
+    gt911_point_t reported[3] = {{.x = 30, .y = 25}, {.x = 450, .y = 130}, {.x = 240, .y = 250}};
+    gt911_point_t expected[3];
+    for (int i = 0; i < 3; i++)
+    {
+        expected[i].x = (uint16_t)lround(ca * reported[i].x + cb * reported[i].y + cc);
+        expected[i].y = (uint16_t)lround(cd * reported[i].x + ce * reported[i].y + cf);
+    }
+
+    gt911_transform_t calibration;
+    CHECK(gt911_transform_from_points(&calibration, reported, expected));
+
+    // The three pairs map exactly
+    gt911_point_t check[3] = {reported[0], reported[1], reported[2]};
+    gt911_transform_apply(&calibration, check, 3);
+    for (int i = 0; i < 3; i++)
+    {
+        CHECK_EQ(check[i].x, expected[i].x);
+        CHECK_EQ(check[i].y, expected[i].y);
+    }
+
+    // Every other point close to the exact correction, the targets are whole pixels and
+    // the solved transform extrapolates their rounding
+    double max_err = 0;
+    for (int32_t y = 10; y < TOUCH_H - 10; y += 7)
+    {
+        for (int32_t x = 10; x < TOUCH_W - 10; x += 7)
+        {
+            gt911_point_t p = {.x = (uint16_t)x, .y = (uint16_t)y};
+            gt911_transform_apply(&calibration, &p, 1);
+            double err = fmax(fabs(p.x - (ca * x + cb * y + cc)), fabs(p.y - (cd * x + ce * y + cf)));
+            max_err = err > max_err ? err : max_err;
+        }
+    }
+    CHECK(max_err <= 3.0);
+
+    // Collinear targets cannot be solved
+    gt911_point_t line[3] = {{.x = 0, .y = 0}, {.x = 10, .y = 10}, {.x = 20, .y = 20}};
+    gt911_transform_t unused;
+    CHECK(!gt911_transform_from_points(&unused, line, expected));
+
+    // The inverse undoes the calibration
+    gt911_transform_t inverse, round_trip;
+    CHECK(gt911_transform_invert(&inverse, &calibration));
+    gt911_transform_compose(&round_trip, &calibration, &inverse);
+    gt911_point_t p = {.x = 321, .y = 123};
+    gt911_transform_apply(&round_trip, &p, 1);
+    CHECK(abs(p.x - 321) <= 1 && abs(p.y - 123) <= 1);
+
+    printf("transform: calibration max error %.3f px off the three targets\n", max_err);
+}
+
+static void test_transform_bench(void)
+{
+    gt911_transform_t identity, t;
+    gt911_transform_identity(&identity);
+    build_transform(&t, &identity, ROTATION_LEFT);
+
+    // Reports of up to five points, like gt911_read() passes them
+    static gt911_point_t points[TRANSFORM_BENCH_POINTS];
+    for (uint32_t i = 0; i < TRANSFORM_BENCH_POINTS; i++)
+    {
+        points[i] = (gt911_point_t){.x = (uint16_t)(i % TOUCH_W), .y = (uint16_t)((i / TOUCH_W) % TOUCH_H)};
+    }
+
+    int64_t start = host_now_us();
+    for (uint32_t i = 0; i < TRANSFORM_BENCH_POINTS; i += GT911_MAX_POINTS)
+    {
+        gt911_transform_apply(&t, &points[i], GT911_MAX_POINTS);
+    }
+    int64_t affine_us = host_now_us() - start;
+
+    volatile int32_t sink = 0;
+    start = host_now_us();
+    for (uint32_t i = 0; i < TRANSFORM_BENCH_POINTS; i++)
+    {
+        int32_t x, y;
+        baseline(ROTATION_LEFT, (int32_t)(i % TOUCH_W), (int32_t)((i / TOUCH_W) % TOUCH_H), &x, &y);
+        sink += x + y;
+    }
+    int64_t baseline_us = host_now_us() - start;
+
+    printf("transform: %.0f Mpoints/s affine, %.0f Mpoints/s switch and divide\n",
+           (double)TRANSFORM_BENCH_POINTS / (affine_us > 0 ? affine_us : 1),
+           (double)TRANSFORM_BENCH_POINTS / (baseline_us > 0 ? baseline_us : 1));
+}
+
+void test_transform(void)
+{
+    test_transform_rotations();
+    test_transform_calibration();
+    test_transform_bench();
+}